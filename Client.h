@@ -5,6 +5,12 @@
 #include <iostream>
 #include <string>
 #include <vector>
+#include <deque>
+#include <map>
+#include <memory>
+#include <future>
+#include <functional>
+#include <cstring>
 
 #ifdef _WIN32
     #include <winsock2.h>
@@ -32,6 +38,16 @@ struct Message {
     char clientType[20];
 };
 
+// A request that has been written (or queued) but not yet answered.
+// The server handles frames from one connection strictly in order and
+// terminates every reply with '\n', so replies are matched to requests
+// by their position in the pending queue.
+struct PendingRequest {
+    int requestId;
+    shared_ptr<promise<string>> result;
+    function<void(const string&)> callback;
+};
+
 class QuickBiteClient {
 private:
     SocketType clientSocket;
@@ -42,10 +58,60 @@ private:
     int userId;
     string userName;
     string userRole;
+    
+    // Pipelining state
+    int nextRequestId;
+    string sendBuffer;                    // frames queued for the next flush
+    string recvBuffer;                    // bytes received but not yet split into replies
+    deque<PendingRequest> pendingRequests;
+    map<int, string> completedResponses;  // replies without a future/callback, for takeResponse()
+    
+    bool sendAll(const char* data, size_t length) {
+        size_t sent = 0;
+        while (sent < length) {
+            int n = send(clientSocket, data + sent, (int)(length - sent), 0);
+            if (n == SOCKET_ERROR || n == 0) return false;
+            sent += n;
+        }
+        return true;
+    }
+    
+    // Reads one '\n'-terminated reply. Returns false if the connection dropped.
+    bool readResponseLine(string& line) {
+        size_t newline;
+        while ((newline = recvBuffer.find('\n')) == string::npos) {
+            char buffer[8192];
+            int bytesReceived = recv(clientSocket, buffer, sizeof(buffer), 0);
+            if (bytesReceived <= 0) return false;
+            recvBuffer.append(buffer, bytesReceived);
+        }
+        
+        line = recvBuffer.substr(0, newline);
+        recvBuffer.erase(0, newline + 1);
+        return true;
+    }
+    
+    void completeRequest(PendingRequest& request, const string& response) {
+        if (!request.callback && !request.result) {
+            completedResponses[request.requestId] = response;
+        }
+        if (request.callback) request.callback(response);
+        if (request.result) request.result->set_value(response);
+    }
+    
+    void failPendingRequests(const string& error) {
+        while (!pendingRequests.empty()) {
+            PendingRequest request = pendingRequests.front();
+            pendingRequests.pop_front();
+            completeRequest(request, error);
+        }
+        sendBuffer.clear();
+    }
 
 public:
     QuickBiteClient(const string& ip = "127.0.0.1", int port = 8080)
-        : serverIP(ip), serverPort(port), connected(false), userId(-1) {
+        : serverIP(ip), serverPort(port), connected(false), userId(-1),
+          nextRequestId(1) {
         
 #ifdef _WIN32
         WSADATA wsaData;
@@ -94,6 +160,9 @@ public:
     }
     
     void disconnect() {
+        failPendingRequests("ERROR:Not connected");
+        recvBuffer.clear();
+        
         if (connected) {
             CLOSE_SOCKET(clientSocket);
             connected = false;
@@ -109,32 +178,196 @@ public:
         userRole = "";
     }
     
-    string sendCommand(const string& command, const string& data = "") {
+    // === PIPELINED REQUESTS ===
+    // queueCommand()/sendCommandAsync() only append a frame to the send
+    // buffer; flush() writes every queued frame in one send() and
+    // awaitResponses() reads replies until the pending queue is empty,
+    // resolving futures and running callbacks in request order.
+    
+    int queueCommand(const string& command, const string& data = "",
+                     function<void(const string&)> callback = nullptr,
+                     shared_ptr<promise<string>> result = nullptr) {
+        PendingRequest request;
+        request.requestId = nextRequestId++;
+        request.result = result;
+        request.callback = callback;
+        
         if (!connected) {
-            return "ERROR:Not connected";
+            completeRequest(request, "ERROR:Not connected");
+            return request.requestId;
         }
         
         Message msg;
+        memset(&msg, 0, sizeof(msg));
         strncpy(msg.command, command.c_str(), sizeof(msg.command) - 1);
         strncpy(msg.data, data.c_str(), sizeof(msg.data) - 1);
         msg.clientId = userId;
         strncpy(msg.clientType, userRole.c_str(), sizeof(msg.clientType) - 1);
         
-        // Send message
-        if (send(clientSocket, (char*)&msg, sizeof(msg), 0) == SOCKET_ERROR) {
-            return "ERROR:Send failed";
+        sendBuffer.append((const char*)&msg, sizeof(msg));
+        pendingRequests.push_back(request);
+        
+        return request.requestId;
+    }
+    
+    future<string> sendCommandAsync(const string& command, const string& data = "",
+                                    function<void(const string&)> callback = nullptr) {
+        shared_ptr<promise<string>> result = make_shared<promise<string>>();
+        future<string> response = result->get_future();
+        queueCommand(command, data, callback, result);
+        return response;
+    }
+    
+    bool flush() {
+        if (sendBuffer.empty()) return connected;
+        
+        if (!connected || !sendAll(sendBuffer.data(), sendBuffer.size())) {
+            failPendingRequests("ERROR:Send failed");
+            return false;
         }
         
-        // Receive response
-        char buffer[8192] = {0};
-        int bytesReceived = recv(clientSocket, buffer, sizeof(buffer) - 1, 0);
+        sendBuffer.clear();
+        return true;
+    }
+    
+    bool awaitResponses() {
+        if (!flush()) return false;
         
-        if (bytesReceived <= 0) {
-            connected = false;
-            return "ERROR:Connection lost";
+        while (!pendingRequests.empty()) {
+            string line;
+            if (!readResponseLine(line)) {
+                connected = false;
+                failPendingRequests("ERROR:Connection lost");
+                return false;
+            }
+            
+            PendingRequest request = pendingRequests.front();
+            pendingRequests.pop_front();
+            completeRequest(request, line);
+        }
+        
+        return true;
+    }
+    
+    // Returns (and forgets) the reply for a request id from queueCommand().
+    string takeResponse(int requestId) {
+        auto it = completedResponses.find(requestId);
+        if (it == completedResponses.end()) {
+            awaitResponses();
+            it = completedResponses.find(requestId);
+            if (it == completedResponses.end()) return "ERROR:Unknown request";
+        }
+        
+        string response = it->second;
+        completedResponses.erase(it);
+        return response;
+    }
+    
+    // Sends independent commands in one flush and returns the replies in order.
+    vector<string> sendPipelined(const vector<pair<string, string>>& commands) {
+        vector<int> requestIds;
+        for (const auto& command : commands) {
+            requestIds.push_back(queueCommand(command.first, command.second));
+        }
+        
+        awaitResponses();
+        
+        vector<string> responses;
+        for (int requestId : requestIds) {
+            responses.push_back(takeResponse(requestId));
+        }
+        return responses;
+    }
+    
+    // Runs independent commands through the server's BATCH envelope: one
+    // frame and one lock acquisition per batch instead of per command.
+    // Commands that don't fit in one frame are split across several BATCH
+    // frames, which are pipelined in a single flush. A command too long
+    // for a frame on its own isn't sent; its result is an error.
+    vector<string> sendBatch(const vector<pair<string, string>>& commands) {
+        const size_t maxBatchData = sizeof(((Message*)0)->data) - 1;
+        
+        vector<string> results(commands.size());
+        vector<int> requestIds;
+        vector<vector<size_t>> batchSlots;     // index in results of each entry
+        string batchData;
+        vector<size_t> slots;
+        
+        for (size_t i = 0; i < commands.size(); i++) {
+            string entry = commands[i].first + ":" + commands[i].second + "\n";
+            if (entry.length() > maxBatchData) {
+                results[i] = "ERROR:Command too long for a batch";
+                continue;
+            }
+            
+            if (!slots.empty() && batchData.length() + entry.length() > maxBatchData) {
+                requestIds.push_back(queueCommand("BATCH", batchData));
+                batchSlots.push_back(slots);
+                batchData.clear();
+                slots.clear();
+            }
+            
+            batchData += entry;
+            slots.push_back(i);
+        }
+        if (!slots.empty()) {
+            requestIds.push_back(queueCommand("BATCH", batchData));
+            batchSlots.push_back(slots);
+        }
+        
+        awaitResponses();
+        
+        for (size_t i = 0; i < requestIds.size(); i++) {
+            vector<string> batchResults;
+            string missing = parseBatchResponse(takeResponse(requestIds[i]), batchResults)
+                ? "ERROR:Missing batch result" : "ERROR:Malformed batch reply";
+            batchResults.resize(batchSlots[i].size(), missing);
+            for (size_t j = 0; j < batchSlots[i].size(); j++) {
+                results[batchSlots[i][j]] = batchResults[j];
+            }
+        }
+        
+        return results;
+    }
+    
+    // Splits "SUCCESS|<count>|<len>:<result>..." into the individual
+    // results. False if the reply doesn't follow that layout; results then
+    // holds the ones read before the fault.
+    static bool parseBatchResponse(const string& response, vector<string>& results) {
+        results.clear();
+        if (response.compare(0, 7, "SUCCESS") != 0) return true;
+        
+        size_t pos = response.find('|', 8);
+        if (pos == string::npos) return false;
+        pos++;
+        
+        while (pos < response.length()) {
+            size_t colon = response.find(':', pos);
+            if (colon == string::npos || colon == pos || colon - pos > 10) return false;
+            
+            size_t length = 0;
+            for (size_t i = pos; i < colon; i++) {
+                if (response[i] < '0' || response[i] > '9') return false;
+                length = length * 10 + (response[i] - '0');
+            }
+            if (length > response.length() - colon - 1) return false;
+            
+            results.push_back(response.substr(colon + 1, length));
+            pos = colon + 1 + length;
         }
         
-        return string(buffer);
+        return true;
+    }
+    
+    string sendCommand(const string& command, const string& data = "") {
+        if (!connected) {
+            return "ERROR:Not connected";
+        }
+        
+        int requestId = queueCommand(command, data);
+        awaitResponses();
+        
+        return takeResponse(requestId);
     }
     
     // User operations
@@ -278,6 +511,13 @@ public:
         return response.substr(0, 7) == "SUCCESS";
     }
     
+    // Lets the server pick the rider in its next batch dispatch
+    bool requestAutoDispatch(int orderId) {
+        string response = sendCommand("ASSIGN_RIDER", to_string(orderId) + "|AUTO");
+        
+        return response.substr(0, 7) == "SUCCESS";
+    }
+    
     // Getters
     int getUserId() const { return userId; }
     string getUserName() const { return userName; }
@@ -5,64 +5,142 @@
 #include <fstream>
 #include <vector>
 #include <cstring>
+#include <ctime>
 #include "models/Restaurant.h"
 #include "models/Order.h"
+#include "models/User.h"
+#include "models/Rider.h"
+#include "storage/PagedRecordFile.h"
+#include "storage/RecordSalvage.h"
 
 using namespace std;
 
 class DatabaseRepair {
-public:
-    // Diagnose file corruption
-    static void diagnoseDatabase() {
-        cout << "\n========================================\n";
-        cout << "      DATABASE DIAGNOSTIC TOOL         \n";
-        cout << "========================================\n\n";
-        
-        // Check Restaurant file
-        cout << "Analyzing restaurants.dat...\n";
-        cout << "  Expected Record Size: " << sizeof(Restaurant) << " bytes\n";
-        
-        ifstream restFile("restaurants.dat", ios::binary);
-        if (restFile) {
-            restFile.seekg(0, ios::end);
-            size_t fileSize = restFile.tellg();
-            cout << "  Actual File Size: " << fileSize << " bytes\n";
-            
-            if (fileSize % sizeof(Restaurant) != 0) {
-                cout << "  ✗ CORRUPTED: Size mismatch!\n";
-                cout << "  Records (if aligned): " << (fileSize / sizeof(Restaurant)) << "\n";
-                cout << "  Extra bytes: " << (fileSize % sizeof(Restaurant)) << "\n";
+private:
+    static const char* salvageReportFile() { return "salvage_report.txt"; }
+    
+    // Paged files are checked page by page; older raw files can only be
+    // checked by size
+    static void diagnoseFile(const string& filename, size_t recordSize) {
+        cout << "Analyzing " << filename << "...\n";
+        cout << "  Expected Record Size: " << recordSize << " bytes\n";
+        
+        if (PagedRecordFile::isContainer(filename)) {
+            PagedFileReport report = PagedRecordFile::scan(filename);
+            if (!report.headerValid) {
+                cout << "  ✗ CORRUPTED: " << report.error << "\n";
+            } else if (report.recordSize != recordSize) {
+                cout << "  ✗ Written with " << report.recordSize << "-byte records\n";
+            } else if (!report.badPages.empty()) {
+                cout << "  ✗ CORRUPTED: " << report.badPages.size() << " of "
+                     << report.pageCount << " pages fail their checksum\n";
+                cout << "  Bad pages:";
+                for (uint32_t page : report.badPages) cout << " " << page;
+                cout << "\n";
+                cout << "  Records: " << report.recordsRecovered << " readable, "
+                     << report.recordsLost() << " lost\n";
             } else {
-                cout << "  ✓ File structure OK\n";
-                cout << "  Records: " << (fileSize / sizeof(Restaurant)) << "\n";
+                cout << "  ✓ File structure OK (" << report.pageCount << " pages, checksums match)\n";
+                cout << "  Records: " << report.recordCount << "\n";
             }
-            restFile.close();
-        } else {
-            cout << "  ✗ File not found\n";
+            return;
         }
         
-        // Check Order file
-        cout << "\nAnalyzing orders.dat...\n";
-        cout << "  Expected Record Size: " << sizeof(Order) << " bytes\n";
-        
-        ifstream orderFile("orders.dat", ios::binary);
-        if (orderFile) {
-            orderFile.seekg(0, ios::end);
-            size_t fileSize = orderFile.tellg();
-            cout << "  Actual File Size: " << fileSize << " bytes\n";
+        ifstream file(filename, ios::binary);
+        if (file) {
+            file.seekg(0, ios::end);
+            size_t fileSize = file.tellg();
+            cout << "  Actual File Size: " << fileSize << " bytes (raw records, no checksums)\n";
             
-            if (fileSize % sizeof(Order) != 0) {
+            if (fileSize % recordSize != 0) {
                 cout << "  ✗ CORRUPTED: Size mismatch!\n";
-                cout << "  Records (if aligned): " << (fileSize / sizeof(Order)) << "\n";
-                cout << "  Extra bytes: " << (fileSize % sizeof(Order)) << "\n";
+                cout << "  Records (if aligned): " << (fileSize / recordSize) << "\n";
+                cout << "  Extra bytes: " << (fileSize % recordSize) << "\n";
             } else {
                 cout << "  ✓ File structure OK\n";
-                cout << "  Records: " << (fileSize / sizeof(Order)) << "\n";
+                cout << "  Records: " << (fileSize / recordSize) << "\n";
             }
-            orderFile.close();
+            file.close();
         } else {
             cout << "  ✗ File not found\n";
         }
+    }
+    
+    // Prints what salvaging a file found, in the repair tool's register
+    static void printSalvage(const SalvageReport& report, const char* what) {
+        if (!report.error.empty()) {
+            cout << "  " << report.filename << ": " << report.error << "\n";
+            return;
+        }
+        cout << "  " << report.filename << " (" << report.layout << ", " << report.fileBytes << " bytes)\n";
+        if (!report.badPages.empty()) {
+            cout << "  " << report.badPages.size() << " damaged pages, "
+                 << report.keptFromDamagedPages << " records on them passed field checks\n";
+        }
+        if (report.rejectedCount() > 0) {
+            cout << "  Rejected " << report.rejectedCount() << " invalid records:";
+            for (const auto& reason : report.rejected) cout << " " << reason.first << " " << reason.second << ";";
+            cout << "\n";
+        }
+        if (report.trailingBytes > 0) {
+            cout << "  Ignored " << report.trailingBytes << " bytes after the last whole record\n";
+        }
+        cout << "Salvaged " << report.recordsKept << " " << what << " in " << report.millis << " ms\n";
+    }
+    
+    // The full findings of a rebuild, for looking into what was lost
+    static void writeSalvageReport(const vector<SalvageReport>& reports) {
+        ofstream out(salvageReportFile());
+        if (!out) {
+            cout << "  ✗ Could not write " << salvageReportFile() << "\n";
+            return;
+        }
+        
+        time_t now = time(nullptr);
+        out << "QuickBite salvage report, " << ctime(&now);
+        for (const auto& report : reports) {
+            out << "\n[" << report.filename << "]\n";
+            if (!report.error.empty()) {
+                out << "error: " << report.error << "\n";
+                continue;
+            }
+            out << "layout: " << report.layout << "\n";
+            out << "file bytes: " << report.fileBytes << "\n";
+            out << "records kept: " << report.recordsKept << "\n";
+            out << "slots checked field by field: " << report.slotsChecked << "\n";
+            out << "empty slots: " << report.emptySlots << "\n";
+            out << "damaged pages: " << report.badPages.size();
+            for (uint32_t page : report.badPages) out << " " << page;
+            out << "\n";
+            out << "kept from damaged pages: " << report.keptFromDamagedPages << "\n";
+            out << "trailing bytes: " << report.trailingBytes << "\n";
+            for (const auto& reason : report.rejected) {
+                out << "rejected, " << reason.first << ": " << reason.second << "\n";
+            }
+            if (!report.rejectedOffsets.empty()) {
+                out << "first rejected offsets:";
+                for (uint64_t offset : report.rejectedOffsets) out << " " << offset;
+                out << "\n";
+            }
+            out << "time: " << report.millis << " ms\n";
+        }
+        cout << "✓ Salvage report written to " << salvageReportFile() << "\n";
+    }
+
+public:
+    // Diagnose file corruption
+    static void diagnoseDatabase() {
+        cout << "\n========================================\n";
+        cout << "      DATABASE DIAGNOSTIC TOOL         \n";
+        cout << "========================================\n\n";
+        
+        diagnoseFile("restaurants.dat", sizeof(Restaurant));
+        cout << "\n";
+        diagnoseFile("orders.dat", sizeof(Order));
+        cout << "\n";
+        diagnoseFile("users.dat", sizeof(UserData));
+        cout << "\n";
+        diagnoseFile("riders.dat", sizeof(Rider));
         
         cout << "\n========================================\n";
     }
@@ -92,133 +170,72 @@ public:
         cout << "========================================\n";
     }
     
-    // Attempt to salvage readable records
-    static vector<Restaurant> salvageRestaurants() {
-        vector<Restaurant> salvaged;
-        
-        ifstream file("restaurants.dat", ios::binary);
-        if (!file) {
-            return salvaged;
-        }
-        
-        file.seekg(0, ios::end);
-        size_t fileSize = file.tellg();
-        file.seekg(0, ios::beg);
-        
-        cout << "Attempting to salvage restaurants...\n";
-        cout << "File size: " << fileSize << " bytes\n";
-        cout << "Record size: " << sizeof(Restaurant) << " bytes\n";
-        
-        // Try reading records one by one
-        int recordsRead = 0;
-        while (file.tellg() < fileSize) {
-            Restaurant temp;
-            streampos beforeRead = file.tellg();
-            
-            file.read(reinterpret_cast<char*>(&temp), sizeof(Restaurant));
-            
-            if (file.fail()) {
-                cout << "Failed at position: " << beforeRead << "\n";
-                break;
-            }
-            
-            // Validate the record
-            if (temp.getRestaurantId() > 0 && temp.getRestaurantId() < 10000) {
-                salvaged.push_back(temp);
-                cout << "  Salvaged: " << temp.getName() << " (ID: " 
-                     << temp.getRestaurantId() << ")\n";
-                recordsRead++;
-            } else {
-                cout << "  Invalid record at position " << beforeRead << "\n";
-            }
-        }
-        
-        file.close();
-        
-        cout << "Salvaged " << salvaged.size() << " restaurants\n";
+    // Attempt to salvage readable records; see RecordSalvage
+    static vector<Restaurant> salvageRestaurants(SalvageReport* findings = nullptr) {
+        cout << "Salvaging restaurants...\n";
+        SalvageReport local;
+        SalvageReport& report = findings ? *findings : local;
+        vector<Restaurant> salvaged = RecordSalvage::salvage<Restaurant>(
+            "restaurants.dat", RecordSchema::RESTAURANTS,
+            [](const Restaurant& r) { return r.fieldError(); }, report);
+        printSalvage(report, "restaurants");
         return salvaged;
     }
     
-    static vector<Order> salvageOrders() {
-        vector<Order> salvaged;
-        
-        ifstream file("orders.dat", ios::binary);
-        if (!file) {
-            return salvaged;
-        }
-        
-        file.seekg(0, ios::end);
-        size_t fileSize = file.tellg();
-        file.seekg(0, ios::beg);
-        
-        cout << "Attempting to salvage orders...\n";
-        cout << "File size: " << fileSize << " bytes\n";
-        cout << "Record size: " << sizeof(Order) << " bytes\n";
-        
-        int recordsRead = 0;
-        while (file.tellg() < fileSize) {
-            Order temp;
-            streampos beforeRead = file.tellg();
-            
-            file.read(reinterpret_cast<char*>(&temp), sizeof(Order));
-            
-            if (file.fail()) {
-                cout << "Failed at position: " << beforeRead << "\n";
-                break;
-            }
-            
-            // Validate the record
-            if (temp.getOrderId() > 0 && temp.getOrderId() < 100000) {
-                salvaged.push_back(temp);
-                cout << "  Salvaged: Order #" << temp.getOrderId() 
-                     << " (Customer: " << temp.getCustomerId() << ")\n";
-                recordsRead++;
-            } else {
-                cout << "  Invalid record at position " << beforeRead << "\n";
-            }
-        }
-        
-        file.close();
-        
-        cout << "Salvaged " << salvaged.size() << " orders\n";
+    static vector<Order> salvageOrders(SalvageReport* findings = nullptr) {
+        cout << "Salvaging orders...\n";
+        SalvageReport local;
+        SalvageReport& report = findings ? *findings : local;
+        vector<Order> salvaged = RecordSalvage::salvage<Order>(
+            "orders.dat", RecordSchema::ORDERS,
+            [](const Order& o) { return o.fieldError(); }, report);
+        printSalvage(report, "orders");
         return salvaged;
     }
     
-    // Rebuild database from salvaged data
-    static void rebuildDatabase() {
+    // Rebuild database from salvaged data. Both files are written in full
+    // beside the originals first; the originals are only replaced once
+    // both are on disk, so a failed write leaves the damaged files as they
+    // were to try again. False if nothing was replaced or only one was.
+    static bool rebuildDatabase() {
         cout << "\n========================================\n";
         cout << "      REBUILDING DATABASE              \n";
         cout << "========================================\n\n";
         
         // Salvage what we can
-        vector<Restaurant> restaurants = salvageRestaurants();
-        vector<Order> orders = salvageOrders();
-        
-        // Clear files
-        clearCorruptedFiles();
+        vector<SalvageReport> reports(2);
+        vector<Restaurant> restaurants = salvageRestaurants(&reports[0]);
+        vector<Order> orders = salvageOrders(&reports[1]);
+        writeSalvageReport(reports);
+        
+        string restaurantsTemp = "restaurants.dat.repair";
+        string ordersTemp = "orders.dat.repair";
+        if (!PagedRecordFile::stage(restaurantsTemp, RecordSchema::RESTAURANTS, restaurants) ||
+            !PagedRecordFile::stage(ordersTemp, RecordSchema::ORDERS, orders)) {
+            AtomicFileWriter::discard(restaurantsTemp);
+            AtomicFileWriter::discard(ordersTemp);
+            cout << "\n✗ Could not write the salvaged records; the original files are unchanged\n";
+            return false;
+        }
         
-        // Rewrite salvaged data
-        if (!restaurants.empty()) {
-            ofstream restFile("restaurants.dat", ios::binary);
-            for (const auto& r : restaurants) {
-                restFile.write(reinterpret_cast<const char*>(&r), sizeof(Restaurant));
-            }
-            restFile.close();
-            cout << "\n✓ Restored " << restaurants.size() << " restaurants\n";
+        // Replace the originals
+        if (!AtomicFileWriter::publish(restaurantsTemp, "restaurants.dat")) {
+            AtomicFileWriter::discard(ordersTemp);
+            cout << "\n✗ Could not replace restaurants.dat; the original files are unchanged\n";
+            return false;
         }
+        cout << "\n✓ Restored " << restaurants.size() << " restaurants\n";
         
-        if (!orders.empty()) {
-            ofstream orderFile("orders.dat", ios::binary);
-            for (const auto& o : orders) {
-                orderFile.write(reinterpret_cast<const char*>(&o), sizeof(Order));
-            }
-            orderFile.close();
-            cout << "✓ Restored " << orders.size() << " orders\n";
+        if (!AtomicFileWriter::publish(ordersTemp, "orders.dat")) {
+            cout << "✗ Could not replace orders.dat; it is unchanged\n";
+            return false;
         }
+        cout << "✓ Restored " << orders.size() << " orders\n";
         
         cout << "\n========================================\n";
         cout << "      DATABASE REBUILD COMPLETE        \n";
         cout << "========================================\n";
+        return true;
     }
 };
 
@@ -0,0 +1,256 @@
+// Logger.h - Asynchronous leveled logger
+//
+// Request threads format a line and push it into a bounded lock-free ring
+// buffer; a background thread drains the ring and writes to the console
+// in batches, flushing once per batch instead of once per line. When the
+// ring is full the line is dropped (and counted) rather than blocking the
+// caller.
+//
+// Usage:
+//   LOG_INFO("Order " << orderId << " placed");
+//   LOG_DEBUG("Received request: " << request);      // compiled out by default
+//   LOG_INFO_SAMPLED(100, "Processing: " << command); // 1 in 100 per call site
+//
+// Build with -DQUICKBITE_LOG_COMPILE_LEVEL=0 to compile DEBUG lines in;
+// setLevel() then filters at runtime.
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <cstdint>
+
+#ifdef _WIN32
+    #include <windows.h>
+#else
+    #include <thread>
+    #include <chrono>
+#endif
+
+using namespace std;
+
+#define LOG_LEVEL_DEBUG 0
+#define LOG_LEVEL_INFO  1
+#define LOG_LEVEL_WARN  2
+#define LOG_LEVEL_ERROR 3
+
+#ifndef QUICKBITE_LOG_COMPILE_LEVEL
+    #define QUICKBITE_LOG_COMPILE_LEVEL LOG_LEVEL_INFO
+#endif
+
+class Logger {
+private:
+    // Bounded multi-producer ring (Vyukov). Each slot's sequence number says
+    // whether it is free for the producer at that position or holds a line
+    // for the consumer.
+    struct Slot {
+        atomic<uint64_t> sequence;
+        int level;
+        string text;
+    };
+
+    static const size_t CAPACITY = 8192;   // power of two
+
+    vector<Slot> ring;
+    atomic<uint64_t> enqueuePos;
+    uint64_t dequeuePos;                   // touched by the writer thread only
+    atomic<uint64_t> writtenPos;           // lines before this are on the console
+
+    atomic<int> minLevel;
+    atomic<bool> running;
+    atomic<uint64_t> droppedLines;
+
+#ifdef _WIN32
+    HANDLE writerThread;
+
+    static DWORD WINAPI writerThreadStatic(LPVOID lpParam) {
+        ((Logger*)lpParam)->writerLoop();
+        return 0;
+    }
+#else
+    thread writerThread;
+#endif
+
+    Logger() : ring(CAPACITY), enqueuePos(0), dequeuePos(0), writtenPos(0),
+               minLevel(QUICKBITE_LOG_COMPILE_LEVEL), running(true), droppedLines(0) {
+        for (size_t i = 0; i < CAPACITY; i++) {
+            ring[i].sequence.store(i, memory_order_relaxed);
+        }
+
+#ifdef _WIN32
+        writerThread = CreateThread(NULL, 0, writerThreadStatic, this, 0, NULL);
+#else
+        writerThread = thread(&Logger::writerLoop, this);
+#endif
+    }
+
+    ~Logger() {
+        shutdown();
+    }
+
+    static const char* levelTag(int level) {
+        switch (level) {
+            case LOG_LEVEL_DEBUG: return "[DEBUG] ";
+            case LOG_LEVEL_WARN:  return "[WARN] ";
+            case LOG_LEVEL_ERROR: return "[ERROR] ";
+            default:              return "";
+        }
+    }
+
+    bool tryPop(string& line) {
+        Slot& slot = ring[dequeuePos & (CAPACITY - 1)];
+        uint64_t sequence = slot.sequence.load(memory_order_acquire);
+        if (sequence != dequeuePos + 1) return false;
+
+        line = levelTag(slot.level);
+        line += slot.text;
+        slot.text.clear();
+        slot.sequence.store(dequeuePos + CAPACITY, memory_order_release);
+        dequeuePos++;
+        return true;
+    }
+
+    // Writes everything queued so far; returns false if there was nothing
+    bool drain() {
+        string batch, line;
+        while (tryPop(line)) {
+            batch += line;
+            batch += '\n';
+        }
+
+        uint64_t dropped = droppedLines.exchange(0, memory_order_relaxed);
+        if (dropped > 0) {
+            batch += "[WARN] Logger dropped " + to_string(dropped) + " lines (buffer full)\n";
+        }
+
+        if (batch.empty()) return false;
+
+        cout << batch;
+        cout.flush();
+        writtenPos.store(dequeuePos, memory_order_release);
+        return true;
+    }
+
+    void writerLoop() {
+        while (running.load(memory_order_acquire)) {
+            if (!drain()) {
+#ifdef _WIN32
+                Sleep(2);
+#else
+                this_thread::sleep_for(chrono::milliseconds(2));
+#endif
+            }
+        }
+        drain();
+    }
+
+public:
+    static Logger& instance() {
+        static Logger logger;
+        return logger;
+    }
+
+    void setLevel(int level) { minLevel.store(level, memory_order_relaxed); }
+    int getLevel() const { return minLevel.load(memory_order_relaxed); }
+
+    bool enabled(int level) const {
+        return level >= minLevel.load(memory_order_relaxed);
+    }
+
+    void write(int level, const string& text) {
+        uint64_t pos = enqueuePos.load(memory_order_relaxed);
+
+        while (true) {
+            Slot& slot = ring[pos & (CAPACITY - 1)];
+            uint64_t sequence = slot.sequence.load(memory_order_acquire);
+            int64_t diff = (int64_t)sequence - (int64_t)pos;
+
+            if (diff == 0) {
+                if (enqueuePos.compare_exchange_weak(pos, pos + 1, memory_order_relaxed)) {
+                    slot.level = level;
+                    slot.text = text;
+                    slot.sequence.store(pos + 1, memory_order_release);
+                    return;
+                }
+            } else if (diff < 0) {
+                droppedLines.fetch_add(1, memory_order_relaxed);
+                return;
+            } else {
+                pos = enqueuePos.load(memory_order_relaxed);
+            }
+        }
+    }
+
+    // Blocks until every line logged so far has been written. Used before
+    // printing console banners/menus so they don't interleave with logs.
+    void flush() {
+        uint64_t target = enqueuePos.load(memory_order_acquire);
+        while (running.load(memory_order_acquire) &&
+               writtenPos.load(memory_order_acquire) < target) {
+#ifdef _WIN32
+            Sleep(1);
+#else
+            this_thread::sleep_for(chrono::milliseconds(1));
+#endif
+        }
+    }
+
+    // Stops the writer after flushing what is queued. Lines logged
+    // afterwards are dropped.
+    void shutdown() {
+        if (!running.exchange(false)) return;
+
+#ifdef _WIN32
+        if (writerThread) {
+            WaitForSingleObject(writerThread, INFINITE);
+            CloseHandle(writerThread);
+            writerThread = NULL;
+        }
+#else
+        if (writerThread.joinable()) writerThread.join();
+#endif
+    }
+};
+
+#define QUICKBITE_LOG(level, expr)                                   \
+    do {                                                             \
+        if (Logger::instance().enabled(level)) {                     \
+            ostringstream logStream_;                                \
+            logStream_ << expr;                                      \
+            Logger::instance().write(level, logStream_.str());       \
+        }                                                            \
+    } while (0)
+
+// Logs one in every n calls from this call site
+#define QUICKBITE_LOG_SAMPLED(level, n, expr)                        \
+    do {                                                             \
+        static atomic<uint64_t> logSampleCounter_(0);                \
+        if (logSampleCounter_.fetch_add(1, memory_order_relaxed) % (n) == 0) { \
+            QUICKBITE_LOG(level, expr);                              \
+        }                                                            \
+    } while (0)
+
+#if QUICKBITE_LOG_COMPILE_LEVEL <= LOG_LEVEL_DEBUG
+    #define LOG_DEBUG(expr) QUICKBITE_LOG(LOG_LEVEL_DEBUG, expr)
+    #define LOG_DEBUG_SAMPLED(n, expr) QUICKBITE_LOG_SAMPLED(LOG_LEVEL_DEBUG, n, expr)
+#else
+    // Still names the expression, so variables only logged here stay used
+    #define LOG_DEBUG(expr)                                          \
+        do {                                                         \
+            if (false) {                                             \
+                ostringstream logStream_;                            \
+                logStream_ << expr;                                  \
+            }                                                        \
+        } while (0)
+    #define LOG_DEBUG_SAMPLED(n, expr) LOG_DEBUG(expr)
+#endif
+
+#define LOG_INFO(expr) QUICKBITE_LOG(LOG_LEVEL_INFO, expr)
+#define LOG_INFO_SAMPLED(n, expr) QUICKBITE_LOG_SAMPLED(LOG_LEVEL_INFO, n, expr)
+#define LOG_WARN(expr) QUICKBITE_LOG(LOG_LEVEL_WARN, expr)
+#define LOG_ERROR(expr) QUICKBITE_LOG(LOG_LEVEL_ERROR, expr)
+
+#endif // LOGGER_H
@@ -0,0 +1,160 @@
+// ResponseCache.h - Finished replies to read-only queries, kept until the data behind them changes
+//
+// Catalog and map queries return the same bytes to every client until an
+// admin changes a restaurant, a menu or the map. Their replies are cached
+// whole, keyed by wire format, command and arguments, and handed out as
+// shared immutable strings, so a hit is one short lock for the lookup
+// and never touches dataMutex.
+//
+// Every entry belongs to a domain (the data it was built from). A handler
+// that changes that data calls invalidate(domain) afterwards, which drops
+// the domain's entries and bumps its version. A reply is built against
+// the version read before building it, and store() refuses it if the
+// version has moved since, so a reply built from the old data can't be
+// cached after the change.
+//
+// Keys are the raw argument text, so one menu can take several entries
+// ("7", "07"); the cache holds at most MAX_ENTRIES and evicts the least
+// recently used one to make room.
+#ifndef RESPONSE_CACHE_H
+#define RESPONSE_CACHE_H
+
+#include <string>
+#include <memory>
+#include <unordered_map>
+#include <list>
+#include <atomic>
+#include <cstdint>
+
+#ifdef _WIN32
+    #include <windows.h>
+#else
+    #include <mutex>
+#endif
+
+using namespace std;
+
+class ResponseCache {
+public:
+    enum Format { TEXT, JSON };
+    enum Domain { CATALOG, CITY_MAP, DOMAIN_COUNT };
+
+    // Enough for every restaurant's menu in both formats; past it, the
+    // least recently used entry makes room
+    enum { MAX_ENTRIES = 8192 };
+
+private:
+    struct Entry {
+        shared_ptr<const string> reply;
+        int domain;
+        list<string>::iterator use;     // position in recentUse
+    };
+
+    unordered_map<string, Entry> entries;
+    list<string> recentUse;             // keys, most recently used first
+    atomic<uint64_t> versions[DOMAIN_COUNT];
+
+#ifdef _WIN32
+    CRITICAL_SECTION lock;
+    void acquire() { EnterCriticalSection(&lock); }
+    void release() { LeaveCriticalSection(&lock); }
+#else
+    mutex lock;
+    void acquire() { lock.lock(); }
+    void release() { lock.unlock(); }
+#endif
+
+    static string keyOf(Format format, const string& command, const string& args) {
+        string key;
+        key.reserve(command.size() + args.size() + 3);
+        key += (format == JSON ? 'J' : 'T');
+        key += '\0';
+        key += command;
+        key += '\0';
+        key += args;
+        return key;
+    }
+
+    ResponseCache(const ResponseCache&);
+    ResponseCache& operator=(const ResponseCache&);
+
+public:
+    ResponseCache() {
+        for (int i = 0; i < DOMAIN_COUNT; i++) versions[i].store(0);
+#ifdef _WIN32
+        InitializeCriticalSection(&lock);
+#endif
+    }
+
+    ~ResponseCache() {
+#ifdef _WIN32
+        DeleteCriticalSection(&lock);
+#endif
+    }
+
+    // The domain a text command's reply depends on; -1 if it isn't cached
+    static int domainOf(const string& command) {
+        if (command == "GET_RESTAURANTS" || command == "GET_MENU") return CATALOG;
+        if (command == "GET_CITY_MAP") return CITY_MAP;
+        return -1;
+    }
+
+    // Read before building a reply, passed to store() with it
+    uint64_t version(int domain) const { return versions[domain].load(memory_order_acquire); }
+
+    // Null on a miss
+    shared_ptr<const string> find(Format format, const string& command, const string& args) {
+        string key = keyOf(format, command, args);
+        acquire();
+        auto it = entries.find(key);
+        shared_ptr<const string> reply;
+        if (it != entries.end()) {
+            reply = it->second.reply;
+            recentUse.splice(recentUse.begin(), recentUse, it->second.use);
+        }
+        release();
+        return reply;
+    }
+
+    // Caches reply unless domain changed after builtAt was read
+    void store(Format format, const string& command, const string& args,
+               int domain, uint64_t builtAt, const string& reply) {
+        shared_ptr<const string> shared = make_shared<const string>(reply);
+        string key = keyOf(format, command, args);
+        acquire();
+        if (version(domain) == builtAt) {
+            auto it = entries.find(key);
+            if (it != entries.end()) {
+                recentUse.splice(recentUse.begin(), recentUse, it->second.use);
+            } else {
+                if (entries.size() >= MAX_ENTRIES) {
+                    entries.erase(recentUse.back());
+                    recentUse.pop_back();
+                }
+                recentUse.push_front(key);
+                it = entries.insert(make_pair(key, Entry())).first;
+                it->second.use = recentUse.begin();
+            }
+            it->second.reply = shared;
+            it->second.domain = domain;
+        }
+        release();
+    }
+
+    // Call after changing the data of domain
+    void invalidate(int domain) {
+        acquire();
+        versions[domain].fetch_add(1, memory_order_acq_rel);
+        for (auto it = entries.begin(); it != entries.end();) {
+            if (it->second.domain == domain) {
+                recentUse.erase(it->second.use);
+                it = entries.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        release();
+    }
+};
+
+#endif // RESPONSE_CACHE_H
@@ -0,0 +1,147 @@
+#ifndef RESTAURANT_MIGRATION_H
+#define RESTAURANT_MIGRATION_H
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <iterator>
+#include <cstring>
+#include "models/Restaurant.h"
+#include "models/MenuItem.h"
+#include "Logger.h"
+#include "storage/PagedRecordFile.h"
+
+using namespace std;
+
+// restaurants.dat record as written before menus moved out of Restaurant:
+// the same fields, plus up to 50 full MenuItems embedded in every record
+// (about 19 KB each). Member order must not change; it is the file layout.
+struct LegacyRestaurantRecord {
+    int restaurantId;
+    char name[100];
+    char address[200];
+    char phone[20];
+    char cuisine[50];
+    int locationNode;
+    double rating;
+    int deliveryTime;
+    MenuItem menuItems[50];
+    int menuItemCount;
+    int menuItemIdsArray[50];
+    int menuItemIdsCount;
+};
+
+// Upgrades a restaurants.dat in the legacy layout to the current one.
+// The restaurant fields are copied over, the embedded menu items are
+// handed back for menu_items.dat, and the old file is kept next to the
+// new one with a ".legacy" suffix.
+class RestaurantMigration {
+private:
+    static bool fileSize(const string& filename, size_t& size) {
+        ifstream file(filename, ios::binary | ios::ate);
+        if (!file) return false;
+        size = file.tellg();
+        return true;
+    }
+
+    static bool terminated(const char* text, size_t capacity) {
+        return memchr(text, '\0', capacity) != nullptr;
+    }
+
+    static bool plausible(const LegacyRestaurantRecord& record) {
+        return record.restaurantId > 0 &&
+               record.menuItemCount >= 0 && record.menuItemCount <= 50 &&
+               record.menuItemIdsCount >= 0 && record.menuItemIdsCount <= 50 &&
+               terminated(record.name, sizeof(record.name)) &&
+               terminated(record.address, sizeof(record.address)) &&
+               terminated(record.phone, sizeof(record.phone)) &&
+               terminated(record.cuisine, sizeof(record.cuisine));
+    }
+
+    static Restaurant convert(const LegacyRestaurantRecord& record) {
+        Restaurant restaurant(record.restaurantId, record.name, record.address, record.phone,
+                              record.cuisine, record.locationNode, record.rating, record.deliveryTime);
+        for (int i = 0; i < record.menuItemIdsCount; i++) {
+            restaurant.addMenuItemId(record.menuItemIdsArray[i]);
+        }
+        for (int i = 0; i < record.menuItemCount; i++) {
+            restaurant.addMenuItemId(record.menuItems[i].id);
+        }
+        return restaurant;
+    }
+
+public:
+    // True if filename can only be read as legacy records. Paged files,
+    // and raw files that also divide into current records, are left alone.
+    static bool isLegacyFile(const string& filename) {
+        size_t size = 0;
+        if (!fileSize(filename, size) || size == 0) return false;
+        if (PagedRecordFile::isContainer(filename)) return false;
+        return size % sizeof(LegacyRestaurantRecord) == 0 && size % sizeof(Restaurant) != 0;
+    }
+
+    // Reads every legacy record of filename. False, with nothing read, if
+    // the file isn't legacy or a record doesn't look like a restaurant.
+    static bool readLegacy(const string& filename, vector<Restaurant>& restaurants,
+                           vector<MenuItem>& menuItems) {
+        restaurants.clear();
+        menuItems.clear();
+        if (!isLegacyFile(filename)) return false;
+
+        ifstream file(filename, ios::binary);
+        if (!file) return false;
+
+        // One record is too big for the stack on some platforms
+        vector<LegacyRestaurantRecord> record(1);
+        while (file.read(reinterpret_cast<char*>(&record[0]), sizeof(LegacyRestaurantRecord))) {
+            if (!plausible(record[0])) {
+                LOG_WARN("Legacy restaurant record " << restaurants.size()
+                         << " in " << filename << " is not readable");
+                restaurants.clear();
+                menuItems.clear();
+                return false;
+            }
+
+            restaurants.push_back(convert(record[0]));
+            for (int i = 0; i < record[0].menuItemCount; i++) {
+                MenuItem item = record[0].menuItems[i];
+                item.restaurantId = record[0].restaurantId;
+                menuItems.push_back(item);
+            }
+        }
+        return true;
+    }
+
+    // Rewrites filename in the current layout. menuItems gets the items
+    // that were embedded in the records; storing them is up to the caller.
+    static bool upgradeFile(const string& filename, vector<MenuItem>& menuItems) {
+        vector<Restaurant> restaurants;
+        if (!readLegacy(filename, restaurants, menuItems)) return false;
+
+        // Keep a copy of the original before replacing it; filename itself
+        // is swapped in one step, so it is always either the old or the
+        // new file
+        string original;
+        {
+            ifstream in(filename, ios::binary);
+            original.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+        }
+        string backup = filename + ".legacy";
+        if (!AtomicFileWriter::write(backup, original.data(), original.size())) {
+            LOG_ERROR("Could not write " << backup);
+            return false;
+        }
+        if (!PagedRecordFile::write(filename, RecordSchema::RESTAURANTS, restaurants)) {
+            LOG_ERROR("Could not write " << filename);
+            return false;
+        }
+
+        LOG_INFO("✓ Migrated " << restaurants.size() << " restaurants in " << filename
+                 << " (" << sizeof(LegacyRestaurantRecord) << " -> " << sizeof(Restaurant)
+                 << " bytes per record), " << menuItems.size() << " embedded menu items");
+        return true;
+    }
+};
+
+#endif // RESTAURANT_MIGRATION_H
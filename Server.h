@@ -12,6 +12,9 @@
 #include <ctime>
 #include <climits>
 #include <cstdlib>
+#include <cstdio>
+#include <fstream>
+#include <memory>
 #ifdef _WIN32
     #define _WINSOCK_DEPRECATED_NO_WARNINGS
     #include <winsock2.h>
@@ -39,6 +42,17 @@
 #include "models/Order.h"
 #include "models/Rider.h"
 #include "services/CityGraph.h"
+#include "services/DispatchEngine.h"
+#include "services/TripPlanner.h"
+#include "services/KShortestPaths.h"
+#include "services/DeliveryRouteStore.h"
+#include "services/RestaurantDirectory.h"
+#include "services/MenuGroups.h"
+#include "storage/StartupPipeline.h"
+#include "storage/CatalogSnapshot.h"
+#include "ServerMetrics.h"
+#include "ResponseCache.h"
+#include "Logger.h"
 
 using namespace std;
 
@@ -96,25 +110,99 @@ private:
     UserManager userManager;
     CityGraph cityGraph;
     vector<Restaurant> restaurants;
+    RestaurantDirectory restaurantIndex;    // hot summaries of restaurants, same order
     vector<Order> orders;
     
+    // Read-only copy of restaurants and menus that GET_RESTAURANTS and
+    // GET_MENU are answered from without dataMutex. Never modified, only
+    // replaced as a whole (publishCatalog) when the admin changes the
+    // catalog; always accessed through atomic_load/atomic_store.
+    shared_ptr<const CatalogSnapshot> catalog;
+    uint64_t catalogGeneration;
+    vector<string> staleCatalogFiles;       // replaced snapshots not yet deleted
+    
+    // Replies to catalog and map queries; handlers that change what they
+    // are built from invalidate their domain
+    ResponseCache responseCache;
+    
     // Rider management
     map<int, string> riderStatus;
     map<int, RiderStats> riderStatistics;
     
+    // Batches ASSIGN_RIDER <order>|AUTO requests; see runDispatchCycle()
+    DispatchEngine dispatcher;
+    
+    // Dispatched orders are grouped into multi-stop trips first; a rider's
+    // remaining stops are kept here until each order is delivered
+    RouteOptimizer roadDistances;
+    TripPlanner tripPlanner;
+    map<int, vector<TripStop>> riderTrips;
+    
+    // Ranked routes for GET_DELIVERY_ROUTE, cached per (from, to)
+    KShortestPaths deliveryRoutes;
+    // Route of each assigned order, planned once and followed as the rider
+    // reports positions through GET_DELIVERY_ROUTE
+    DeliveryRouteStore plannedRoutes;
+    enum { MAX_ROUTE_ALTERNATIVES = 5 };
+    enum { MAX_JSON_REQUEST = 1 << 20 };    // bytes buffered before a JSON client is dropped
+#ifdef _WIN32
+    HANDLE dispatchThread;
+    HANDLE checkpointThread;
+#else
+    thread dispatchThread;
+    thread checkpointThread;
+#endif
+    
+    // Change tracking for checkpoints. Every data file has a counter that
+    // is bumped (markChanged), under dataMutex, before anything it holds
+    // is changed, and the count it was last written at; a checkpoint
+    // writes only the files whose counters moved since. Handlers only
+    // change memory; checkpoints are the server's one writer of these
+    // files. The reply to a request that changed anything is held until a
+    // checkpoint has saved it (waitUntilSaved), so an acknowledged change
+    // survives a crash.
+    enum DataFile { USERS_DATA, RESTAURANTS_DATA, ORDERS_DATA, RIDERS_DATA, DATA_FILE_COUNT };
+    enum { ALL_DATA_FILES = (1 << DATA_FILE_COUNT) - 1 };
+    enum { CHECKPOINT_INTERVAL_MS = 30000 };
+    enum { MAX_CHECKPOINT_SKIPS = 3 };          // then the file is replaced regardless
+    enum { BACKUP_ATTEMPTS = 3 };               // checkpoints a backup waits for quiet
+    atomic<uint64_t> changeCounts[DATA_FILE_COUNT];
+    uint64_t savedCounts[DATA_FILE_COUNT];      // under checkpointMutex
+    int checkpointSkips[DATA_FILE_COUNT];       // under checkpointMutex
+    
+    // What a checkpoint copies out of dataMutex, under checkpointMutex;
+    // kept between checkpoints so a copy reuses the memory of the last one
+    vector<UserData> userCopy;
+    vector<Restaurant> restaurantCopy;
+    vector<Order> orderCopy;
+    vector<Rider> riderCopy;
+    
+    // The change counts a client's replies wait for a checkpoint to reach
+    // before they're sent; pending is false while nothing is unsaved
+    struct SaveTarget {
+        uint64_t counts[DATA_FILE_COUNT];
+        bool pending;
+        
+        SaveTarget() : pending(false) {}
+    };
+    
     map<int, SocketType> connectedClients;
     map<int, string> clientTypes;
     
 #ifdef _WIN32
     WinMutex clientsMutex;
     WinMutex dataMutex;
+    WinMutex checkpointMutex;
 #else
     mutex clientsMutex;
     mutex dataMutex;
+    mutex checkpointMutex;
 #endif
     
     int nextClientId;
     
+    ServerMetrics metrics;
+    
 #ifdef _WIN32
     struct ClientParams {
         QuickBiteServer* server;
@@ -333,21 +421,29 @@ private:
     try {
         int restaurantId = stoi(restaurantIdStr);
         
-        cout << "DEBUG: Getting menu for restaurant ID: " << restaurantId << endl;
-        
-        // Use DatabaseManager's function to load items
-        vector<MenuItem> menuItems = dbManager.getMenuItemsByRestaurant(restaurantId);
-        
-        cout << "DEBUG: Found " << menuItems.size() << " menu items" << endl;
-        
-        // Also load all items to debug
-        vector<MenuItem> allItems = dbManager.getDatabase().loadAllMenuItems();
-        cout << "DEBUG: Total menu items in database: " << allItems.size() << endl;
-        for (const auto& item : allItems) {
-            cout << "  Item: ID=" << item.id << ", Restaurant=" << item.restaurantId 
-                 << ", Name=" << item.getName() << endl;
+        LOG_DEBUG("Getting menu for restaurant ID: " << restaurantId);
+        
+        string cacheKey = to_string(restaurantId);
+        shared_ptr<const string> cached = responseCache.find(ResponseCache::JSON, "GET_RESTAURANT_MENU", cacheKey);
+        if (cached) return *cached;
+        uint64_t cacheVersion = responseCache.version(ResponseCache::CATALOG);
+        
+        // From the catalog snapshot if there is one, else from menu_items.dat
+        vector<MenuItem> menuItems;
+        shared_ptr<const CatalogSnapshot> snapshot = atomic_load(&catalog);
+        const CatalogRestaurant* r = snapshot ? snapshot->findRestaurant(restaurantId) : nullptr;
+        if (r) {
+            for (const CatalogMenuItem* item = snapshot->menuBegin(*r); item != snapshot->menuEnd(*r); ++item) {
+                menuItems.push_back(MenuItem(item->id, snapshot->text(item->name), snapshot->text(item->description),
+                                             item->price, item->stock, snapshot->text(item->category),
+                                             item->restaurantId));
+            }
+        } else if (!snapshot) {
+            menuItems = dbManager.getMenuItemsByRestaurant(restaurantId);
         }
         
+        LOG_DEBUG("Found " << menuItems.size() << " menu items");
+        
         string jsonResponse = "{";
         jsonResponse += "\"success\":true,";
         jsonResponse += "\"menuItems\":[";
@@ -385,13 +481,15 @@ private:
         jsonResponse += "]";
         jsonResponse += "}";
         
-        cout << "✓ Returning " << menuItems.size() << " menu items for restaurant " << restaurantId << endl;
-        cout << "JSON Response: " << jsonResponse << endl;
+        LOG_DEBUG("✓ Returning " << menuItems.size() << " menu items for restaurant " << restaurantId);
+        LOG_DEBUG("JSON Response: " << jsonResponse);
         
+        responseCache.store(ResponseCache::JSON, "GET_RESTAURANT_MENU", cacheKey,
+                            ResponseCache::CATALOG, cacheVersion, jsonResponse);
         return jsonResponse;
     } catch (const exception& e) {
         string error = "{\"success\":false,\"message\":\"Error: " + string(e.what()) + "\"}";
-        cout << "✗ Error: " << error << endl;
+        LOG_WARN("✗ Error: " << error);
         return error;
     }
 }
@@ -426,13 +524,7 @@ string escapeJsonString(const string& input) {
                     if (!first) jsonResponse += ",";
                     first = false;
                     
-                    string restaurantName = "Unknown";
-                    for (const auto& r : restaurants) {
-                        if (r.getRestaurantId() == order.getRestaurant()) {
-                            restaurantName = r.getName();
-                            break;
-                        }
-                    }
+                    string restaurantName = restaurantNameFor(order.getRestaurant());
                     
                     jsonResponse += "{";
                     jsonResponse += "\"id\":" + to_string(order.getOrderId()) + ",";
@@ -467,13 +559,7 @@ string escapeJsonString(const string& input) {
                 if (!first) jsonResponse += ",";
                 first = false;
                 
-                string restaurantName = "Unknown";
-                for (const auto& r : restaurants) {
-                    if (r.getRestaurantId() == order.getRestaurant()) {
-                        restaurantName = r.getName();
-                        break;
-                    }
-                }
+                string restaurantName = restaurantNameFor(order.getRestaurant());
                 
                 double distance = 2.5 + (order.getOrderId() % 10) * 0.5;
                 
@@ -507,13 +593,7 @@ string escapeJsonString(const string& input) {
                     if (!first) jsonResponse += ",";
                     first = false;
                     
-                    string restaurantName = "Unknown";
-                    for (const auto& r : restaurants) {
-                        if (r.getRestaurantId() == order.getRestaurant()) {
-                            restaurantName = r.getName();
-                            break;
-                        }
-                    }
+                    string restaurantName = restaurantNameFor(order.getRestaurant());
                     
                     string customerName = "Unknown";
                     UserData* customer = userManager.getUser(order.getCustomerId());
@@ -532,6 +612,21 @@ string escapeJsonString(const string& input) {
                 }
             }
             
+            jsonResponse += "],";
+            jsonResponse += "\"stops\":[";
+            
+            first = true;
+            for (const auto& stop : stopsForRider(riderId)) {
+                if (!first) jsonResponse += ",";
+                first = false;
+                
+                jsonResponse += "{";
+                jsonResponse += "\"orderId\":" + to_string(stop.orderId) + ",";
+                jsonResponse += "\"type\":\"" + string(stop.pickup ? "pickup" : "dropoff") + "\",";
+                jsonResponse += "\"node\":" + to_string(stop.node);
+                jsonResponse += "}";
+            }
+            
             jsonResponse += "]";
             jsonResponse += "}";
             
@@ -576,17 +671,41 @@ string escapeJsonString(const string& input) {
         }
     }
     
+    // Remaining nodes of the order's stored route with the distance driven
+    // to reach each one; planned from the rider's location if needed
     string handleGetDeliveryRouteJson(const string& orderIdStr) {
         try {
             int orderId = stoi(orderIdStr);
             
-            // Simplified route for now
+            const StoredRoute* route = plannedRoutes.find(orderId);
+            if (!route) {
+                Order* order = findOrder(orderId);
+                if (!order) return "{\"success\":false,\"message\":\"Order not found\"}";
+                
+                Rider* rider = order->getRiderID() != -1
+                    ? dbManager.getRidersHashTable().getItem(order->getRiderID()) : nullptr;
+                if (rider) route = planDeliveryRoute(orderId, rider->getId(), rider->location);
+            }
+            if (!route) {
+                return "{\"success\":false,\"message\":\"No route planned for this order\"}";
+            }
+            
+            int pickup = route->pickupIndex();
             string jsonResponse = "{";
             jsonResponse += "\"success\":true,";
+            jsonResponse += "\"remaining\":" + to_string(route->remainingDistance()) + ",";
+            jsonResponse += "\"reroutes\":" + to_string(route->reroutes) + ",";
             jsonResponse += "\"route\":[";
-            jsonResponse += "{\"step\":1,\"location\":\"Restaurant\",\"distance\":0},";
-            jsonResponse += "{\"step\":2,\"location\":\"Main Street\",\"distance\":500},";
-            jsonResponse += "{\"step\":3,\"location\":\"Customer Address\",\"distance\":300}";
+            for (size_t i = route->progress; i < route->nodes.size(); i++) {
+                if (i > (size_t)route->progress) jsonResponse += ",";
+                int node = route->nodes[i];
+                string leg = (route->pickupStop >= 0 && (int)i <= pickup) ? "TO_RESTAURANT" : "TO_CUSTOMER";
+                jsonResponse += "{\"step\":" + to_string(i - route->progress + 1) + ",";
+                jsonResponse += "\"node\":" + to_string(node) + ",";
+                jsonResponse += "\"location\":\"" + cityGraph.getLocationName(node) + "\",";
+                jsonResponse += "\"leg\":\"" + leg + "\",";
+                jsonResponse += "\"distance\":" + to_string(route->cumulative[i] - route->cumulative[route->progress]) + "}";
+            }
             jsonResponse += "]";
             jsonResponse += "}";
             
@@ -596,7 +715,11 @@ string escapeJsonString(const string& input) {
         }
     }
     string handleGetRestaurantsJson() {
-        cout << "Handling GET_RESTAURANTS JSON request" << endl;
+        LOG_DEBUG("Handling GET_RESTAURANTS JSON request");
+        
+        shared_ptr<const string> cached = responseCache.find(ResponseCache::JSON, "GET_RESTAURANTS", "");
+        if (cached) return *cached;
+        uint64_t cacheVersion = responseCache.version(ResponseCache::CATALOG);
         
         string jsonResponse = "{";
         jsonResponse += "\"success\":true,";
@@ -621,7 +744,9 @@ string escapeJsonString(const string& input) {
         jsonResponse += "]";
         jsonResponse += "}";
         
-        cout << "Returning " << restaurants.size() << " restaurants" << endl;
+        LOG_DEBUG("Returning " << restaurants.size() << " restaurants");
+        responseCache.store(ResponseCache::JSON, "GET_RESTAURANTS", "", 
+                            ResponseCache::CATALOG, cacheVersion, jsonResponse);
         return jsonResponse;
     }
     
@@ -643,13 +768,7 @@ string escapeJsonString(const string& input) {
             }
             
             // Find restaurant name
-            string restaurantName = "Unknown";
-            for (const auto& r : restaurants) {
-                if (r.getRestaurantId() == order.getRestaurant()) {
-                    restaurantName = r.getName();
-                    break;
-                }
-            }
+            string restaurantName = restaurantNameFor(order.getRestaurant());
             
             // Find rider name
             string riderName = "Unassigned";
@@ -782,7 +901,7 @@ string escapeJsonString(const string& input) {
         return jsonResponse;
     }
     string handleJsonRequest(const string& jsonString, int clientId) {
-    cout << "Processing JSON request..." << endl;
+    LOG_DEBUG("Processing JSON request...");
     
     // Parse all possible fields
     string command = extractJsonValue(jsonString, "command");
@@ -804,9 +923,9 @@ string escapeJsonString(const string& input) {
     string vehicle = extractJsonValue(jsonString, "vehicle");
     string license = extractJsonValue(jsonString, "license");
     
-    cout << "Parsed - Command: '" << command 
+    LOG_DEBUG("Parsed - Command: '" << command 
          << "', RestaurantId: '" << restaurantId 
-         << "', UserId: '" << userId << "'" << endl;
+         << "', UserId: '" << userId << "'");
     
     if (command.empty()) {
         return "{\"success\":false,\"message\":\"Could not parse JSON command\"}";
@@ -934,7 +1053,7 @@ else if (command == "UPDATE_AVAILABILITY" && !riderId.empty()) {
 
     
     string parseJsonAlternative(const string& jsonString, int clientId) {
-        cout << "Trying alternative JSON parsing..." << endl;
+        LOG_DEBUG("Trying alternative JSON parsing...");
         
         // Remove all spaces and newlines
         string clean = jsonString;
@@ -943,7 +1062,7 @@ else if (command == "UPDATE_AVAILABILITY" && !riderId.empty()) {
         clean.erase(remove(clean.begin(), clean.end(), '\r'), clean.end());
         clean.erase(remove(clean.begin(), clean.end(), '\t'), clean.end());
         
-        cout << "Cleaned: " << clean << endl;
+        LOG_DEBUG("Cleaned: " << clean);
         
         // Find command
         size_t cmdPos = clean.find("command\":\"");
@@ -975,8 +1094,8 @@ else if (command == "UPDATE_AVAILABILITY" && !riderId.empty()) {
                         role = clean.substr(rolePos, roleEnd - rolePos);
                     }
                     
-                    cout << "Alternative parse - Command: " << command 
-                         << ", Email: " << email << ", Role: " << role << endl;
+                    LOG_DEBUG("Alternative parse - Command: " << command 
+                         << ", Email: " << email << ", Role: " << role);
                     
                     return processJsonCommand(command, email, password, role, clientId);
                 }
@@ -1069,7 +1188,7 @@ else if (command == "UPDATE_AVAILABILITY" && !riderId.empty()) {
     return "{\"success\":false,\"message\":\"Command '" + command + "' not implemented\"}";
 }
     string convertToJsonResponse(const string& oldResponse) {
-        cout << "Converting response to JSON: " << oldResponse << endl;
+        LOG_DEBUG("Converting response to JSON: " << oldResponse);
         
         if (oldResponse.find("SUCCESS") == 0) {
             // Format: SUCCESS|id|name|role
@@ -1127,7 +1246,7 @@ else if (command == "UPDATE_AVAILABILITY" && !riderId.empty()) {
             role = jsonString.substr(rolePos, roleEnd - rolePos);
         }
         
-        cout << "JSON Login - Email: " << email << ", Role: " << role << endl;
+        LOG_INFO("JSON Login - Email: " << email << ", Role: " << role);
         
         // Authenticate using userManager
         UserData* user = userManager.authenticateUser(email, password);
@@ -1156,7 +1275,22 @@ else if (command == "UPDATE_AVAILABILITY" && !riderId.empty()) {
     
 public:
     QuickBiteServer(int serverPort = 8080) 
-        : port(serverPort), running(false), nextClientId(1), cityGraph(500) {
+        : port(serverPort), running(false), nextClientId(1), cityGraph(500), catalogGeneration(0) {
+        
+        dispatcher.setRoadNetwork(cityGraph.getGraph());
+        roadDistances.setRoadNetwork(cityGraph.getGraph());
+        tripPlanner.setDistanceCache(&roadDistances);
+        deliveryRoutes.setRoadNetwork(cityGraph.getGraph());
+        plannedRoutes.setRoadNetwork(cityGraph.getGraph());
+#ifdef _WIN32
+        dispatchThread = NULL;
+        checkpointThread = NULL;
+#endif
+        for (int i = 0; i < DATA_FILE_COUNT; i++) {
+            changeCounts[i].store(0);
+            savedCounts[i] = 0;
+            checkpointSkips[i] = 0;
+        }
         
 #ifdef _WIN32
         WSADATA wsaData;
@@ -1188,114 +1322,194 @@ public:
         });
     }
     
-    void loadSystemData() {
-        cout << "\n========================================\n";
-        cout << "   LOADING SYSTEM DATA...              \n";
-        cout << "========================================\n";
-        
-        bool isEmpty = dbManager.getDatabase().loadAllUsers().empty() &&
-                       dbManager.getDatabase().loadAllRestaurants().empty();
-        
-        if (isEmpty) {
-            cout << "⚠ Database is empty. Initializing with sample data...\n";
-            dbManager.initializeSampleData(cityGraph);
-            cityGraph.saveToDatabase();
-            cout << "✓ City map initialized and saved\n";
-        } else {
-            cout << "✓ Database found. Loading existing data...\n";
-            cityGraph.loadFromDatabase();
-            cout << "✓ City map loaded (" << cityGraph.getAllLocations().size() 
-                 << " locations, " << cityGraph.getRoadCount() << " roads)\n";
-        }
-        
-        // Load ALL users into the server's LOCAL userManager
-        vector<UserData> users = dbManager.getDatabase().loadAllUsers();
-        
-        cout << "Loading " << users.size() << " users into server userManager...\n";
-        
-        for (const auto& user : users) {
-            bool success = userManager.registerUser(
-                user.id, 
-                user.getName(), 
-                user.getEmail(),
-                user.getPhone(), 
-                user.getPassword(),
-                user.getRole(), 
-                user.getAddress()
-            );
-            
-            if (success) {
-                cout << "  ✓ Loaded: " << user.email << " (ID: " << user.id 
-                     << ", Role: " << user.role << ")\n";
-            } else {
-                cout << "  ✗ Failed to load: " << user.email << "\n";
+    // Every generation of the snapshot gets a file of its own, so one that
+    // is still mapped is never renamed over (Windows refuses to). The
+    // pointer file names the current one.
+    static string catalogFile(uint64_t generation) { return "catalog." + to_string(generation) + ".snap"; }
+    static const char* catalogPointerFile() { return "catalog.current"; }
+    
+    static uint64_t catalogSourceStamp() {
+        return CatalogSnapshot::stampOf({ "restaurants.dat", "menu_items.dat" });
+    }
+    
+    // Deletes the replaced snapshot files no reader has mapped any more;
+    // the rest are tried again after the next publish
+    void removeStaleCatalogFiles() {
+        vector<string> kept;
+        for (const auto& path : staleCatalogFiles) {
+            if (remove(path.c_str()) != 0 && ifstream(path)) kept.push_back(path);
+        }
+        staleCatalogFiles.swap(kept);
+    }
+    
+    // Writes a snapshot of restaurants and menuItems and makes it the one
+    // catalog reads use. Readers still holding the previous one finish
+    // with it. Call with dataMutex held. The snapshot is built from memory
+    // but stamped with the files on disk, which a checkpoint may not have
+    // caught up with yet; the checkpoint that rewrites restaurants.dat
+    // publishes it again (see checkpointLocked).
+    void publishCatalog(const vector<MenuItem>& menuItems) {
+        uint64_t generation = catalogGeneration + 1;
+        string path = catalogFile(generation);
+        shared_ptr<const CatalogSnapshot> fresh;
+        string error = "can't write " + path;
+        if (CatalogSnapshot::build(path, restaurants, menuItems, generation, catalogSourceStamp())) {
+            fresh = CatalogSnapshot::open(path, &error);
+            if (fresh && !AtomicFileWriter::write(catalogPointerFile(), path.data(), path.size())) {
+                // Still usable now; the next start just rebuilds it
+                LOG_WARN("⚠ Can't record " << path << " in " << catalogPointerFile());
             }
         }
-        
-        cout << "✓ Loaded " << users.size() << " users into server userManager\n";
-        
-        // Debug verification
-        cout << "\nDEBUG: Verifying users in server userManager:\n";
-        int verifiedCount = 0;
-        for (const auto& user : users) {
-            UserData* loadedUser = userManager.getUser(user.id);
-            if (loadedUser) {
-                verifiedCount++;
-                cout << "  ✓ ID: " << user.id << ", Email: " << user.email 
-                     << ", Role: " << user.role << "\n";
-            } else {
-                cout << "  ✗ MISSING: ID: " << user.id << ", Email: " << user.email << "\n";
-            }
+        if (!fresh) {
+            // Catalog reads fall back to the in-memory lists under dataMutex
+            LOG_WARN("⚠ Catalog snapshot unavailable: " << error);
+            remove(path.c_str());
+        }
+        if (catalogGeneration > 0) staleCatalogFiles.push_back(catalogFile(catalogGeneration));
+        catalogGeneration = generation;
+        atomic_store(&catalog, fresh);
+        responseCache.invalidate(ResponseCache::CATALOG);
+        removeStaleCatalogFiles();
+    }
+    
+    // Uses the snapshot on disk as it is if it was built from the current
+    // data files, otherwise builds a new one
+    void openCatalog(const vector<MenuItem>& menuItems) {
+        shared_ptr<const CatalogSnapshot> existing;
+        string current;
+        ifstream pointer(catalogPointerFile());
+        if (pointer && getline(pointer, current) && !current.empty()) existing = CatalogSnapshot::open(current);
+        if (existing) catalogGeneration = existing->getGeneration();
+        // Left by versions that kept the snapshot under one name
+        staleCatalogFiles.push_back("catalog.snap");
+        
+        if (existing && existing->getSourceStamp() == catalogSourceStamp()) {
+            atomic_store(&catalog, existing);
+            LOG_INFO("✓ Catalog snapshot v" << catalogGeneration << " is current ("
+                     << existing->restaurantCount() << " restaurants, "
+                     << existing->menuItemCount() << " menu items)");
+            removeStaleCatalogFiles();
+            return;
+        }
+        publishCatalog(menuItems);
+        LOG_INFO("✓ Catalog snapshot v" << catalogGeneration << " built");
+    }
+    
+    // Reads the data files and builds the server's state from them, each
+    // file on its own thread (see StartupPipeline). Users are registered,
+    // the restaurant index built and menus linked as soon as their inputs
+    // are in memory. False if there are neither users nor restaurants.
+    bool loadDataFiles(bool withCityMap, size_t& userCount, size_t& riderCount) {
+        Database& db = dbManager.getDatabase();
+        
+        // Upgrading a legacy restaurants.dat also writes menu_items.dat,
+        // so it has to be done before either is read
+        if (RestaurantMigration::isLegacyFile("restaurants.dat")) {
+            db.migrateLegacyRestaurants();
         }
-        cout << "Verified " << verifiedCount << " out of " << users.size() << " users\n\n";
         
-        // Load restaurants
-        restaurants = dbManager.getDatabase().loadAllRestaurants();
-        cout << "✓ Loaded " << restaurants.size() << " restaurants\n";
+        vector<UserData> users;
+        vector<MenuItem> menuItems;
+        vector<Rider> riders;
+        size_t registered = 0;
+        
+        StartupPipeline pipeline;
+        int readUsers = pipeline.add("users.dat", [&] { users = db.loadAllUsers(); });
+        int readRestaurants = pipeline.add("restaurants.dat", [&] { restaurants = db.loadAllRestaurants(); });
+        int readMenus = pipeline.add("menu_items.dat", [&] { menuItems = db.loadAllMenuItems(); });
+        pipeline.add("orders.dat", [&] { orders = db.loadAllOrders(); });
+        int readRiders = pipeline.add("riders.dat", [&] { riders = db.loadAllRiders(); });
+        if (withCityMap) {
+            pipeline.add("city map", [&] { cityGraph.loadFromDatabase(); });
+        }
+        
+        int registerUsers = pipeline.add("register users", [&] {
+            registered = userManager.loadUsers(users);
+            if (registered < users.size()) {
+                LOG_WARN("  ✗ " << (users.size() - registered) << " users share an id with another user");
+            }
+        }, {readUsers});
+        
+        int indexRestaurants = pipeline.add("restaurant index", [&] {
+            restaurantIndex.rebuild(restaurants);
+        }, {readRestaurants});
+        
+        pipeline.add("link menu items", [&] {
+            MenuGroups menuGroups;
+            menuGroups.build(menuItems, restaurantIndex);
+            menuGroups.attachTo(restaurants);
+        }, {indexRestaurants, readMenus});
+        
+        pipeline.add("rider table", [&] {
+            dbManager.getRidersHashTable().reserve((int)riders.size());
+            for (const auto& rider : riders) {
+                dbManager.getRidersHashTable().insertItem(rider.getId(), rider);
+            }
+        }, {readRiders});
         
-        // Load and associate menu items
-        vector<MenuItem> menuItems = dbManager.getDatabase().loadAllMenuItems();
-        for (auto& restaurant : restaurants) {
-            for (const auto& item : menuItems) {
-                if (item.restaurantId == restaurant.getRestaurantId()) {
-                    restaurant.addMenuItemId(item.id);
+        pipeline.add("rider accounts", [&] {
+            for (const auto& rider : riders) {
+                if (!userManager.getUser(rider.getId())) {
+                    LOG_WARN("  ⚠ WARNING: Rider " << rider.getName() 
+                         << " (ID: " << rider.getId() << ") has no user account!");
                 }
             }
+        }, {registerUsers, readRiders});
+        
+        pipeline.run();
+        openCatalog(menuItems);
+        
+        LOG_INFO("✓ Loaded " << registered << " of " << users.size() << " users into server userManager");
+        LOG_INFO("✓ Loaded " << restaurants.size() << " restaurants");
+        LOG_INFO("✓ Loaded " << menuItems.size() << " menu items");
+        LOG_INFO("✓ Loaded " << orders.size() << " orders");
+        LOG_INFO("✓ Loaded " << riders.size() << " riders");
+        if (withCityMap) {
+            LOG_INFO("✓ City map loaded (" << cityGraph.getAllLocations().size() 
+                 << " locations, " << cityGraph.getRoadCount() << " roads)");
         }
-        cout << "✓ Loaded " << menuItems.size() << " menu items\n";
+        pipeline.logTimings();
         
-        // Load orders
-        orders = dbManager.getDatabase().loadAllOrders();
-        cout << "✓ Loaded " << orders.size() << " orders\n";
+        userCount = registered;
+        riderCount = riders.size();
+        return !users.empty() || !restaurants.empty();
+    }
+    
+    void loadSystemData() {
+        cout << "\n========================================\n";
+        cout << "   LOADING SYSTEM DATA...              \n";
+        cout << "========================================\n";
         
-        // Load riders into hash table AND ensure their user accounts exist
-        vector<Rider> riders = dbManager.getDatabase().loadAllRiders();
-        cout << "Loading " << riders.size() << " riders...\n";
+        size_t userCount = 0;
+        size_t riderCount = 0;
         
-        for (const auto& rider : riders) {
-            // Insert into riders hash table
-            dbManager.getRidersHashTable().insertItem(rider.getId(), rider);
-            
-            // Verify the rider's user account exists in userManager
-            UserData* riderUser = userManager.getUser(rider.getId());
-            if (riderUser) {
-                cout << "  ✓ Rider verified: " << rider.getName() 
-                     << " (ID: " << rider.getId() << ", User Role: " 
-                     << riderUser->getRole() << ")\n";
-            } else {
-                cout << "  ⚠ WARNING: Rider " << rider.getName() 
-                     << " (ID: " << rider.getId() << ") has no user account!\n";
+        if (loadDataFiles(true, userCount, riderCount)) {
+            LOG_INFO("✓ Database found. Loaded existing data");
+        } else {
+            LOG_WARN("⚠ Database is empty. Initializing with sample data...");
+            dbManager.initializeSampleData(cityGraph);
+            cityGraph.saveToDatabase();
+            LOG_INFO("✓ City map initialized and saved");
+            loadDataFiles(false, userCount, riderCount);
+        }
+        
+        // Files from before the paged format are converted by the first
+        // checkpoint, as if they had changed
+        for (int i = 0; i < DATA_FILE_COUNT; i++) {
+            ifstream file(dataFileName(i), ios::binary | ios::ate);
+            if (file && file.tellg() > 0 && !PagedRecordFile::isContainer(dataFileName(i))) {
+                markChanged(1 << i);
             }
         }
-        cout << "✓ Loaded " << riders.size() << " riders\n";
         
+        Logger::instance().flush();
         cout << "========================================\n";
         cout << "   SYSTEM DATA LOADED SUCCESSFULLY     \n";
         cout << "========================================\n";
-        cout << "  Total Users: " << verifiedCount << "\n";
+        cout << "  Total Users: " << userCount << "\n";
         cout << "  Total Restaurants: " << restaurants.size() << "\n";
         cout << "  Total Orders: " << orders.size() << "\n";
-        cout << "  Total Riders: " << riders.size() << "\n";
+        cout << "  Total Riders: " << riderCount << "\n";
         cout << "========================================\n\n";
     }
     
@@ -1338,9 +1552,13 @@ public:
 #ifdef _WIN32
         HANDLE acceptThread = CreateThread(NULL, 0, acceptConnectionsStatic, this, 0, NULL);
         if (acceptThread) CloseHandle(acceptThread);
+        dispatchThread = CreateThread(NULL, 0, dispatchLoopStatic, this, 0, NULL);
+        checkpointThread = CreateThread(NULL, 0, checkpointLoopStatic, this, 0, NULL);
 #else
         thread acceptThread(&QuickBiteServer::acceptConnections, this);
         acceptThread.detach();
+        dispatchThread = thread(&QuickBiteServer::dispatchLoop, this);
+        checkpointThread = thread(&QuickBiteServer::checkpointLoop, this);
 #endif
         
         return true;
@@ -1349,6 +1567,22 @@ public:
     void stop() {
         running = false;
         
+#ifdef _WIN32
+        if (dispatchThread) {
+            WaitForSingleObject(dispatchThread, INFINITE);
+            CloseHandle(dispatchThread);
+            dispatchThread = NULL;
+        }
+        if (checkpointThread) {
+            WaitForSingleObject(checkpointThread, INFINITE);
+            CloseHandle(checkpointThread);
+            checkpointThread = NULL;
+        }
+#else
+        if (dispatchThread.joinable()) dispatchThread.join();
+        if (checkpointThread.joinable()) checkpointThread.join();
+#endif
+        
 #ifdef _WIN32
         LockGuard lock(clientsMutex);
 #else
@@ -1364,52 +1598,81 @@ public:
         }
         
         saveSystemData();
-        cout << "\nServer stopped.\n";
+        LOG_INFO("Server stopped.");
+        Logger::instance().flush();
     }
     
+    // Writes every data file changed since its last checkpoint, now.
+    // Called on shutdown and from the server menu; while the server runs,
+    // the checkpoint thread does the same every CHECKPOINT_INTERVAL_MS.
+    // The city map isn't included: it is saved whenever it changes.
     void saveSystemData() {
-        cout << "\nSaving system data...\n";
+        LOG_INFO("Saving system data...");
         
+        // A file changed again while being written is retried at once
+        bool complete = checkpoint();
+        for (int attempt = 1; !complete && attempt < 3; attempt++) {
+            complete = checkpoint();
+        }
+        
+        if (complete) LOG_INFO("✓ System data saved");
+        else LOG_WARN("⚠ Some data files were not saved");
+        Logger::instance().flush();
+    }
+    
+    // Checkpoints what changed, then backs the data files up from the
+    // same Database the handlers write through; requests are served
+    // throughout. checkpointMutex is held across both, so no other
+    // checkpoint can replace some of the files in between. The backup is
+    // frozen with dataMutex held and only once no change is left unsaved,
+    // so the checkpointed files and menu_items.dat, which handlers write
+    // directly, are from the same moment. A server that keeps changing
+    // gets BACKUP_ATTEMPTS checkpoints before it is frozen regardless.
+    bool backupSystemData() {
 #ifdef _WIN32
-        LockGuard lock(dataMutex);
+        LockGuard checkpointLock(checkpointMutex);
 #else
-        lock_guard<mutex> lock(dataMutex);
+        lock_guard<mutex> checkpointLock(checkpointMutex);
 #endif
-        
-        // Save ALL users from userManager (including riders)
-        vector<UserData> users;
-        for (int id = 0; id < 10000; id++) {  // Increased range to catch all users
-            UserData* user = userManager.getUser(id);
-            if (user) {
-                users.push_back(*user);
-                cout << "  Saving user: " << user->email << " (ID: " << user->id << ", Role: " << user->role << ")\n";
+        cout << "Creating database backup...\n";
+        OnlineBackup backup;
+        dbManager.addBackupFiles(backup);
+        
+        // Taken under dataMutex, which is released before the copy
+        unique_ptr<Database::FileGuard> files;
+        for (int attempt = 1; !files; attempt++) {
+            checkpointLocked();
+            dataMutex.lock();
+            bool saved = allChangesSaved();
+            if (saved || attempt == BACKUP_ATTEMPTS) {
+                if (!saved) LOG_WARN("⚠ Backing up with some changes not yet saved");
+                files.reset(new Database::FileGuard(dbManager.getDatabase()));
+                backup.freeze();
             }
+            dataMutex.unlock();
         }
-        
-        cout << "Total users to save: " << users.size() << "\n";
-        dbManager.getDatabase().saveAllUsers(users);
-        
-        dbManager.getDatabase().saveAllRestaurants(restaurants);
-        cout << "Saved " << restaurants.size() << " restaurants\n";
-        
-        vector<MenuItem> menuItems = dbManager.getDatabase().loadAllMenuItems();
-        dbManager.getDatabase().saveAllMenuItems(menuItems);
-        
-        dbManager.getDatabase().saveAllOrders(orders);
-        cout << "Saved " << orders.size() << " orders\n";
-        
-        vector<Rider> riders;
-        dbManager.getRidersHashTable().traverse([&](int id, Rider& rider) {
-            riders.push_back(rider);
-        });
-        dbManager.getDatabase().saveAllRiders(riders);
-        cout << "Saved " << riders.size() << " riders\n";
-        
-        cityGraph.saveToDatabase();
-        
-        cout << "✓ System data saved\n";
+#ifndef _WIN32
+        // The frozen handles read the versions they opened; only Windows
+        // needs writers kept out for the copy (see OnlineBackup)
+        files.reset();
+#endif
+        bool ok = dbManager.copyBackup(backup);
+        files.reset();
+        Logger::instance().flush();
+        return ok;
     }
     
+    // Whether the last checkpoint holds every change; call with
+    // checkpointMutex and dataMutex held
+    bool allChangesSaved() const {
+        for (int i = 0; i < DATA_FILE_COUNT; i++) {
+            if (changeCounts[i].load(memory_order_acquire) != savedCounts[i]) return false;
+        }
+        return true;
+    }
+    
+    ServerMetrics& getMetrics() { return metrics; }
+    
 private:
 #ifdef _WIN32
     static DWORD WINAPI acceptConnectionsStatic(LPVOID lpParam) {
@@ -1418,6 +1681,16 @@ private:
         return 0;
     }
     
+    static DWORD WINAPI dispatchLoopStatic(LPVOID lpParam) {
+        ((QuickBiteServer*)lpParam)->dispatchLoop();
+        return 0;
+    }
+    
+    static DWORD WINAPI checkpointLoopStatic(LPVOID lpParam) {
+        ((QuickBiteServer*)lpParam)->checkpointLoop();
+        return 0;
+    }
+    
     static DWORD WINAPI handleClientStatic(LPVOID lpParam) {
         ClientParams* params = (ClientParams*)lpParam;
         params->server->handleClient(params->clientSocket, params->clientId);
@@ -1441,7 +1714,7 @@ private:
                                             &clientLen);
             
             if (clientSocket == INVALID_SOCKET) {
-                if (running) cerr << "Accept failed\n";
+                if (running) LOG_ERROR("Accept failed");
                 continue;
             }
             
@@ -1463,8 +1736,8 @@ private:
                 connectedClients[clientId] = clientSocket;
             }
             
-            cout << "✓ Client connected [ID: " << clientId 
-                 << ", IP: " << clientIP << "]\n";
+            LOG_INFO("✓ Client connected [ID: " << clientId 
+                 << ", IP: " << clientIP << "]");
             
 #ifdef _WIN32
             ClientParams* params = new ClientParams;
@@ -1481,47 +1754,167 @@ private:
 #endif
         }
     }
+    // The cached reply to a JSON catalog query, empty on a miss. Like the
+    // text ones, hits are served without dataMutex.
+    string cachedJsonReply(const string& request) {
+        string command, key;
+        if (request.find("\"command\":\"GET_RESTAURANTS\"") != string::npos) {
+            command = "GET_RESTAURANTS";
+        } else if (request.find("\"command\":\"GET_RESTAURANT_MENU\"") != string::npos) {
+            size_t at = request.find("\"restaurantId\":");
+            if (at == string::npos) return "";
+            at += strlen("\"restaurantId\":");
+            if (at < request.size() && request[at] == '"') at++;
+            char* end = nullptr;
+            long id = strtol(request.c_str() + at, &end, 10);
+            if (end == request.c_str() + at) return "";
+            command = "GET_RESTAURANT_MENU";
+            key = to_string(id);
+        } else {
+            return "";
+        }
+        shared_ptr<const string> cached = responseCache.find(ResponseCache::JSON, command, key);
+        return cached ? *cached : string();
+    }
+    
+    // Length of the JSON object buffer starts with, or npos if it hasn't
+    // all arrived yet
+    static size_t jsonFrameEnd(const string& buffer) {
+        int depth = 0;
+        bool inString = false;
+        for (size_t i = 0; i < buffer.size(); i++) {
+            char c = buffer[i];
+            if (inString) {
+                if (c == '\\') i++;
+                else if (c == '"') inString = false;
+            } else if (c == '"') {
+                inString = true;
+            } else if (c == '{') {
+                depth++;
+            } else if (c == '}' && --depth == 0) {
+                return i + 1;
+            }
+        }
+        return string::npos;
+    }
+    
+    bool sendAll(SocketType clientSocket, const string& payload) {
+        size_t sent = 0;
+        while (sent < payload.length()) {
+            int n = send(clientSocket, payload.c_str() + sent, (int)(payload.length() - sent), 0);
+            if (n == SOCKET_ERROR || n == 0) return false;
+            sent += n;
+        }
+        return true;
+    }
+    
     void handleClient(SocketType clientSocket, int clientId) {
     char buffer[5000];
+    string pending;   // bytes received but not yet handled
+    bool jsonClient = false;
+    
+    metrics.attachThread();
+    metrics.connectedClients++;
+    MetricsShard& shard = metrics.local();
     
     while (running) {
-        memset(buffer, 0, sizeof(buffer));
-        int bytesReceived = recv(clientSocket, buffer, sizeof(buffer) - 1, 0);
+        int bytesReceived = recv(clientSocket, buffer, sizeof(buffer), 0);
         
         if (bytesReceived <= 0) break;
         
-        buffer[bytesReceived] = '\0';
-        string request(buffer);
-        
-        cout << "Received request: " << request << endl;
-        
-        string response;
-        
-        // Check if it's JSON
-        if (request.find("{") != string::npos && request.find("command") != string::npos) {
-            response = handleJsonRequest(request, clientId);
+        MetricsShard::bump(shard.bytesReceived, bytesReceived);
+        pending.append(buffer, bytesReceived);
+        
+        // A client may pipeline several Message frames in one write, so
+        // every complete frame in the buffer is answered, in order, and
+        // the replies go out together in a single send, after the changes
+        // any of them made are saved.
+        string responses;
+        SaveTarget unsaved;
+        
+        // JSON requests are framed by brace balance: one split across
+        // reads waits for the rest, several in one read are answered in
+        // order, and whatever follows the last complete one stays pending.
+        // Separators (newlines) between objects are skipped.
+        if (!jsonClient && pending[0] == '{') jsonClient = true;
+        
+        if (jsonClient) {
+            while (true) {
+                size_t start = pending.find('{');
+                if (start == string::npos) {
+                    pending.clear();
+                    break;
+                }
+                pending.erase(0, start);
+                
+                size_t end = jsonFrameEnd(pending);
+                if (end == string::npos) break;
+                string request = pending.substr(0, end);
+                pending.erase(0, end);
+                
+                LOG_DEBUG("Received request: " << request);
+                uint64_t started = ServerMetrics::nowMicros();
+                
+                string response = cachedJsonReply(request);
+                if (response.empty()) {
+#ifdef _WIN32
+                    LockGuard lock(dataMutex);
+#else
+                    lock_guard<mutex> lock(dataMutex);
+#endif
+                    // JSON handlers don't go through dispatchCommand; anything
+                    // but a query or a login may change any of the files
+                    if (request.find("\"command\":\"GET_") == string::npos &&
+                        request.find("\"command\":\"LOGIN\"") == string::npos) {
+                        markChanged(ALL_DATA_FILES);
+                        noteUnsaved(unsaved);
+                    }
+                    response = handleJsonRequest(request, clientId);
+                }
+                shard.recordCommand(ServerMetrics::commandIndex("JSON"),
+                                    ServerMetrics::nowMicros() - started,
+                                    response.find("\"success\":false") != string::npos);
+                LOG_DEBUG("Sending response: " << response);
+                responses += response + "\n";
+            }
+            if (pending.size() > MAX_JSON_REQUEST) {
+                LOG_WARN("✗ Client " << clientId << " sent an oversized JSON request");
+                break;
+            }
         } else {
             // Binary Message struct format
-            Message msg;
-            memcpy(&msg, buffer, min((size_t)bytesReceived, sizeof(Message)));
-            msg.clientId = clientId;
-            response = processCommand(msg);
+            int frames = (int)(pending.size() / sizeof(Message));
+            metrics.pendingFrames += frames;
+            
+            while (pending.size() >= sizeof(Message)) {
+                Message msg;
+                memcpy(&msg, pending.data(), sizeof(Message));
+                pending.erase(0, sizeof(Message));
+                msg.command[sizeof(msg.command) - 1] = '\0';
+                msg.data[sizeof(msg.data) - 1] = '\0';
+                msg.clientId = clientId;
+                
+                string response = processCommand(msg, unsaved);
+                metrics.pendingFrames--;
+                
+                // Send response WITH newline
+                LOG_DEBUG("Sending response: " << response);
+                responses += response + "\n";
+            }
         }
         
-        // Send response WITH newline
-        cout << "Sending response: " << response << endl;
-        response += "\n";
-        send(clientSocket, response.c_str(), (int)response.length(), 0);
-        
-        // Don't close connection immediately - wait for more requests
-        // Add a small delay to ensure response is sent
-#ifdef _WIN32
-        Sleep(100);
-#else
-        usleep(100000);
-#endif
+        if (unsaved.pending && !waitUntilSaved(unsaved)) {
+            LOG_ERROR("✗ Changes acknowledged to client " << clientId << " could not be saved");
+        }
+        if (!responses.empty()) {
+            if (!sendAll(clientSocket, responses)) break;
+            MetricsShard::bump(shard.bytesSent, responses.length());
+        }
     }
     
+    metrics.connectedClients--;
+    metrics.detachThread();
+    
     {
 #ifdef _WIN32
         LockGuard lock(clientsMutex);
@@ -1532,23 +1925,177 @@ private:
         clientTypes.erase(clientId);
     }
     
-    cout << "✗ Client disconnected [ID: " << clientId << "]" << endl;
+    LOG_INFO("✗ Client disconnected [ID: " << clientId << "]");
     CLOSE_SOCKET(clientSocket);
 }
     
-    string processCommand(const Message& msg) {
+    // Handles one frame; unsaved is pointed at the change counts the
+    // reply has to wait for if the command changed anything
+    string processCommand(const Message& msg, SaveTarget& unsaved) {
         string command = msg.command;
         string data = msg.data;
         
-        cout << "Processing: " << command << " from client " << msg.clientId << "\n";
+        LOG_DEBUG("Processing: " << command << " from client " << msg.clientId);
+        
+        MetricsShard& shard = metrics.local();
+        uint64_t started = ServerMetrics::nowMicros();
+        
+        // Metrics are read from lock-free counters, never under dataMutex
+        if (command == "GET_METRICS") {
+            string response = handleGetMetrics();
+            shard.recordCommand(ServerMetrics::commandIndex(command),
+                                ServerMetrics::nowMicros() - started, false);
+            return response;
+        }
+        
+        // So are cached catalog and map replies
+        int cacheDomain = ResponseCache::domainOf(command);
+        uint64_t cacheVersion = 0;
+        if (cacheDomain >= 0) {
+            shared_ptr<const string> cached = responseCache.find(ResponseCache::TEXT, command, data);
+            if (cached) {
+                shard.recordCommand(ServerMetrics::commandIndex(command),
+                                    ServerMetrics::nowMicros() - started, false);
+                return *cached;
+            }
+            cacheVersion = responseCache.version(cacheDomain);
+        }
+        
+        // and the catalog, from its immutable snapshot
+        if (command == "GET_RESTAURANTS" || command == "GET_MENU") {
+            shared_ptr<const CatalogSnapshot> snapshot = atomic_load(&catalog);
+            if (snapshot) {
+                string response = (command == "GET_MENU") ? formatMenu(*snapshot, data)
+                                                          : formatRestaurants(*snapshot);
+                bool failed = response.compare(0, 5, "ERROR") == 0;
+                if (!failed) {
+                    responseCache.store(ResponseCache::TEXT, command, data, cacheDomain, cacheVersion, response);
+                }
+                shard.recordCommand(ServerMetrics::commandIndex(command),
+                                    ServerMetrics::nowMicros() - started, failed);
+                return response;
+            }
+        }
         
+        string response;
+        uint64_t acquired, released;
+        metrics.lockWaiters++;
+        {
 #ifdef _WIN32
-        LockGuard lock(dataMutex);
+            LockGuard lock(dataMutex);
 #else
-        lock_guard<mutex> lock(dataMutex);
+            lock_guard<mutex> lock(dataMutex);
 #endif
+            acquired = ServerMetrics::nowMicros();
+            metrics.lockWaiters--;
+            
+            // Only this command marks anything while dataMutex is held
+            uint64_t before = totalChangeCount();
+            if (command == "BATCH") response = handleBatch(data, msg.clientId);
+            else response = dispatchCommand(command, data, msg.clientId);
+            if (totalChangeCount() != before) noteUnsaved(unsaved);
+            
+            released = ServerMetrics::nowMicros();
+        }
+        
+        if (cacheDomain >= 0 && response.compare(0, 5, "ERROR") != 0) {
+            responseCache.store(ResponseCache::TEXT, command, data, cacheDomain, cacheVersion, response);
+        }
         
-        if (command == "LOGIN") return handleLogin(data, msg.clientId);
+        shard.lockWait.record(acquired - started);
+        shard.lockHold.record(released - acquired);
+        shard.recordCommand(ServerMetrics::commandIndex(command), released - started,
+                            response.compare(0, 5, "ERROR") == 0);
+        
+        return response;
+    }
+    
+    string handleGetMetrics() {
+        return "SUCCESS|" + metrics.formatSummary();
+    }
+    
+    static const char* dataFileName(int file) {
+        static const char* names[DATA_FILE_COUNT] = { "users.dat", "restaurants.dat", "orders.dat", "riders.dat" };
+        return names[file];
+    }
+    
+    // The data files a command's handler may change, as DataFile bits
+    static unsigned filesChangedBy(const string& command) {
+        if (command == "REGISTER") return 1 << USERS_DATA;
+        if (command == "ADD_RIDER" || command == "REMOVE_RIDER" || command == "CHANGE_USER_ROLE") {
+            return (1 << USERS_DATA) | (1 << RIDERS_DATA);
+        }
+        if (command == "ADD_RESTAURANT" || command == "REMOVE_RESTAURANT" ||
+            command == "ADD_MENU_ITEM" || command == "REMOVE_MENU_ITEM") {
+            return 1 << RESTAURANTS_DATA;
+        }
+        if (command == "PLACE_ORDER") return 1 << ORDERS_DATA;
+        if (command == "UPDATE_ORDER_STATUS" || command == "ASSIGN_RIDER" || command == "RUN_DISPATCH") {
+            return (1 << ORDERS_DATA) | (1 << RIDERS_DATA);
+        }
+        if (command == "UPDATE_RIDER_STATUS") return 1 << RIDERS_DATA;
+        return 0;
+    }
+    
+    // Marks the DataFile bits in files as changed
+    void markChanged(unsigned files) {
+        for (int i = 0; i < DATA_FILE_COUNT; i++) {
+            if (files & (1u << i)) changeCounts[i].fetch_add(1, memory_order_acq_rel);
+        }
+    }
+    
+    // Sum of the change counts; caller must hold dataMutex
+    uint64_t totalChangeCount() const {
+        uint64_t total = 0;
+        for (int i = 0; i < DATA_FILE_COUNT; i++) total += changeCounts[i].load(memory_order_acquire);
+        return total;
+    }
+    
+    // Makes target wait for everything changed so far; caller must hold
+    // dataMutex, after marking its own changes
+    void noteUnsaved(SaveTarget& target) const {
+        for (int i = 0; i < DATA_FILE_COUNT; i++) target.counts[i] = changeCounts[i].load(memory_order_acquire);
+        target.pending = true;
+    }
+    
+    // Group commit: returns once a checkpoint has saved every change
+    // target counts. Replies waiting at the same time queue on
+    // checkpointMutex, and those behind the first usually find the
+    // checkpoint it ran already covers them. A file another writer got
+    // to first is retried until the skip limit forces it. False if the
+    // changes still aren't saved.
+    bool waitUntilSaved(SaveTarget& target) {
+#ifdef _WIN32
+        LockGuard checkpointLock(checkpointMutex);
+#else
+        lock_guard<mutex> checkpointLock(checkpointMutex);
+#endif
+        bool saved = isSaved(target);
+        for (int attempt = 0; !saved && attempt <= MAX_CHECKPOINT_SKIPS; attempt++) {
+            checkpointLocked();
+            saved = isSaved(target);
+        }
+        target.pending = false;
+        return saved;
+    }
+    
+    // Call with checkpointMutex held
+    bool isSaved(const SaveTarget& target) const {
+        for (int i = 0; i < DATA_FILE_COUNT; i++) {
+            if (savedCounts[i] < target.counts[i]) return false;
+        }
+        return true;
+    }
+    
+    // Caller must hold dataMutex
+    string dispatchCommand(const string& command, const string& data, int clientId) {
+        unsigned files = filesChangedBy(command);
+        if (files) markChanged(files);
+        return routeCommand(command, data, clientId);
+    }
+    
+    string routeCommand(const string& command, const string& data, int clientId) {
+        if (command == "LOGIN") return handleLogin(data, clientId);
         else if (command == "REGISTER") return handleRegister(data);
         else if (command == "GET_RESTAURANTS") return handleGetRestaurants();
         else if (command == "GET_MENU") return handleGetMenu(data);
@@ -1557,6 +2104,7 @@ private:
         else if (command == "GET_RIDERS") return handleGetRiders();
         else if (command == "UPDATE_ORDER_STATUS") return handleUpdateOrderStatus(data);
         else if (command == "ASSIGN_RIDER") return handleAssignRider(data);
+        else if (command == "RUN_DISPATCH") return handleRunDispatch();
         else if (command == "GET_CITY_MAP") return handleGetCityMap();
         else if (command == "GET_AVAILABLE_ORDERS") return handleGetAvailableOrders();
         else if (command == "GET_RIDER_ORDERS") return handleGetRiderOrders(data);
@@ -1573,11 +2121,53 @@ private:
         else if (command == "ADD_RIDER") return handleAddRider(data);
         else if (command == "REMOVE_RIDER") return handleRemoveRider(data);
         else if (command == "CHANGE_USER_ROLE") return handleChangeUserRole(data);
+        else if (command == "GET_METRICS") return handleGetMetrics();
         else if (command == "PING") return "PONG";
         
         return "ERROR:Unknown command";
     }
     
+    // BATCH carries one sub-command per line as "COMMAND:data". All of them
+    // run under the single dataMutex acquisition made by processCommand, and
+    // the results come back length-prefixed so they may contain any
+    // separator: SUCCESS|<count>|<len>:<result><len>:<result>...
+    string handleBatch(const string& data, int clientId) {
+        string result;
+        int count = 0;
+        
+        size_t start = 0;
+        while (start < data.length()) {
+            size_t end = data.find('\n', start);
+            if (end == string::npos) end = data.length();
+            
+            string entry = data.substr(start, end - start);
+            start = end + 1;
+            if (entry.empty()) continue;
+            
+            size_t colon = entry.find(':');
+            string command = entry.substr(0, colon);
+            string args = colon == string::npos ? "" : entry.substr(colon + 1);
+            
+            string response;
+            if (command == "BATCH") {
+                response = "ERROR:Nested batch";
+            } else {
+                try {
+                    response = dispatchCommand(command, args, clientId);
+                } catch (const exception& e) {
+                    response = "ERROR:" + string(e.what());
+                }
+            }
+            
+            result += to_string(response.length()) + ":" + response;
+            count++;
+        }
+        
+        if (count == 0) return "ERROR:Empty batch";
+        
+        return "SUCCESS|" + to_string(count) + "|" + result;
+    }
+    
     // === COMMAND HANDLERS ===
     
     string handleLogin(const string& data, int clientId) {
@@ -1587,19 +2177,19 @@ private:
         string email = data.substr(0, pos);
         string password = data.substr(pos + 1);
         
-        cout << "DEBUG LOGIN: Email='" << email << "', Password='" << password << "'\n";
+        LOG_DEBUG("Login attempt: Email='" << email << "'");
         
         // Use the server's local userManager (not dbManager's)
         UserData* user = userManager.authenticateUser(email, password);
         
         if (user) {
-            cout << "✓ Login successful: " << user->getName() << " (Role: " << user->getRole() << ")\n";
+            LOG_INFO("✓ Login successful: " << user->getName() << " (Role: " << user->getRole() << ")");
             clientTypes[clientId] = user->getRole();
             return "SUCCESS|" + to_string(user->id) + "|" + 
                    user->getName() + "|" + user->getRole();
         }
         
-        cout << "✗ Login failed for: " << email << "\n";
+        LOG_WARN("✗ Login failed for: " << email);
         
         return "ERROR:Invalid credentials";
     }
@@ -1625,15 +2215,63 @@ private:
                                                parts[3], parts[2], "customer", parts[4]);
         
         if (success) {
-            UserData newUser(newId, parts[0], parts[1], parts[3], parts[2], "customer", parts[4]);
-            dbManager.getDatabase().saveUser(newUser);
             return "SUCCESS|" + to_string(newId);
         }
         
         return "ERROR:Registration failed";
     }
     
+    // Same replies as handleGetRestaurants / handleGetMenu, read straight
+    // from the snapshot
+    static string formatRestaurants(const CatalogSnapshot& snapshot) {
+        string result = "SUCCESS|";
+        
+        for (uint32_t i = 0; i < snapshot.restaurantCount(); i++) {
+            const CatalogRestaurant& r = snapshot.restaurant(i);
+            if (i > 0) result += "|";
+            result += to_string(r.id);
+            result += ";";
+            snapshot.appendText(result, r.name);
+            result += ";";
+            snapshot.appendText(result, r.cuisine);
+            result += ";";
+            snapshot.appendText(result, r.address);
+            result += ";" + to_string(r.rating) + ";" + to_string(r.deliveryTime);
+        }
+        
+        return result;
+    }
+    
+    static string formatMenu(const CatalogSnapshot& snapshot, const string& data) {
+        int restaurantId;
+        try {
+            restaurantId = stoi(data);
+        } catch (const exception&) {
+            return "ERROR:Invalid restaurant ID";
+        }
+        
+        string result = "SUCCESS|";
+        const CatalogRestaurant* r = snapshot.findRestaurant(restaurantId);
+        if (!r) return result;
+        
+        for (const CatalogMenuItem* item = snapshot.menuBegin(*r); item != snapshot.menuEnd(*r); ++item) {
+            if (item != snapshot.menuBegin(*r)) result += "|";
+            result += to_string(item->id);
+            result += ";";
+            snapshot.appendText(result, item->name);
+            result += ";";
+            snapshot.appendText(result, item->description);
+            result += ";" + to_string(item->price) + ";" + to_string(item->stock) + ";";
+            snapshot.appendText(result, item->category);
+        }
+        
+        return result;
+    }
+    
     string handleGetRestaurants() {
+        shared_ptr<const CatalogSnapshot> snapshot = atomic_load(&catalog);
+        if (snapshot) return formatRestaurants(*snapshot);
+        
         string result = "SUCCESS|";
         
         for (size_t i = 0; i < restaurants.size(); i++) {
@@ -1652,6 +2290,9 @@ private:
     }
     
     string handleGetMenu(const string& data) {
+        shared_ptr<const CatalogSnapshot> snapshot = atomic_load(&catalog);
+        if (snapshot) return formatMenu(*snapshot, data);
+        
         int restaurantId = stoi(data);
         vector<MenuItem> menuItems = dbManager.getMenuItemsByRestaurant(restaurantId);
         
@@ -1731,8 +2372,8 @@ private:
             }
         }
         
+        // orders.dat is written by the next checkpoint
         orders.push_back(newOrder);
-        dbManager.getDatabase().saveOrder(newOrder);
         
         return "SUCCESS|" + to_string(orderId);
     }
@@ -1785,7 +2426,12 @@ private:
             if (order.getOrderId() == orderId) {
                 if (newStatus == "Preparing") order.updateStatus(OrderStatus::Preparing);
                 else if (newStatus == "Dispatched") order.updateStatus(OrderStatus::Dispatched);
-                else if (newStatus == "In Transit") order.updateStatus(OrderStatus::InTransit);
+                else if (newStatus == "In Transit") {
+                    order.updateStatus(OrderStatus::InTransit);
+                    if (order.getRiderID() != -1) {
+                        completeTripStops(order.getRiderID(), orderId, true);
+                    }
+                }
                 else if (newStatus == "Delivered") {
                     order.updateStatus(OrderStatus::Delivered);
                     
@@ -1802,10 +2448,13 @@ private:
                         riderStatistics[riderId].onTimeDeliveries++;
                         riderStatistics[riderId].totalEarnings += order.getTotalAmount() * 0.1;
                         
-                        riderStatus[riderId] = "Active";
+                        // A rider on a multi-order trip stays busy until its last drop-off
+                        if (completeTripStops(riderId, orderId, false) == 0) {
+                            riderStatus[riderId] = "Active";
+                        }
                         
-                        cout << "✓ Rider " << riderId << " completed delivery. "
-                             << "Earnings: $" << riderStatistics[riderId].totalEarnings << "\n";
+                        LOG_INFO("✓ Rider " << riderId << " completed delivery. "
+                             << "Earnings: $" << riderStatistics[riderId].totalEarnings);
                     }
                 }
                 else if (newStatus == "Cancelled") {
@@ -1815,9 +2464,16 @@ private:
                     if (riderId != -1 && riderStatistics.find(riderId) != riderStatistics.end()) {
                         riderStatistics[riderId].failedDeliveries++;
                     }
+                    // A rider whose trip is now empty is free again
+                    if (riderId != -1 && completeTripStops(riderId, orderId, false) == 0) {
+                        riderStatus[riderId] = "Active";
+                    }
+                }
+                
+                if (newStatus == "Delivered" || newStatus == "Cancelled") {
+                    plannedRoutes.remove(orderId);
                 }
                 
-                dbManager.updateOrder(order);
                 return "SUCCESS";
             }
         }
@@ -1830,22 +2486,45 @@ private:
         if (pos == string::npos) return "ERROR:Invalid format";
         
         int orderId = stoi(data.substr(0, pos));
-        int riderId = stoi(data.substr(pos + 1));
+        string riderField = data.substr(pos + 1);
+        
+        // <order>|AUTO leaves the choice of rider to the next dispatch cycle
+        if (riderField == "AUTO") {
+            Order* order = findOrder(orderId);
+            if (!order) return "ERROR:Order not found";
+            if (order->getRiderID() != -1) return "ERROR:Order already assigned";
+            
+            dispatcher.submit(DispatchRequest(orderId, pickupNodeFor(*order)));
+            LOG_INFO("Order " << orderId << " queued for batch dispatch ("
+                 << dispatcher.pendingCount() << " waiting)");
+            return "SUCCESS|QUEUED";
+        }
+        
+        int riderId = stoi(riderField);
         
         for (auto& order : orders) {
             if (order.getOrderId() == orderId) {
+                // A manual assignment overrides a queued automatic one
+                dispatcher.cancel(orderId);
+                
                 order.assignRider(riderId);
                 
+                // Riders already on a trip pick the new order up after their planned stops
+                auto trip = riderTrips.find(riderId);
+                if (trip != riderTrips.end()) {
+                    trip->second.push_back(TripStop(orderId, pickupNodeFor(order), true));
+                    trip->second.push_back(TripStop(orderId, order.deliveryLocation, false));
+                }
+                
                 riderStatus[riderId] = "Busy";
                 
                 Rider* rider = dbManager.getRidersHashTable().getItem(riderId);
                 if (rider) {
                     rider->setStatus("Busy");
+                    planDeliveryRoute(orderId, riderId, rider->location);
                 }
                 
-                dbManager.updateOrder(order);
-                
-                cout << "✓ Order " << orderId << " assigned to Rider " << riderId << "\n";
+                LOG_INFO("✓ Order " << orderId << " assigned to Rider " << riderId);
                 
                 return "SUCCESS";
             }
@@ -1854,6 +2533,379 @@ private:
         return "ERROR:Order not found";
     }
     
+    // Runs the pending dispatch batch now instead of waiting for the window
+    string handleRunDispatch() {
+        int waiting = dispatcher.pendingCount();
+        int assigned = runDispatchCycle();
+        return "SUCCESS|" + to_string(assigned) + "|" + to_string(waiting - assigned);
+    }
+    
+    Order* findOrder(int orderId) {
+        for (auto& order : orders) {
+            if (order.getOrderId() == orderId) return &order;
+        }
+        return nullptr;
+    }
+    
+    // Ids for new accounts and riders, one past the highest in memory; the
+    // files can be a checkpoint behind
+    int nextFreeUserId() {
+        int highest = 99;
+        for (const auto& user : userManager.getAllUsersAsVector()) {
+            highest = max(highest, user.id);
+        }
+        return highest + 1;
+    }
+    
+    int nextFreeRiderId() {
+        int highest = 99;
+        dbManager.getRidersHashTable().traverse([&](int id, Rider&) {
+            highest = max(highest, id);
+        });
+        return highest + 1;
+    }
+    
+    // Graph node the rider has to reach to collect an order
+    int pickupNodeFor(const Order& order) {
+        const RestaurantSummary* r = restaurantIndex.find(order.getRestaurant());
+        if (r && cityGraph.locationExists(r->locationNode)) {
+            return r->locationNode;
+        }
+        return order.deliveryLocation;
+    }
+    
+    // Full record of a restaurant, nullptr if there's none with that id
+    const Restaurant* findRestaurant(int restaurantId) const {
+        int slot = restaurantIndex.slotOf(restaurantId);
+        return slot >= 0 ? &restaurants[slot] : nullptr;
+    }
+    
+    string restaurantNameFor(int restaurantId) const {
+        const Restaurant* r = findRestaurant(restaurantId);
+        return r ? r->getName() : "Unknown";
+    }
+    
+    bool isRiderFree(int riderId, const Rider& rider) {
+        auto it = riderStatus.find(riderId);
+        string status = (it != riderStatus.end()) ? it->second : rider.getStatus();
+        return status == "Active" || status == "available";
+    }
+    
+    // Graph node the order is delivered to, or -1 if it isn't on the map
+    int dropoffNodeFor(const Order& order) {
+        return cityGraph.locationExists(order.deliveryLocation) ? order.deliveryLocation : -1;
+    }
+    
+    // Groups every queued AUTO order into trips, solves the trips against
+    // the riders that are free right now (each trip is matched on the
+    // distance to its first stop) and applies the whole result in one
+    // critical section, so clients never observe half a batch. Orders whose
+    // trip got no rider stay queued. Caller must hold dataMutex. Returns the
+    // number of orders assigned.
+    int runDispatchCycle() {
+        vector<TripJob> jobs;
+        for (const auto& request : dispatcher.takePending()) {
+            Order* order = findOrder(request.orderId);
+            if (order && order->getRiderID() == -1) {
+                jobs.push_back(TripJob(request.orderId, request.pickupNode, dropoffNodeFor(*order)));
+            }
+        }
+        if (jobs.empty()) return 0;
+        
+        vector<Trip> trips = tripPlanner.plan(jobs);
+        
+        // The engine matches requests by id; here the id is the trip index
+        vector<DispatchRequest> tripRequests;
+        for (size_t t = 0; t < trips.size(); t++) {
+            tripRequests.push_back(DispatchRequest((int)t, trips[t].stops[0].node));
+        }
+        
+        vector<DispatchCandidate> candidates;
+        dbManager.getRidersHashTable().traverse([&](int id, Rider& rider) {
+            if (isRiderFree(id, rider)) {
+                candidates.push_back(DispatchCandidate(id, rider.location));
+            }
+        });
+        
+        vector<DispatchRequest> unassignedTrips;
+        vector<DispatchAssignment> plan = dispatcher.solve(tripRequests, candidates, &unassignedTrips);
+        
+        int assigned = 0;
+        for (const auto& a : plan) {
+            const Trip& trip = trips[a.orderId];
+            for (int orderId : trip.orderIds) {
+                Order* order = findOrder(orderId);
+                order->assignRider(a.riderId);
+                assigned++;
+            }
+            riderStatus[a.riderId] = "Busy";
+            
+            Rider* rider = dbManager.getRidersHashTable().getItem(a.riderId);
+            if (rider) rider->setStatus("Busy");
+            
+            vector<TripStop>& stops = riderTrips[a.riderId];
+            stops.insert(stops.end(), trip.stops.begin(), trip.stops.end());
+            
+            if (rider) {
+                for (int orderId : trip.orderIds) {
+                    planDeliveryRoute(orderId, a.riderId, rider->location);
+                }
+            }
+            
+            string where = a.pickupDistance >= 0
+                ? to_string(a.pickupDistance) + "m to pickup" : "location unknown";
+            if (trip.orderIds.size() == 1) {
+                LOG_INFO("✓ Order " << trip.orderIds[0] << " dispatched to Rider " << a.riderId
+                     << " (" << where << ")");
+            } else {
+                LOG_INFO("✓ Trip of " << trip.orderIds.size() << " orders ("
+                     << trip.stops.size() << " stops, " << trip.distance
+                     << "m) dispatched to Rider " << a.riderId << " (" << where << ")");
+            }
+        }
+        
+        int waiting = 0;
+        for (const auto& request : unassignedTrips) {
+            for (const auto& stop : trips[request.orderId].stops) {
+                if (stop.pickup) {
+                    dispatcher.submit(DispatchRequest(stop.orderId, stop.node));
+                    waiting++;
+                }
+            }
+        }
+        
+        if (!plan.empty()) {
+            LOG_INFO("Dispatch cycle: " << assigned << " orders in " << plan.size() << " trips assigned, "
+                 << waiting << " waiting, " << candidates.size() << " riders free");
+        } else {
+            LOG_DEBUG("Dispatch cycle: no rider for " << waiting << " orders");
+        }
+        return assigned;
+    }
+    
+    // Drops an order's stops from its rider's trip (only the pickup once it
+    // is in transit). Returns how many stops the rider still has.
+    int completeTripStops(int riderId, int orderId, bool pickupOnly) {
+        auto it = riderTrips.find(riderId);
+        if (it == riderTrips.end()) return 0;
+        
+        vector<TripStop>& stops = it->second;
+        for (size_t i = 0; i < stops.size();) {
+            if (stops[i].orderId == orderId && (stops[i].pickup || !pickupOnly)) {
+                stops.erase(stops.begin() + i);
+            } else {
+                i++;
+            }
+        }
+        
+        int remaining = stops.size();
+        if (remaining == 0) riderTrips.erase(it);
+        return remaining;
+    }
+    
+    // The rider's remaining stops. Riders without a planned trip (manual
+    // assignments) get a pickup and drop-off per open order.
+    vector<TripStop> stopsForRider(int riderId) {
+        auto it = riderTrips.find(riderId);
+        if (it != riderTrips.end()) return it->second;
+        
+        vector<TripStop> stops;
+        for (const auto& order : orders) {
+            if (order.getRiderID() != riderId) continue;
+            string status = order.getStatusAsString();
+            if (status == "Delivered" || status == "Cancelled") continue;
+            
+            if (status != "In Transit") {
+                stops.push_back(TripStop(order.getOrderId(), pickupNodeFor(order), true));
+            }
+            stops.push_back(TripStop(order.getOrderId(), order.deliveryLocation, false));
+        }
+        return stops;
+    }
+    
+    // Plans and stores the route for an order: from start through the
+    // rider's stops up to the order's drop-off (just the order's restaurant
+    // and customer if it has no rider yet). Stops off the map are skipped.
+    const StoredRoute* planDeliveryRoute(int orderId, int riderId, int start) {
+        Order* order = findOrder(orderId);
+        if (!order) return nullptr;
+        
+        vector<TripStop> stops;
+        if (riderId != -1) stops = stopsForRider(riderId);
+        bool onTrip = false;
+        for (const auto& stop : stops) {
+            if (stop.orderId == orderId) onTrip = true;
+        }
+        if (!onTrip) {
+            stops.clear();
+            if (order->getStatusAsString() != "In Transit") {
+                stops.push_back(TripStop(orderId, pickupNodeFor(*order), true));
+            }
+            stops.push_back(TripStop(orderId, order->deliveryLocation, false));
+        }
+        
+        vector<int> nodes;
+        int pickupStop = -1;
+        for (const auto& stop : stops) {
+            if (cityGraph.locationExists(stop.node)) {
+                if (stop.orderId == orderId && stop.pickup) pickupStop = nodes.size();
+                nodes.push_back(stop.node);
+            }
+            if (stop.orderId == orderId && !stop.pickup) break;
+        }
+        if (nodes.empty()) return nullptr;
+        
+        return plannedRoutes.plan(orderId, riderId, start, nodes, pickupStop);
+    }
+    
+    void dispatchLoop() {
+        while (running) {
+#ifdef _WIN32
+            Sleep(100);
+#else
+            this_thread::sleep_for(chrono::milliseconds(100));
+#endif
+            // An idle server doesn't contend for dataMutex
+            if (!dispatcher.windowMayHaveElapsed()) continue;
+            
+#ifdef _WIN32
+            LockGuard lock(dataMutex);
+#else
+            lock_guard<mutex> lock(dataMutex);
+#endif
+            if (dispatcher.windowElapsed() && runDispatchCycle() > 0) {
+                markChanged((1 << ORDERS_DATA) | (1 << RIDERS_DATA));
+            }
+        }
+    }
+    
+    // Writes the data files changed since their last checkpoint. The
+    // changed collections are copied together under dataMutex into
+    // buffers kept from the last checkpoint, so the copy allocates little
+    // while the lock is held. The lock is released before any file is
+    // written, and each file is written to a
+    // side file before Database's file lock is taken just for the rename,
+    // so requests go on being served while the files are saved. A file
+    // something else wrote through Database in the meantime is left for
+    // the next checkpoint rather than overwritten with the older copy, but
+    // only MAX_CHECKPOINT_SKIPS times in a row: memory holds every change,
+    // so after that the copy replaces the file anyway. False if any file
+    // was left or failed to write.
+    bool checkpoint() {
+#ifdef _WIN32
+        LockGuard checkpointLock(checkpointMutex);
+#else
+        lock_guard<mutex> checkpointLock(checkpointMutex);
+#endif
+        return checkpointLocked();
+    }
+    
+    // checkpoint() for a caller already holding checkpointMutex
+    bool checkpointLocked() {
+        Database& db = dbManager.getDatabase();
+        uint64_t counts[DATA_FILE_COUNT];
+        uint64_t writesAt[DATA_FILE_COUNT];
+        bool changed[DATA_FILE_COUNT];
+        bool anyChanged = false;
+        {
+#ifdef _WIN32
+            LockGuard lock(dataMutex);
+#else
+            lock_guard<mutex> lock(dataMutex);
+#endif
+            for (int i = 0; i < DATA_FILE_COUNT; i++) {
+                counts[i] = changeCounts[i].load(memory_order_acquire);
+                writesAt[i] = db.getWriteCount(dataFileName(i));
+                changed[i] = counts[i] != savedCounts[i];
+                anyChanged = anyChanged || changed[i];
+            }
+            if (changed[USERS_DATA]) userManager.copyAllUsers(userCopy);
+            if (changed[RESTAURANTS_DATA]) restaurantCopy.assign(restaurants.begin(), restaurants.end());
+            if (changed[ORDERS_DATA]) orderCopy.assign(orders.begin(), orders.end());
+            if (changed[RIDERS_DATA]) {
+                riderCopy.clear();
+                dbManager.getRidersHashTable().traverse([&](int id, Rider& rider) {
+                    riderCopy.push_back(rider);
+                });
+            }
+        }
+        
+        if (!anyChanged) {
+            LOG_DEBUG("Checkpoint: no data changed");
+            return true;
+        }
+        
+        // Users are saved in id order
+        sort(userCopy.begin(), userCopy.end(),
+             [](const UserData& a, const UserData& b) { return a.id < b.id; });
+        
+        const char* names[DATA_FILE_COUNT] = { "users", "restaurants", "orders", "riders" };
+        size_t sizes[DATA_FILE_COUNT] = { userCopy.size(), restaurantCopy.size(), orderCopy.size(), riderCopy.size() };
+        bool complete = true;
+        bool restaurantsSaved = false;
+        
+        for (int i = 0; i < DATA_FILE_COUNT; i++) {
+            if (!changed[i]) continue;
+            
+            // The file is written aside with no lock held; only the rename
+            // into place waits for other writers of the file
+            bool force = checkpointSkips[i] >= MAX_CHECKPOINT_SKIPS;
+            bool current = force || db.getWriteCount(dataFileName(i)) == writesAt[i];
+            bool written = false;
+            if (current) {
+                bool staged;
+                if (i == USERS_DATA) staged = db.stageAllUsers(userCopy);
+                else if (i == RESTAURANTS_DATA) staged = db.stageAllRestaurants(restaurantCopy);
+                else if (i == ORDERS_DATA) staged = db.stageAllOrders(orderCopy);
+                else staged = db.stageAllRiders(riderCopy);
+                written = staged && db.publishStaged(dataFileName(i), writesAt[i], current, force);
+            }
+            
+            if (written) {
+                savedCounts[i] = counts[i];
+                checkpointSkips[i] = 0;
+                if (i == RESTAURANTS_DATA) restaurantsSaved = true;
+                LOG_INFO("Saved " << sizes[i] << " " << names[i] << (force ? " (replaced after repeated skips)" : ""));
+            } else {
+                complete = false;
+                if (!current) {
+                    checkpointSkips[i]++;
+                    LOG_DEBUG("Checkpoint: " << names[i] << " written to since the copy, left for the next one");
+                }
+            }
+        }
+        
+        // restaurants.dat was rewritten; restamp the snapshot so the next
+        // start can use it as it is, unless the catalog has moved on since
+        if (restaurantsSaved) {
+#ifdef _WIN32
+            LockGuard lock(dataMutex);
+#else
+            lock_guard<mutex> lock(dataMutex);
+#endif
+            if (changeCounts[RESTAURANTS_DATA].load(memory_order_acquire) == counts[RESTAURANTS_DATA]) {
+                publishCatalog(db.loadAllMenuItems());
+            }
+        }
+        
+        return complete;
+    }
+    
+    void checkpointLoop() {
+        int waited = 0;
+        while (running) {
+#ifdef _WIN32
+            Sleep(100);
+#else
+            this_thread::sleep_for(chrono::milliseconds(100));
+#endif
+            waited += 100;
+            if (waited < CHECKPOINT_INTERVAL_MS || !running) continue;
+            waited = 0;
+            checkpoint();
+        }
+    }
+    
     string handleGetCityMap() {
         auto locations = cityGraph.getAllLocations();
         
@@ -1884,13 +2936,7 @@ private:
                 if (!first) result += "|";
                 first = false;
                 
-                string restaurantName = "Unknown";
-                for (const auto& r : restaurants) {
-                    if (r.getRestaurantId() == order.getRestaurant()) {
-                        restaurantName = r.getName();
-                        break;
-                    }
-                }
+                string restaurantName = restaurantNameFor(order.getRestaurant());
                 
                 double distance = 2.5 + (order.getOrderId() % 10) * 0.5;
                 
@@ -1906,7 +2952,13 @@ private:
     }
     
     string handleGetRiderOrders(const string& data) {
-        int riderId = stoi(data);
+        size_t pos = data.find('|');
+        int riderId = stoi(data.substr(0, pos));
+        
+        // <rider>|STOPS lists the remaining stops in visiting order instead
+        if (pos != string::npos && data.substr(pos + 1) == "STOPS") {
+            return handleGetRiderStops(riderId);
+        }
         
         string result = "SUCCESS|";
         bool first = true;
@@ -1916,13 +2968,7 @@ private:
                 if (!first) result += "|";
                 first = false;
                 
-                string restaurantName = "Unknown";
-                for (const auto& r : restaurants) {
-                    if (r.getRestaurantId() == order.getRestaurant()) {
-                        restaurantName = r.getName();
-                        break;
-                    }
-                }
+                string restaurantName = restaurantNameFor(order.getRestaurant());
                 
                 string customerName = "Unknown";
                 UserData* customer = userManager.getUser(order.getCustomerId());
@@ -1942,6 +2988,29 @@ private:
         return result;
     }
     
+    // SUCCESS|seq;PICKUP|DROPOFF;orderId;node;place|...
+    string handleGetRiderStops(int riderId) {
+        string result = "SUCCESS|";
+        bool first = true;
+        int seq = 1;
+        
+        for (const auto& stop : stopsForRider(riderId)) {
+            if (!first) result += "|";
+            first = false;
+            
+            string place = cityGraph.locationExists(stop.node)
+                ? cityGraph.getLocationName(stop.node) : "Unknown";
+            
+            result += to_string(seq++) + ";" +
+                     (stop.pickup ? "PICKUP" : "DROPOFF") + ";" +
+                     to_string(stop.orderId) + ";" +
+                     to_string(stop.node) + ";" +
+                     place;
+        }
+        
+        return result;
+    }
+    
     string handleUpdateRiderStatus(const string& data) {
         size_t pos = data.find('|');
         if (pos == string::npos) return "ERROR:Invalid format";
@@ -1965,7 +3034,7 @@ private:
             riderStatistics[riderId].lastActiveTime = time(nullptr);
         }
         
-        cout << "✓ Rider " << riderId << " status: " << newStatus << "\n";
+        LOG_INFO("✓ Rider " << riderId << " status: " << newStatus);
         
         return "SUCCESS";
     }
@@ -1999,62 +3068,76 @@ private:
         return result;
     }
     
+    static string joinNodes(const vector<int>& nodes) {
+        string result;
+        for (size_t i = 0; i < nodes.size(); i++) {
+            if (i > 0) result += ",";
+            result += to_string(nodes[i]);
+        }
+        return result;
+    }
+    
+    // Format: orderId|riderLocation[|alternatives]
+    // Reply:  SUCCESS|TO_RESTAURANT|n,n,..|TO_CUSTOMER|n,n,..
+    // With alternatives > 1, the next-best routes for each leg follow as
+    //         |ALT|TO_RESTAURANT;rank;meters;n,n,..|ALT|TO_CUSTOMER;rank;meters;n,n,..
+    // The route is the one stored at assignment; riderLocation moves the
+    // rider along it and only re-plans if the rider has left it.
     string handleGetDeliveryRoute(const string& data) {
         size_t pos = data.find('|');
         if (pos == string::npos) return "ERROR:Invalid format";
         
         int orderId = stoi(data.substr(0, pos));
-        int riderLocationId = stoi(data.substr(pos + 1));
-        
-        Order* targetOrder = nullptr;
-        for (auto& order : orders) {
-            if (order.getOrderId() == orderId) {
-                targetOrder = &order;
-                break;
-            }
+        size_t altPos = data.find('|', pos + 1);
+        int riderLocationId = stoi(data.substr(pos + 1, altPos == string::npos ? string::npos : altPos - pos - 1));
+        int alternatives = 1;
+        if (altPos != string::npos) {
+            alternatives = max(1, min((int)MAX_ROUTE_ALTERNATIVES, stoi(data.substr(altPos + 1))));
         }
         
+        Order* targetOrder = findOrder(orderId);
         if (!targetOrder) {
             return "ERROR:Order not found";
         }
         
-        int restaurantLoc = 1;
-        for (const auto& r : restaurants) {
-            if (r.getRestaurantId() == targetOrder->getRestaurant()) {
-                restaurantLoc = r.getRestaurantId() % 20;
-                break;
-            }
+        const StoredRoute* route = plannedRoutes.advance(orderId, riderLocationId);
+        if (!route) {
+            route = planDeliveryRoute(orderId, targetOrder->getRiderID(), riderLocationId);
         }
         
-        int customerLoc = (targetOrder->getCustomerId() % 20) + 1;
-        
-        // Get shortest paths using Dijkstra from CityGraph
-        auto pathResult1 = cityGraph.findShortestPath(riderLocationId, restaurantLoc);
-        auto pathResult2 = cityGraph.findShortestPath(restaurantLoc, customerLoc);
-        
-        LinkedList<int> route1 = pathResult1.first;
-        LinkedList<int> route2 = pathResult2.first;
-        
-        string result = "SUCCESS|";
-        
-        result += "TO_RESTAURANT|";
-        auto* current1 = route1.getHead();
-        bool firstNode = true;
-        while (current1 != nullptr) {
-            if (!firstNode) result += ",";
-            result += to_string(current1->data);
-            firstNode = false;
-            current1 = current1->next;
+        vector<int> toRestaurant, toCustomer;
+        if (route) {
+            int pickup = route->pickupIndex();
+            if (route->pickupStop >= 0) {
+                toRestaurant.assign(route->nodes.begin() + route->progress, route->nodes.begin() + pickup + 1);
+            }
+            toCustomer.assign(route->nodes.begin() + pickup, route->nodes.end());
         }
         
-        result += "|TO_CUSTOMER|";
-        auto* current2 = route2.getHead();
-        firstNode = true;
-        while (current2 != nullptr) {
-            if (!firstNode) result += ",";
-            result += to_string(current2->data);
-            firstNode = false;
-            current2 = current2->next;
+        string result = "SUCCESS|";
+        result += "TO_RESTAURANT|" + joinNodes(toRestaurant);
+        result += "|TO_CUSTOMER|" + joinNodes(toCustomer);
+        
+        if (alternatives > 1 && route) {
+            int restaurantLoc = pickupNodeFor(*targetOrder);
+            int customerLoc = dropoffNodeFor(*targetOrder);
+            int legStart = route->nodes[route->progress];
+            
+            if (!toRestaurant.empty()) {
+                vector<RankedRoute> ranked = deliveryRoutes.routes(legStart, restaurantLoc, alternatives);
+                for (size_t i = 1; i < ranked.size(); i++) {
+                    result += "|ALT|TO_RESTAURANT;" + to_string(i + 1) + ";" +
+                              to_string(ranked[i].distance) + ";" + joinNodes(ranked[i].nodes);
+                }
+            }
+            if (customerLoc != -1) {
+                int from = toRestaurant.empty() ? legStart : restaurantLoc;
+                vector<RankedRoute> ranked = deliveryRoutes.routes(from, customerLoc, alternatives);
+                for (size_t i = 1; i < ranked.size(); i++) {
+                    result += "|ALT|TO_CUSTOMER;" + to_string(i + 1) + ";" +
+                              to_string(ranked[i].distance) + ";" + joinNodes(ranked[i].nodes);
+                }
+            }
         }
         
         return result;
@@ -2078,13 +3161,7 @@ private:
             }
             
             // Find restaurant name
-            string restaurantName = "Unknown";
-            for (const auto& r : restaurants) {
-                if (r.getRestaurantId() == order.getRestaurant()) {
-                    restaurantName = r.getName();
-                    break;
-                }
-            }
+            string restaurantName = restaurantNameFor(order.getRestaurant());
             
             // Find rider name
             string riderName = "Unassigned";
@@ -2173,6 +3250,14 @@ private:
         return result;
     }
     
+    // Adds a road and repairs the cached dispatch distances around it
+    void addCityRoad(int from, int to, int distance) {
+        int previous = cityGraph.addRoad(from, to, distance);
+        roadDistances.roadChanged(from, to, previous, distance);
+        deliveryRoutes.roadChanged();
+        plannedRoutes.roadChanged(from, to, previous, distance);
+    }
+    
     string handleAddRestaurant(const string& data) {
     // Parse: name|cuisine|address|rating|deliveryTime
     vector<string> parts;
@@ -2214,29 +3299,30 @@ private:
         
         // === STEP 2: Add to City Graph ===
         string locationName = parts[0] + " Area";
-        cout << "✓ Adding restaurant to city graph: " 
-             << parts[0] << " at node " << locationNodeId << "\n";
+        LOG_INFO("✓ Adding restaurant to city graph: " 
+             << parts[0] << " at node " << locationNodeId);
         
         // Add the location node
         cityGraph.addLocation(locationNodeId, locationName, "restaurant");
+        responseCache.invalidate(ResponseCache::CITY_MAP);
         
         // === STEP 3: Connect to existing network ===
-        cout << "  Connecting to existing network...\n";
+        LOG_DEBUG("  Connecting to existing network...");
         
         // Method 1: Connect to nearest existing restaurant
         int nearestRestaurant = cityGraph.findNearestNode(locationNodeId, "restaurant");
         if (nearestRestaurant != -1) {
             int distance = 600 + (rand() % 400); // 600-1000m
-            cityGraph.addRoad(locationNodeId, nearestRestaurant, distance);
-            cout << "  Connected to nearest restaurant [" << nearestRestaurant 
-                 << "] - " << distance << "m\n";
+            addCityRoad(locationNodeId, nearestRestaurant, distance);
+            LOG_DEBUG("  Connected to nearest restaurant [" << nearestRestaurant 
+                 << "] - " << distance << "m");
         }
         
         // Method 2: Connect to city center (node 400 if exists)
         if (cityGraph.locationExists(400)) {
             int distance = 800 + (rand() % 400); // 800-1200m
-            cityGraph.addRoad(locationNodeId, 400, distance);
-            cout << "  Connected to City Center [400] - " << distance << "m\n";
+            addCityRoad(locationNodeId, 400, distance);
+            LOG_DEBUG("  Connected to City Center [400] - " << distance << "m");
         }
         
         // Method 3: Connect to a random customer district
@@ -2251,25 +3337,25 @@ private:
         if (!customerDistricts.empty()) {
             int randomDistrict = customerDistricts[rand() % customerDistricts.size()];
             int distance = 1000 + (rand() % 500); // 1000-1500m
-            cityGraph.addRoad(locationNodeId, randomDistrict, distance);
-            cout << "  Connected to Customer District [" << randomDistrict 
-                 << "] - " << distance << "m\n";
+            addCityRoad(locationNodeId, randomDistrict, distance);
+            LOG_DEBUG("  Connected to Customer District [" << randomDistrict 
+                 << "] - " << distance << "m");
         }
         
         // === STEP 4: Save the graph ===
         cityGraph.saveToDatabase();
-        cout << "✓ City graph updated and saved\n";
+        LOG_INFO("✓ City graph updated and saved");
         
         // === STEP 5: Create and save restaurant ===
         Restaurant newRestaurant(newId, parts[0], parts[1], parts[2], rating, deliveryTime);
+        newRestaurant.setLocationNode(locationNodeId);
         
         restaurants.push_back(newRestaurant);
+        restaurantIndex.rebuild(restaurants);
+        publishCatalog(dbManager.getDatabase().loadAllMenuItems());
         
-        // Save to database
-        dbManager.getDatabase().saveRestaurant(newRestaurant);
-        
-        cout << "✓ New restaurant added: " << parts[0] 
-             << " (ID: " << newId << ", Location Node: " << locationNodeId << ")\n";
+        LOG_INFO("✓ New restaurant added: " << parts[0] 
+             << " (ID: " << newId << ", Location Node: " << locationNodeId << ")");
         
         return "SUCCESS|" + to_string(newId);
         
@@ -2288,15 +3374,11 @@ private:
                 });
             
             if (it != restaurants.end()) {
-                // Remove from database first
-                if (dbManager.getDatabase().deleteRestaurant(restaurantId)) {
-                    // Then remove from local vector
-                    restaurants.erase(it);
-                    cout << "✓ Restaurant removed: ID " << restaurantId << "\n";
-                    return "SUCCESS";
-                } else {
-                    return "ERROR:Failed to delete from database";
-                }
+                restaurants.erase(it);
+                restaurantIndex.rebuild(restaurants);
+                publishCatalog(dbManager.getDatabase().loadAllMenuItems());
+                LOG_INFO("✓ Restaurant removed: ID " << restaurantId);
+                return "SUCCESS";
             }
             return "ERROR:Restaurant not found";
         } catch (const exception& e) {
@@ -2322,15 +3404,8 @@ private:
         int stock = stoi(parts[4]);
         
         // Check if restaurant exists
-        bool restaurantExists = false;
-        for (const auto& restaurant : restaurants) {
-            if (restaurant.getRestaurantId() == restaurantId) {
-                restaurantExists = true;
-                break;
-            }
-        }
-        
-        if (!restaurantExists) {
+        int slot = restaurantIndex.slotOf(restaurantId);
+        if (slot < 0) {
             return "ERROR:Restaurant not found";
         }
         
@@ -2346,14 +3421,11 @@ private:
         dbManager.getDatabase().saveMenuItem(newItem);
         
         // Update local restaurant's menu
-        for (auto& restaurant : restaurants) {
-            if (restaurant.getRestaurantId() == restaurantId) {
-                restaurant.addMenuItemId(newId);
-                break;
-            }
-        }
+        restaurants[slot].addMenuItemId(newId);
+        allItems.push_back(newItem);
+        publishCatalog(allItems);
         
-        cout << "✓ New menu item added: " << parts[1] << " (ID: " << newId << ")\n";
+        LOG_INFO("✓ New menu item added: " << parts[1] << " (ID: " << newId << ")");
         return "SUCCESS|" + to_string(newId);
     } catch (const exception& e) {
         return "ERROR:" + string(e.what());
@@ -2372,14 +3444,13 @@ private:
             // Remove from database
             if (dbManager.getDatabase().deleteMenuItem(itemId)) {
                 // Update local restaurant
-                for (auto& restaurant : restaurants) {
-                    if (restaurant.getRestaurantId() == restaurantId) {
-                        restaurant.removeMenuItemId(itemId);
-                        break;
-                    }
+                int slot = restaurantIndex.slotOf(restaurantId);
+                if (slot >= 0) {
+                    restaurants[slot].removeMenuItemId(itemId);
                 }
+                publishCatalog(dbManager.getDatabase().loadAllMenuItems());
                 
-                cout << "✓ Menu item removed: ID " << itemId << "\n";
+                LOG_INFO("✓ Menu item removed: ID " << itemId);
                 return "SUCCESS";
             } else {
                 return "ERROR:Failed to delete from database";
@@ -2408,12 +3479,8 @@ private:
                 return "ERROR:Email already registered";
             }
             
-            // Generate new IDs
-            vector<UserData> allUsers = dbManager.getDatabase().loadAllUsers();
-            vector<Rider> allRiders = dbManager.getDatabase().loadAllRiders();
-            
-            int userId = allUsers.empty() ? 100 : allUsers.back().id + 1;
-            int riderId = allRiders.empty() ? 100 : allRiders.back().getId() + 1;
+            int userId = nextFreeUserId();
+            int riderId = nextFreeRiderId();
             
             // 1. Create user account
             bool userSuccess = userManager.registerUser(userId, parts[0], parts[1], parts[2], 
@@ -2423,15 +3490,10 @@ private:
                 return "ERROR:Failed to create user account";
             }
             
-            UserData newUser(userId, parts[0], parts[1], parts[2], 
-                            "rider", parts[4], parts[3]);
-            dbManager.getDatabase().saveUser(newUser);
-            
             // 2. Create rider profile
             Rider newRider(riderId, parts[0], parts[1], parts[3], 
                           parts[2], parts[5], 4.5);
             newRider.setStatus("Active");
-            dbManager.getDatabase().saveRider(newRider);
             dbManager.getRidersHashTable().insertItem(riderId, newRider);
             
             // Initialize rider stats
@@ -2441,8 +3503,8 @@ private:
             riderStatistics[riderId] = stats;
             riderStatus[riderId] = "Active";
             
-            cout << "✓ New rider added: " << parts[0] 
-                 << " (User ID: " << userId << ", Rider ID: " << riderId << ")\n";
+            LOG_INFO("✓ New rider added: " << parts[0] 
+                 << " (User ID: " << userId << ", Rider ID: " << riderId << ")");
             return "SUCCESS|" + to_string(riderId);
         } catch (const exception& e) {
             return "ERROR:" + string(e.what());
@@ -2458,33 +3520,19 @@ private:
             return "ERROR:Rider not found";
         }
         
-        // Remove from database
-        if (dbManager.getDatabase().deleteRider(riderId)) {
-            // Remove from hash table
-            dbManager.getRidersHashTable().removeItem(riderId);
-            
-            // Remove from stats tracking
-            riderStatus.erase(riderId);
-            riderStatistics.erase(riderId);
-            
-            // Don't delete user account - change role to customer using UserManager
-            UserData* user = userManager.getUser(riderId);
-            if (user) {
-                // FIXED: Use UserManager to update role instead of direct assignment
-                userManager.updateUserRole(riderId, "customer");
-                
-                // Save the updated user to database
-                UserData* updatedUser = userManager.getUser(riderId);
-                if (updatedUser) {
-                    dbManager.getDatabase().saveUser(*updatedUser);
-                }
-            }
-            
-            cout << "✓ Rider removed: ID " << riderId << "\n";
-            return "SUCCESS";
-        } else {
-            return "ERROR:Failed to delete from database";
+        dbManager.getRidersHashTable().removeItem(riderId);
+        
+        // Remove from stats tracking
+        riderStatus.erase(riderId);
+        riderStatistics.erase(riderId);
+        
+        // Don't delete user account - change role to customer using UserManager
+        if (userManager.getUser(riderId)) {
+            userManager.updateUserRole(riderId, "customer");
         }
+        
+        LOG_INFO("✓ Rider removed: ID " << riderId);
+        return "SUCCESS";
     } catch (const exception& e) {
         return "ERROR:" + string(e.what());
     }
@@ -2518,25 +3566,14 @@ private:
             return "ERROR:Failed to update user role";
         }
         
-        // Get updated user data
-        UserData* updatedUser = userManager.getUser(userId);
-        if (updatedUser) {
-            // Save to database using the updated user
-            dbManager.getDatabase().saveUser(*updatedUser);
-        } else {
-            return "ERROR:Failed to get updated user data";
-        }
-        
         // If changing to/from rider, update rider table
         if (newRole == "rider" && oldRole != "rider") {
             // Create rider entry
-            vector<Rider> allRiders = dbManager.getDatabase().loadAllRiders();
-            int riderId = allRiders.empty() ? 100 : allRiders.back().getId() + 1;
+            int riderId = nextFreeRiderId();
             
             Rider newRider(riderId, user->getName(), user->getEmail(), 
                           user->getPassword(), user->getPhone(), "Bike", 4.5);
             newRider.setStatus("Active");
-            dbManager.getDatabase().saveRider(newRider);
             dbManager.getRidersHashTable().insertItem(riderId, newRider);
             
             // Initialize rider stats
@@ -2547,7 +3584,6 @@ private:
             riderStatus[riderId] = "Active";
         } else if (oldRole == "rider" && newRole != "rider") {
             // Remove rider entry
-            dbManager.getDatabase().deleteRider(userId);
             dbManager.getRidersHashTable().removeItem(userId);
             
             // Remove from stats tracking
@@ -2555,8 +3591,8 @@ private:
             riderStatistics.erase(userId);
         }
         
-        cout << "✓ User role changed: ID " << userId 
-             << " from " << oldRole << " to " << newRole << "\n";
+        LOG_INFO("✓ User role changed: ID " << userId 
+             << " from " << oldRole << " to " << newRole);
         return "SUCCESS";
     } catch (const exception& e) {
         return "ERROR:" + string(e.what());
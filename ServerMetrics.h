@@ -0,0 +1,392 @@
+// ServerMetrics.h - Request counters and latency histograms for QuickBiteServer
+#ifndef SERVER_METRICS_H
+#define SERVER_METRICS_H
+
+#include <string>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <cstdint>
+
+using namespace std;
+
+// Commands tracked individually; anything else is counted as OTHER
+static const char* const METRIC_COMMANDS[] = {
+    "LOGIN", "REGISTER", "GET_RESTAURANTS", "GET_MENU", "PLACE_ORDER",
+    "GET_ORDERS", "GET_RIDERS", "UPDATE_ORDER_STATUS", "ASSIGN_RIDER",
+    "GET_CITY_MAP", "GET_AVAILABLE_ORDERS", "GET_RIDER_ORDERS",
+    "UPDATE_RIDER_STATUS", "GET_RIDER_STATS", "GET_DELIVERY_ROUTE",
+    "GET_ALL_ORDERS", "GET_ALL_USERS", "GET_SYSTEM_STATS", "ADD_RESTAURANT",
+    "REMOVE_RESTAURANT", "ADD_MENU_ITEM", "REMOVE_MENU_ITEM", "ADD_RIDER",
+    "REMOVE_RIDER", "CHANGE_USER_ROLE", "RUN_DISPATCH", "PING", "BATCH", "GET_METRICS",
+    "JSON", "OTHER"
+};
+static const int METRIC_COMMAND_COUNT = sizeof(METRIC_COMMANDS) / sizeof(METRIC_COMMANDS[0]);
+
+// Log-linear latency buckets in microseconds (HDR-style): exact below
+// 32us, then 16 sub-buckets per power of two (~6% relative error) up
+// to about 19 hours.
+struct LatencyBuckets {
+    static const int LINEAR_LIMIT = 32;
+    static const int SUB_BUCKETS = 16;
+    static const int BUCKET_COUNT = LINEAR_LIMIT + 32 * SUB_BUCKETS;
+
+    static int indexFor(uint64_t micros) {
+        if (micros < (uint64_t)LINEAR_LIMIT) return (int)micros;
+
+        int msb = 0;
+        while ((micros >> (msb + 1)) != 0) msb++;
+
+        int index = LINEAR_LIMIT + (msb - 5) * SUB_BUCKETS +
+                    (int)((micros >> (msb - 4)) - SUB_BUCKETS);
+        return min(index, BUCKET_COUNT - 1);
+    }
+
+    static uint64_t upperBound(int index) {
+        if (index < LINEAR_LIMIT) return index;
+
+        int offset = index - LINEAR_LIMIT;
+        int msb = offset / SUB_BUCKETS + 5;
+        uint64_t width = (uint64_t)1 << (msb - 4);
+        return (SUB_BUCKETS + offset % SUB_BUCKETS) * width + width - 1;
+    }
+};
+
+// Written by exactly one thread, read by any. Updates are relaxed
+// load+store pairs rather than read-modify-write, so recording costs
+// no locked instructions; readers may see a value a moment stale.
+class LatencyHistogram {
+private:
+    atomic<uint64_t> buckets[LatencyBuckets::BUCKET_COUNT];
+    atomic<uint64_t> count;
+    atomic<uint64_t> sum;
+    atomic<uint64_t> maxValue;
+
+    static void bump(atomic<uint64_t>& counter, uint64_t delta) {
+        counter.store(counter.load(memory_order_relaxed) + delta, memory_order_relaxed);
+    }
+
+public:
+    LatencyHistogram() : count(0), sum(0), maxValue(0) {
+        for (auto& bucket : buckets) bucket.store(0, memory_order_relaxed);
+    }
+
+    void record(uint64_t micros) {
+        bump(buckets[LatencyBuckets::indexFor(micros)], 1);
+        bump(count, 1);
+        bump(sum, micros);
+        if (micros > maxValue.load(memory_order_relaxed)) {
+            maxValue.store(micros, memory_order_relaxed);
+        }
+    }
+
+    friend struct HistogramSnapshot;
+};
+
+// Plain copy of one or more merged histograms, used for reporting
+struct HistogramSnapshot {
+    vector<uint64_t> buckets;
+    uint64_t count;
+    uint64_t sum;
+    uint64_t maxValue;
+
+    HistogramSnapshot() : buckets(LatencyBuckets::BUCKET_COUNT, 0), count(0), sum(0), maxValue(0) {}
+
+    void merge(const LatencyHistogram& histogram) {
+        for (int i = 0; i < LatencyBuckets::BUCKET_COUNT; i++) {
+            buckets[i] += histogram.buckets[i].load(memory_order_relaxed);
+        }
+        count += histogram.count.load(memory_order_relaxed);
+        sum += histogram.sum.load(memory_order_relaxed);
+        maxValue = max(maxValue, histogram.maxValue.load(memory_order_relaxed));
+    }
+
+    uint64_t percentile(double p) const {
+        if (count == 0) return 0;
+
+        uint64_t target = (uint64_t)(p / 100.0 * count);
+        if (target >= count) target = count - 1;
+
+        uint64_t seen = 0;
+        for (int i = 0; i < LatencyBuckets::BUCKET_COUNT; i++) {
+            seen += buckets[i];
+            if (seen > target) return min(LatencyBuckets::upperBound(i), maxValue);
+        }
+        return maxValue;
+    }
+
+    double mean() const { return count > 0 ? (double)sum / count : 0.0; }
+};
+
+// Per-connection slice of the metrics. Only the handler thread that owns
+// it writes to it; command histograms are allocated on first use so an
+// idle connection costs a few hundred bytes.
+struct MetricsShard {
+    atomic<LatencyHistogram*> commandLatency[METRIC_COMMAND_COUNT];
+    atomic<uint64_t> commandErrors[METRIC_COMMAND_COUNT];
+    LatencyHistogram lockWait;
+    LatencyHistogram lockHold;
+    atomic<uint64_t> bytesReceived;
+    atomic<uint64_t> bytesSent;
+    bool inUse;
+
+    MetricsShard() : bytesReceived(0), bytesSent(0), inUse(false) {
+        for (int i = 0; i < METRIC_COMMAND_COUNT; i++) {
+            commandLatency[i].store(nullptr, memory_order_relaxed);
+            commandErrors[i].store(0, memory_order_relaxed);
+        }
+    }
+
+    ~MetricsShard() {
+        for (int i = 0; i < METRIC_COMMAND_COUNT; i++) {
+            delete commandLatency[i].load(memory_order_relaxed);
+        }
+    }
+
+    static void bump(atomic<uint64_t>& counter, uint64_t delta) {
+        counter.store(counter.load(memory_order_relaxed) + delta, memory_order_relaxed);
+    }
+
+    void recordCommand(int commandIndex, uint64_t micros, bool failed) {
+        LatencyHistogram* histogram = commandLatency[commandIndex].load(memory_order_relaxed);
+        if (!histogram) {
+            histogram = new LatencyHistogram();
+            commandLatency[commandIndex].store(histogram, memory_order_release);
+        }
+        histogram->record(micros);
+        if (failed) bump(commandErrors[commandIndex], 1);
+    }
+};
+
+class ServerMetrics {
+private:
+    vector<MetricsShard*> shards;
+    atomic_flag registryLock;        // guards shards; taken on connect/disconnect only
+    chrono::steady_clock::time_point startTime;
+
+    void lockRegistry() { while (registryLock.test_and_set(memory_order_acquire)) {} }
+    void unlockRegistry() { registryLock.clear(memory_order_release); }
+
+    static MetricsShard*& threadShard() {
+        static thread_local MetricsShard* shard = nullptr;
+        return shard;
+    }
+
+    static string formatSeconds(uint64_t micros) {
+        ostringstream out;
+        out << setprecision(6) << fixed << micros / 1e6;
+        return out.str();
+    }
+
+public:
+    // Gauges, updated with atomic read-modify-write since several threads share them
+    atomic<int> connectedClients;
+    atomic<int> lockWaiters;         // requests queued on dataMutex
+    atomic<int> pendingFrames;       // received frames not yet processed
+
+    ServerMetrics() : startTime(chrono::steady_clock::now()),
+                      connectedClients(0), lockWaiters(0), pendingFrames(0) {
+        registryLock.clear();
+    }
+
+    ~ServerMetrics() {
+        for (auto* shard : shards) delete shard;
+    }
+
+    static uint64_t nowMicros() {
+        return (uint64_t)chrono::duration_cast<chrono::microseconds>(
+            chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    static int commandIndex(const string& command) {
+        for (int i = 0; i < METRIC_COMMAND_COUNT - 1; i++) {
+            if (command == METRIC_COMMANDS[i]) return i;
+        }
+        return METRIC_COMMAND_COUNT - 1;
+    }
+
+    // Binds a shard to the calling handler thread; released on disconnect
+    // and reused by the next connection so totals keep accumulating.
+    void attachThread() {
+        lockRegistry();
+        MetricsShard* shard = nullptr;
+        for (auto* candidate : shards) {
+            if (!candidate->inUse) { shard = candidate; break; }
+        }
+        if (!shard) {
+            shard = new MetricsShard();
+            shards.push_back(shard);
+        }
+        shard->inUse = true;
+        unlockRegistry();
+
+        threadShard() = shard;
+    }
+
+    void detachThread() {
+        MetricsShard* shard = threadShard();
+        if (!shard) return;
+
+        lockRegistry();
+        shard->inUse = false;
+        unlockRegistry();
+        threadShard() = nullptr;
+    }
+
+    // Shard of the calling thread; threads that never attached get one on first use
+    MetricsShard& local() {
+        if (!threadShard()) attachThread();
+        return *threadShard();
+    }
+
+    // === REPORTING ===
+
+    struct Totals {
+        HistogramSnapshot commandLatency[METRIC_COMMAND_COUNT];
+        uint64_t commandErrors[METRIC_COMMAND_COUNT];
+        HistogramSnapshot lockWait;
+        HistogramSnapshot lockHold;
+        uint64_t bytesReceived;
+        uint64_t bytesSent;
+    };
+
+    void collect(Totals& totals) {
+        for (int i = 0; i < METRIC_COMMAND_COUNT; i++) totals.commandErrors[i] = 0;
+        totals.bytesReceived = 0;
+        totals.bytesSent = 0;
+
+        lockRegistry();
+        vector<MetricsShard*> snapshot = shards;
+        unlockRegistry();
+
+        for (auto* shard : snapshot) {
+            for (int i = 0; i < METRIC_COMMAND_COUNT; i++) {
+                LatencyHistogram* histogram = shard->commandLatency[i].load(memory_order_acquire);
+                if (histogram) totals.commandLatency[i].merge(*histogram);
+                totals.commandErrors[i] += shard->commandErrors[i].load(memory_order_relaxed);
+            }
+            totals.lockWait.merge(shard->lockWait);
+            totals.lockHold.merge(shard->lockHold);
+            totals.bytesReceived += shard->bytesReceived.load(memory_order_relaxed);
+            totals.bytesSent += shard->bytesSent.load(memory_order_relaxed);
+        }
+    }
+
+    double uptimeSeconds() const {
+        return chrono::duration_cast<chrono::milliseconds>(
+            chrono::steady_clock::now() - startTime).count() / 1000.0;
+    }
+
+    // GET_METRICS payload:
+    //   uptime;requests;errors;bytesIn;bytesOut;lockWaitP99us;lockHoldP99us;lockWaiters;pendingFrames;clients
+    //   |COMMAND;count;errors;meanUs;p50us;p99us;p999us;maxUs|...
+    string formatSummary() {
+        Totals totals;
+        collect(totals);
+
+        uint64_t requests = 0, errors = 0;
+        for (int i = 0; i < METRIC_COMMAND_COUNT; i++) {
+            requests += totals.commandLatency[i].count;
+            errors += totals.commandErrors[i];
+        }
+
+        ostringstream out;
+        out << fixed << setprecision(1) << uptimeSeconds() << ";"
+            << requests << ";" << errors << ";"
+            << totals.bytesReceived << ";" << totals.bytesSent << ";"
+            << totals.lockWait.percentile(99) << ";" << totals.lockHold.percentile(99) << ";"
+            << lockWaiters.load() << ";" << pendingFrames.load() << ";" << connectedClients.load();
+
+        for (int i = 0; i < METRIC_COMMAND_COUNT; i++) {
+            const HistogramSnapshot& h = totals.commandLatency[i];
+            if (h.count == 0) continue;
+
+            out << "|" << METRIC_COMMANDS[i] << ";" << h.count << ";" << totals.commandErrors[i] << ";"
+                << setprecision(1) << h.mean() << ";" << h.percentile(50) << ";"
+                << h.percentile(99) << ";" << h.percentile(99.9) << ";" << h.maxValue;
+        }
+
+        return out.str();
+    }
+
+    // Prometheus text exposition format (version 0.0.4)
+    string formatPrometheus() {
+        Totals totals;
+        collect(totals);
+
+        ostringstream out;
+
+        out << "# HELP quickbite_requests_total Requests handled, by command.\n"
+            << "# TYPE quickbite_requests_total counter\n";
+        for (int i = 0; i < METRIC_COMMAND_COUNT; i++) {
+            out << "quickbite_requests_total{command=\"" << METRIC_COMMANDS[i] << "\"} "
+                << totals.commandLatency[i].count << "\n";
+        }
+
+        out << "# HELP quickbite_request_errors_total Requests answered with ERROR, by command.\n"
+            << "# TYPE quickbite_request_errors_total counter\n";
+        for (int i = 0; i < METRIC_COMMAND_COUNT; i++) {
+            out << "quickbite_request_errors_total{command=\"" << METRIC_COMMANDS[i] << "\"} "
+                << totals.commandErrors[i] << "\n";
+        }
+
+        out << "# HELP quickbite_request_duration_seconds Time from dispatch to response, by command.\n"
+            << "# TYPE quickbite_request_duration_seconds summary\n";
+        for (int i = 0; i < METRIC_COMMAND_COUNT; i++) {
+            const HistogramSnapshot& h = totals.commandLatency[i];
+            if (h.count == 0) continue;
+            writeSummary(out, "quickbite_request_duration_seconds",
+                         string("command=\"") + METRIC_COMMANDS[i] + "\"", h);
+        }
+
+        out << "# HELP quickbite_data_lock_wait_seconds Time spent waiting to acquire dataMutex.\n"
+            << "# TYPE quickbite_data_lock_wait_seconds summary\n";
+        writeSummary(out, "quickbite_data_lock_wait_seconds", "", totals.lockWait);
+
+        out << "# HELP quickbite_data_lock_hold_seconds Time dataMutex was held per request.\n"
+            << "# TYPE quickbite_data_lock_hold_seconds summary\n";
+        writeSummary(out, "quickbite_data_lock_hold_seconds", "", totals.lockHold);
+
+        out << "# HELP quickbite_received_bytes_total Bytes read from client sockets.\n"
+            << "# TYPE quickbite_received_bytes_total counter\n"
+            << "quickbite_received_bytes_total " << totals.bytesReceived << "\n"
+            << "# HELP quickbite_sent_bytes_total Bytes written to client sockets.\n"
+            << "# TYPE quickbite_sent_bytes_total counter\n"
+            << "quickbite_sent_bytes_total " << totals.bytesSent << "\n"
+            << "# HELP quickbite_data_lock_waiters Requests currently waiting for dataMutex.\n"
+            << "# TYPE quickbite_data_lock_waiters gauge\n"
+            << "quickbite_data_lock_waiters " << lockWaiters.load() << "\n"
+            << "# HELP quickbite_pending_frames Received request frames not yet processed.\n"
+            << "# TYPE quickbite_pending_frames gauge\n"
+            << "quickbite_pending_frames " << pendingFrames.load() << "\n"
+            << "# HELP quickbite_connected_clients Open client connections.\n"
+            << "# TYPE quickbite_connected_clients gauge\n"
+            << "quickbite_connected_clients " << connectedClients.load() << "\n"
+            << "# HELP quickbite_uptime_seconds Seconds since the server started.\n"
+            << "# TYPE quickbite_uptime_seconds gauge\n"
+            << "quickbite_uptime_seconds " << fixed << setprecision(1) << uptimeSeconds() << "\n";
+
+        return out.str();
+    }
+
+private:
+    static void writeSummary(ostringstream& out, const string& name, const string& labels,
+                             const HistogramSnapshot& h) {
+        const double quantiles[] = {0.5, 0.9, 0.99, 0.999};
+        string prefix = labels.empty() ? "" : labels + ",";
+
+        for (double q : quantiles) {
+            out << name << "{" << prefix << "quantile=\"" << q << "\"} "
+                << formatSeconds(h.percentile(q * 100)) << "\n";
+        }
+        out << name << "_sum" << (labels.empty() ? "" : "{" + labels + "}") << " "
+            << formatSeconds(h.sum) << "\n";
+        out << name << "_count" << (labels.empty() ? "" : "{" + labels + "}") << " "
+            << h.count << "\n";
+    }
+};
+
+#endif // SERVER_METRICS_H
@@ -8,6 +8,7 @@
 #include <map>
 #include <iomanip>
 #include <ctime>
+#include <future>
 using namespace std;
 
 QuickBiteClient client;
@@ -679,19 +680,46 @@ void manageRiders() {
             }
             case 2: {
                 int riderId;
-                cout << "\nEnter Rider ID: ";
+                cout << "\nEnter Rider ID (0 for all riders): ";
                 cin >> riderId;
                 cin.ignore();
                 
-                string data = to_string(riderId);
-                string response = client.sendCommand("GET_RIDER_STATS", data);
+                // Every rider's stats are fetched in one BATCH request
+                vector<int> riderIds;
+                if (riderId == 0) {
+                    for (const auto& rider : client.getRiders()) {
+                        size_t semi = rider.find(';');
+                        if (semi != string::npos) {
+                            riderIds.push_back(stoi(rider.substr(0, semi)));
+                        }
+                    }
+                } else {
+                    riderIds.push_back(riderId);
+                }
+                
+                vector<pair<string, string>> commands;
+                for (int id : riderIds) {
+                    commands.push_back({"GET_RIDER_STATS", to_string(id)});
+                }
+                vector<string> responses = client.sendBatch(commands);
                 
                 clearScreen();
                 cout << "========================================\n";
                 cout << "         RIDER STATISTICS              \n";
                 cout << "========================================\n";
                 
-                if (response.substr(0, 7) == "SUCCESS") {
+                if (riderIds.empty()) {
+                    cout << "\n✗ No riders in the system.\n";
+                }
+                
+                for (size_t i = 0; i < riderIds.size(); i++) {
+                    const string& response = responses[i];
+                    
+                    if (response.substr(0, 7) != "SUCCESS") {
+                        cout << "\n✗ Failed to retrieve statistics for rider " << riderIds[i] << ".\n";
+                        continue;
+                    }
+                    
                     string statsData = response.substr(8);
                     
                     vector<string> stats;
@@ -707,7 +735,7 @@ void manageRiders() {
                     
                     if (stats.size() >= 6) {
                         cout << "\n┌─────────────────────────────────────┐\n";
-                        cout << "│ Rider ID: " << riderId << "\n";
+                        cout << "│ Rider ID: " << riderIds[i] << "\n";
                         cout << "├─────────────────────────────────────┤\n";
                         cout << "│ Total Deliveries: " << stats[0] << "\n";
                         cout << "│ Today's Deliveries: " << stats[1] << "\n";
@@ -717,8 +745,6 @@ void manageRiders() {
                         cout << "│ Total Earnings: $" << stats[5] << "\n";
                         cout << "└─────────────────────────────────────┘\n";
                     }
-                } else {
-                    cout << "\n✗ Failed to retrieve rider statistics.\n";
                 }
                 
                 pauseScreen();
@@ -1128,11 +1154,17 @@ void assignRiderToOrder() {
         return;
     }
     
-    cout << "\nEnter Rider ID: ";
+    cout << "\nEnter Rider ID (0 for automatic dispatch): ";
     cin >> riderId;
     cin.ignore();
     
-    if (client.assignRider(orderId, riderId)) {
+    if (riderId == 0) {
+        if (client.requestAutoDispatch(orderId)) {
+            cout << "\n✓ Order queued; nearest rider will be assigned shortly.\n";
+        } else {
+            cout << "\n✗ Failed to queue order for dispatch!\n";
+        }
+    } else if (client.assignRider(orderId, riderId)) {
         cout << "\n✓ Rider assigned successfully!\n";
     } else {
         cout << "\n✗ Failed to assign rider!\n";
@@ -1244,7 +1276,31 @@ void viewSystemStatistics() {
     cout << "       SYSTEM STATISTICS               \n";
     cout << "========================================\n";
     
-    string response = client.sendCommand("GET_SYSTEM_STATS");
+    // Both queries go out in one flush instead of two round trips
+    int activeRiders = 0, busyRiders = 0;
+    future<string> statsResponse = client.sendCommandAsync("GET_SYSTEM_STATS");
+    client.sendCommandAsync("GET_RIDERS", "", [&](const string& ridersResponse) {
+        if (ridersResponse.substr(0, 7) != "SUCCESS") return;
+        
+        string riders = ridersResponse.substr(8);
+        size_t start = 0;
+        while (start < riders.length()) {
+            size_t end = riders.find('|', start);
+            if (end == string::npos) end = riders.length();
+            
+            string rider = riders.substr(start, end - start);
+            size_t semi = rider.rfind(';');
+            if (semi != string::npos) {
+                string status = rider.substr(semi + 1);
+                if (status == "Active") activeRiders++;
+                else if (status == "Busy") busyRiders++;
+            }
+            start = end + 1;
+        }
+    });
+    client.awaitResponses();
+    
+    string response = statsResponse.get();
     
     if (response.substr(0, 7) == "SUCCESS") {
         string data = response.substr(8);
@@ -1319,6 +1375,7 @@ void viewSystemStatistics() {
                 
                 cout << "│ Rider/Customer Ratio: 1:" << fixed << setprecision(1) << riderToCustomerRatio << "\n";
                 cout << "│ Orders/Restaurant: " << fixed << setprecision(1) << ordersPerRestaurant << "\n";
+                cout << "│ Riders On Duty: " << activeRiders << " active, " << busyRiders << " busy\n";
                 
                 cout << "│ ─────────────────────────────────── │\n";
                 
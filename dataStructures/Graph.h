@@ -5,7 +5,9 @@
 #include <iostream>
 #include <climits>
 #include <vector>
+#include <functional>
 #include "LinkedList.h"
+#include "IndexedPriorityQueue.h"
 
 using namespace std;
 
@@ -32,6 +34,16 @@ private:
     LinkedList<Edge>* adjacencyList;
     bool* nodeExists;
     
+    // Reusable buffers for expandFrom(); dist is all INT_MAX between searches
+    struct SearchScratch {
+        vector<int> dist;
+        vector<int> touched;
+        IndexedPriorityQueue<int> frontier;
+        bool inUse;
+        
+        SearchScratch() : inUse(false) {}
+    };
+    
 public:
     Graph(int maxN = 500) : maxNodes(maxN) {
         adjacencyList = new LinkedList<Edge>[maxNodes];
@@ -91,6 +103,15 @@ public:
         }
     }
     
+    // Node ids run from 0 to getMaxNodes() - 1
+    int getMaxNodes() const {
+        return maxNodes;
+    }
+    
+    bool hasNode(int nodeId) const {
+        return nodeId >= 0 && nodeId < maxNodes && nodeExists[nodeId];
+    }
+    
     LinkedList<int> getAllNodes() const {
         LinkedList<int> nodes;
         for (int i = 0; i < maxNodes; i++) {
@@ -175,6 +196,16 @@ public:
         return -1; // Edge doesn't exist
     }
     
+    // Calls visit(destination, weight) for every road leaving node
+    void forEachEdge(int node, const function<void(int, int)>& visit) const {
+        if (node < 0 || node >= maxNodes || !nodeExists[node]) return;
+        Node<Edge>* current = adjacencyList[node].getHead();
+        while (current != nullptr) {
+            visit(current->data.destination, current->data.weight);
+            current = current->next;
+        }
+    }
+    
     bool hasEdge(int from, int to) const {
         if (from >= 0 && from < maxNodes && to >= 0 && to < maxNodes) {
             Node<Edge>* current = adjacencyList[from].getHead();
@@ -287,6 +318,59 @@ public:
         return path;
     }
     
+    // Settles nodes in increasing road distance from start and calls
+    // visit(node, distance) for each one; stops as soon as visit returns
+    // true or the next node is further than maxDistance. Lets callers run
+    // one search for "nearest of many targets" instead of one per target.
+    //
+    // Each thread reuses one set of search buffers, and only the entries a
+    // search touched are reset afterwards, so repeated searches (dispatch
+    // runs one per order or stop, often on several threads) don't allocate
+    // or clear a full distance array every time.
+    void expandFrom(int start, const function<bool(int, int)>& visit,
+                    int maxDistance = INT_MAX) const {
+        if (start < 0 || start >= maxNodes || !nodeExists[start]) return;
+        
+        static thread_local SearchScratch threadScratch;
+        SearchScratch nestedScratch;
+        // A visit callback that starts another search gets its own buffers
+        SearchScratch& scratch = threadScratch.inUse ? nestedScratch : threadScratch;
+        scratch.inUse = true;
+        
+        vector<int>& dist = scratch.dist;
+        if ((int)dist.size() < maxNodes) dist.resize(maxNodes, INT_MAX);
+        IndexedPriorityQueue<int>& frontier = scratch.frontier;
+        
+        dist[start] = 0;
+        scratch.touched.push_back(start);
+        frontier.enqueue(start, 0);
+        
+        while (!frontier.isEmpty()) {
+            int d = frontier.peekPriority();
+            int u = frontier.dequeue();
+            
+            if (d > maxDistance) break;
+            if (visit(u, d)) break;
+            
+            Node<Edge>* current = adjacencyList[u].getHead();
+            while (current != nullptr) {
+                int v = current->data.destination;
+                int candidate = d + current->data.weight;
+                if (candidate < dist[v]) {
+                    if (dist[v] == INT_MAX) scratch.touched.push_back(v);
+                    dist[v] = candidate;
+                    frontier.enqueue(v, candidate);
+                }
+                current = current->next;
+            }
+        }
+        
+        for (int node : scratch.touched) dist[node] = INT_MAX;
+        scratch.touched.clear();
+        frontier.clear();
+        scratch.inUse = false;
+    }
+    
     void printGraph() const {
         cout << "\n=== Graph Structure ===\n";
         int totalEdges = 0;
@@ -54,6 +54,18 @@ public:
         return *this;
     }
     
+    // Grows an empty table to at least one bucket per expected item (it
+    // never shrinks), so loading many items at once keeps the chains
+    // short. Does nothing once the table holds items: regrowing would move
+    // every node and leave pointers from searchTable()/getItem() dangling.
+    void reserve(int expectedItems) {
+        if (expectedItems <= TABLE_SIZE || !isEmpty()) return;
+        
+        delete[] table;
+        TABLE_SIZE = expectedItems;
+        table = new LinkedList<pair<int, T>>[TABLE_SIZE];
+    }
+    
     bool isEmpty() const {
         for (int i = 0; i < TABLE_SIZE; i++) {
             if (!table[i].isEmpty())
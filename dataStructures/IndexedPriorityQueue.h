@@ -0,0 +1,275 @@
+#pragma once
+#ifndef INDEXEDPRIORITYQUEUE_H
+#define INDEXEDPRIORITYQUEUE_H
+
+#include <iostream>
+#include <vector>
+#include <unordered_map>
+#include <functional>
+#include <stdexcept>
+using namespace std;
+
+// Indexed d-ary min-heap. Every element is stored at most once and a
+// position map tracks where it sits in the heap, so contains() is O(1) and
+// remove()/updatePriority() are O(log n) instead of a linear scan.
+//
+// A wider node (D = 4 by default) makes the tree shallower, which keeps
+// heapifyUp cheap for priority changes and makes heapifyDown touch
+// adjacent children in the same cache line.
+template<typename T, int D = 4, typename Hash = hash<T>>
+class IndexedPriorityQueue {
+    static_assert(D >= 2, "IndexedPriorityQueue needs an arity of at least 2");
+
+private:
+    vector<pair<T, int>> heap;
+    unordered_map<T, size_t, Hash> position;   // element -> index in heap
+
+    void place(size_t index, const pair<T, int>& entry) {
+        heap[index] = entry;
+        position[entry.first] = index;
+    }
+
+    void heapifyUp(size_t index) {
+        pair<T, int> entry = heap[index];
+        while (index > 0) {
+            size_t parent = (index - 1) / D;
+            if (heap[parent].second <= entry.second) break;
+            place(index, heap[parent]);
+            index = parent;
+        }
+        place(index, entry);
+    }
+
+    void heapifyDown(size_t index) {
+        pair<T, int> entry = heap[index];
+        size_t size = heap.size();
+        while (true) {
+            size_t first = D * index + 1;
+            if (first >= size) break;
+
+            size_t last = min(first + D, size);
+            size_t smallest = first;
+            for (size_t child = first + 1; child < last; child++) {
+                if (heap[child].second < heap[smallest].second) {
+                    smallest = child;
+                }
+            }
+
+            if (heap[smallest].second >= entry.second) break;
+            place(index, heap[smallest]);
+            index = smallest;
+        }
+        place(index, entry);
+    }
+
+    // Removes the entry at index, filling the hole with the last element
+    void removeAt(size_t index) {
+        position.erase(heap[index].first);
+
+        if (index == heap.size() - 1) {
+            heap.pop_back();
+            return;
+        }
+
+        heap[index] = heap.back();
+        heap.pop_back();
+        position[heap[index].first] = index;
+
+        if (index > 0 && heap[index].second < heap[(index - 1) / D].second) {
+            heapifyUp(index);
+        } else {
+            heapifyDown(index);
+        }
+    }
+
+public:
+    IndexedPriorityQueue() {}
+
+    void reserve(size_t capacity) {
+        heap.reserve(capacity);
+        position.reserve(capacity);
+    }
+
+    // Add element with priority (lower number = higher priority).
+    // If the element is already queued its priority is updated instead.
+    void enqueue(const T& item, int priority) {
+        if (contains(item)) {
+            updatePriority(item, priority);
+            return;
+        }
+        heap.emplace_back(item, priority);
+        position[item] = heap.size() - 1;
+        heapifyUp(heap.size() - 1);
+    }
+
+    // Remove and return the highest priority element
+    T dequeue() {
+        if (isEmpty()) {
+            throw runtime_error("Priority queue is empty");
+        }
+
+        T item = heap[0].first;
+        removeAt(0);
+        return item;
+    }
+
+    // Peek at the highest priority element (non-const version)
+    T& peek() {
+        if (isEmpty()) {
+            throw runtime_error("Priority queue is empty");
+        }
+        return heap[0].first;
+    }
+
+    // Peek at the highest priority element (const version)
+    const T& peek() const {
+        if (isEmpty()) {
+            throw runtime_error("Priority queue is empty");
+        }
+        return heap[0].first;
+    }
+
+    // Get the priority of the top element
+    int peekPriority() const {
+        if (isEmpty()) {
+            throw runtime_error("Priority queue is empty");
+        }
+        return heap[0].second;
+    }
+
+    bool isEmpty() const {
+        return heap.empty();
+    }
+
+    int size() const {
+        return heap.size();
+    }
+
+    void clear() {
+        heap.clear();
+        position.clear();
+    }
+
+    bool contains(const T& item) const {
+        return position.find(item) != position.end();
+    }
+
+    // Update priority of an existing element
+    bool updatePriority(const T& item, int newPriority) {
+        auto it = position.find(item);
+        if (it == position.end()) return false;
+
+        size_t index = it->second;
+        int oldPriority = heap[index].second;
+        heap[index].second = newPriority;
+
+        if (newPriority < oldPriority) {
+            heapifyUp(index);
+        } else if (newPriority > oldPriority) {
+            heapifyDown(index);
+        }
+        return true;
+    }
+
+    // Move an element towards the front; ignored if newPriority is not lower
+    bool decreaseKey(const T& item, int newPriority) {
+        auto it = position.find(item);
+        if (it == position.end()) return false;
+        if (newPriority >= heap[it->second].second) return true;
+        return updatePriority(item, newPriority);
+    }
+
+    // Move an element towards the back; ignored if newPriority is not higher
+    bool increaseKey(const T& item, int newPriority) {
+        auto it = position.find(item);
+        if (it == position.end()) return false;
+        if (newPriority <= heap[it->second].second) return true;
+        return updatePriority(item, newPriority);
+    }
+
+    int getPriority(const T& item) const {
+        auto it = position.find(item);
+        if (it == position.end()) {
+            throw runtime_error("Item not found in priority queue");
+        }
+        return heap[it->second].second;
+    }
+
+    // Remove a specific element
+    bool remove(const T& item) {
+        auto it = position.find(item);
+        if (it == position.end()) return false;
+        removeAt(it->second);
+        return true;
+    }
+
+    // Print the priority queue (for debugging)
+    void print() const {
+        cout << "Indexed Priority Queue (element, priority):\n";
+        for (size_t i = 0; i < heap.size(); i++) {
+            cout << "  [" << i << "]: Element at priority " << heap[i].second << endl;
+        }
+    }
+
+    // Get all elements sorted by priority (lowest priority number first)
+    vector<T> getAllElements() const {
+        vector<T> elements;
+        IndexedPriorityQueue copy = *this;
+
+        while (!copy.isEmpty()) {
+            elements.push_back(copy.dequeue());
+        }
+
+        return elements;
+    }
+
+    // Check heap order and that the position map agrees with the heap
+    bool isHeapValid() const {
+        if (position.size() != heap.size()) return false;
+
+        for (size_t i = 0; i < heap.size(); i++) {
+            auto it = position.find(heap[i].first);
+            if (it == position.end() || it->second != i) return false;
+            if (i > 0 && heap[i].second < heap[(i - 1) / D].second) return false;
+        }
+        return true;
+    }
+
+    // Iterator support (heap order, not priority order)
+    class Iterator {
+    private:
+        const IndexedPriorityQueue* pq;
+        size_t index;
+
+    public:
+        Iterator(const IndexedPriorityQueue* _pq, size_t _index)
+            : pq(_pq), index(_index) {}
+
+        bool operator!=(const Iterator& other) const {
+            return index != other.index;
+        }
+
+        Iterator& operator++() {
+            index++;
+            return *this;
+        }
+
+        const T& operator*() const {
+            return pq->heap[index].first;
+        }
+
+        int priority() const {
+            return pq->heap[index].second;
+        }
+    };
+
+    Iterator begin() const {
+        return Iterator(this, 0);
+    }
+
+    Iterator end() const {
+        return Iterator(this, heap.size());
+    }
+};
+
+#endif
@@ -34,6 +34,40 @@ private:
 public:
     LinkedList() : head(nullptr), tail(nullptr), size(0) {}
     
+    // The list owns its nodes: copies are deep, moves hand the nodes over
+    LinkedList(const LinkedList& other) : head(nullptr), tail(nullptr), size(0) {
+        for (Node<T>* node = other.head; node != nullptr; node = node->next) {
+            insertAtEnd(node->data);
+        }
+    }
+    
+    LinkedList(LinkedList&& other) : head(other.head), tail(other.tail), size(other.size) {
+        other.head = other.tail = nullptr;
+        other.size = 0;
+    }
+    
+    LinkedList& operator=(const LinkedList& other) {
+        if (this != &other) {
+            clear();
+            for (Node<T>* node = other.head; node != nullptr; node = node->next) {
+                insertAtEnd(node->data);
+            }
+        }
+        return *this;
+    }
+    
+    LinkedList& operator=(LinkedList&& other) {
+        if (this != &other) {
+            clear();
+            head = other.head;
+            tail = other.tail;
+            size = other.size;
+            other.head = other.tail = nullptr;
+            other.size = 0;
+        }
+        return *this;
+    }
+    
     ~LinkedList() {
         clear();
     }
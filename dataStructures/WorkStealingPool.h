@@ -0,0 +1,296 @@
+#pragma once
+#ifndef WORKSTEALINGPOOL_H
+#define WORKSTEALINGPOOL_H
+
+#include <vector>
+#include <atomic>
+#include <functional>
+#include <algorithm>
+#include <cstdint>
+
+#ifdef _WIN32
+    #include <windows.h>
+#else
+    #include <thread>
+    #include <mutex>
+    #include <condition_variable>
+#endif
+
+using namespace std;
+
+// Runs the iterations of a loop on several threads. Each worker starts
+// with an equal slice of the index range and takes indices from the front
+// of its own slice; a worker that runs dry steals the back half of another
+// worker's slice, so uneven iterations (one search settling half the map,
+// the next stopping after two nodes) don't leave cores idle.
+//
+// The worker threads are started by the first parallelFor() and then wait
+// for the next loop until the pool is destroyed, so a call costs a wake-up
+// rather than a thread start; the caller's thread works as worker 0. One
+// loop runs at a time: a call made while another thread's loop is running
+// runs serially on its own thread instead of waiting.
+//
+// task(index, worker) gets the worker number (0 .. getWorkerCount()-1) so
+// it can keep per-worker scratch; results should be written by index and
+// reduced by the caller afterwards to stay independent of scheduling.
+class WorkStealingPool {
+private:
+    // A worker's remaining indices [begin, end), guarded by a spin lock;
+    // the owner and thieves only hold it for a couple of instructions
+    struct Slice {
+        atomic_flag busy;
+        size_t begin;
+        size_t end;
+
+        Slice() : begin(0), end(0) { busy.clear(); }
+
+        void lock() { while (busy.test_and_set(memory_order_acquire)) {} }
+        void unlock() { busy.clear(memory_order_release); }
+    };
+
+    struct RunState {
+        vector<Slice> slices;
+        const function<void(size_t, int)>* task;
+
+        RunState(size_t workers) : slices(workers), task(nullptr) {}
+    };
+
+    int workerCount;
+
+    // The parked workers (1 .. workerCount-1) and the loop they're on.
+    // generation moves once per loop; every worker acknowledges it by
+    // decrementing unfinished, whether or not the loop had work for it.
+#ifdef _WIN32
+    mutable CRITICAL_SECTION lock;
+    mutable CONDITION_VARIABLE wake;
+    mutable CONDITION_VARIABLE finished;
+    mutable vector<HANDLE> threads;
+#else
+    mutable mutex lock;
+    mutable condition_variable wake;
+    mutable condition_variable finished;
+    mutable vector<thread> threads;
+#endif
+    mutable RunState* current;
+    mutable uint64_t generation;
+    mutable size_t unfinished;
+    mutable bool stopping;
+    mutable atomic<bool> inUse;
+
+    WorkStealingPool(const WorkStealingPool&);
+    WorkStealingPool& operator=(const WorkStealingPool&);
+
+    static bool takeOwn(Slice& slice, size_t& index) {
+        slice.lock();
+        bool found = slice.begin < slice.end;
+        if (found) index = slice.begin++;
+        slice.unlock();
+        return found;
+    }
+
+    // Moves the back half of the next worker that still has indices into
+    // thief's (empty) slice. False once every slice is empty.
+    static bool steal(RunState& state, int thief) {
+        size_t workers = state.slices.size();
+        for (size_t offset = 1; offset < workers; offset++) {
+            Slice& victim = state.slices[(thief + offset) % workers];
+
+            victim.lock();
+            if (victim.begin >= victim.end) {
+                victim.unlock();
+                continue;
+            }
+            size_t mid = victim.end - (victim.end - victim.begin + 1) / 2;
+            size_t stolenEnd = victim.end;
+            victim.end = mid;
+            victim.unlock();
+
+            Slice& own = state.slices[thief];
+            own.lock();
+            own.begin = mid;
+            own.end = stolenEnd;
+            own.unlock();
+            return true;
+        }
+        return false;
+    }
+
+    static void runWorker(RunState& state, int worker) {
+        Slice& own = state.slices[worker];
+        size_t index;
+        do {
+            while (takeOwn(own, index)) {
+                (*state.task)(index, worker);
+            }
+        } while (steal(state, worker));
+    }
+
+    void acquire() const {
+#ifdef _WIN32
+        EnterCriticalSection(&lock);
+#else
+        lock.lock();
+#endif
+    }
+
+    void release() const {
+#ifdef _WIN32
+        LeaveCriticalSection(&lock);
+#else
+        lock.unlock();
+#endif
+    }
+
+    // Waits on condition with lock held
+#ifdef _WIN32
+    void waitFor(CONDITION_VARIABLE& condition) const {
+        SleepConditionVariableCS(&condition, &lock, INFINITE);
+    }
+    static void wakeAll(CONDITION_VARIABLE& condition) { WakeAllConditionVariable(&condition); }
+#else
+    void waitFor(condition_variable& condition) const {
+        unique_lock<mutex> held(lock, adopt_lock);
+        condition.wait(held);
+        held.release();
+    }
+    static void wakeAll(condition_variable& condition) { condition.notify_all(); }
+#endif
+
+    void workerLoop(int worker) const {
+        uint64_t seen = 0;
+        for (;;) {
+            acquire();
+            while (!stopping && generation == seen) waitFor(wake);
+            if (stopping) {
+                release();
+                return;
+            }
+            seen = generation;
+            RunState* state = current;
+            release();
+
+            if ((size_t)worker < state->slices.size()) runWorker(*state, worker);
+
+            acquire();
+            if (--unfinished == 0) wakeAll(finished);
+            release();
+        }
+    }
+
+#ifdef _WIN32
+    struct WorkerArgs {
+        const WorkStealingPool* pool;
+        int worker;
+    };
+
+    static DWORD WINAPI workerThreadStatic(LPVOID lpParam) {
+        WorkerArgs* args = (WorkerArgs*)lpParam;
+        const WorkStealingPool* pool = args->pool;
+        int worker = args->worker;
+        delete args;
+        pool->workerLoop(worker);
+        return 0;
+    }
+#endif
+
+    // Starts the parked workers the first time they're needed
+    void startWorkers() const {
+        if (!threads.empty() || workerCount <= 1) return;
+        for (int w = 1; w < workerCount; w++) {
+#ifdef _WIN32
+            WorkerArgs* args = new WorkerArgs();
+            args->pool = this;
+            args->worker = w;
+            HANDLE h = CreateThread(NULL, 0, workerThreadStatic, args, 0, NULL);
+            if (!h) {
+                delete args;
+                break;
+            }
+            threads.push_back(h);
+#else
+            threads.emplace_back(&WorkStealingPool::workerLoop, this, w);
+#endif
+        }
+    }
+
+public:
+    // workers <= 0 uses one per core
+    WorkStealingPool(int workers = 0)
+        : workerCount(workers), current(nullptr), generation(0), unfinished(0), stopping(false), inUse(false) {
+#ifdef _WIN32
+        InitializeCriticalSection(&lock);
+        InitializeConditionVariable(&wake);
+        InitializeConditionVariable(&finished);
+#endif
+        if (workerCount <= 0) {
+#ifdef _WIN32
+            SYSTEM_INFO info;
+            GetSystemInfo(&info);
+            workerCount = (int)info.dwNumberOfProcessors;
+#else
+            workerCount = (int)thread::hardware_concurrency();
+#endif
+            if (workerCount <= 0) workerCount = 2;
+        }
+    }
+
+    ~WorkStealingPool() {
+        acquire();
+        stopping = true;
+        wakeAll(wake);
+        release();
+#ifdef _WIN32
+        for (HANDLE h : threads) {
+            WaitForSingleObject(h, INFINITE);
+            CloseHandle(h);
+        }
+        DeleteCriticalSection(&lock);
+#else
+        for (auto& t : threads) t.join();
+#endif
+    }
+
+    int getWorkerCount() const { return workerCount; }
+
+    // Calls task(index, worker) for every index in [0, count) and returns
+    // once all of them have finished
+    void parallelFor(size_t count, const function<void(size_t, int)>& task) const {
+        if (count == 0) return;
+
+        size_t workers = min((size_t)workerCount, count);
+        if (workers <= 1 || inUse.exchange(true, memory_order_acquire)) {
+            for (size_t i = 0; i < count; i++) task(i, 0);
+            return;
+        }
+
+        acquire();
+        startWorkers();
+        workers = min(workers, threads.size() + 1);
+        release();
+
+        RunState state(workers);
+        state.task = &task;
+        for (size_t w = 0; w < workers; w++) {
+            state.slices[w].begin = count * w / workers;
+            state.slices[w].end = count * (w + 1) / workers;
+        }
+
+        acquire();
+        current = &state;
+        unfinished = threads.size();
+        generation++;
+        wakeAll(wake);
+        release();
+
+        runWorker(state, 0);
+
+        acquire();
+        while (unfinished > 0) waitFor(finished);
+        current = nullptr;
+        release();
+
+        inUse.store(false, memory_order_release);
+    }
+};
+
+#endif
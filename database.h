@@ -5,11 +5,22 @@
 #include <fstream>
 #include <vector>
 #include <cstring>
+#include <map>
+#include <cstdint>
 #include "models/User.h"
 #include "models/Restaurant.h"
 #include "models/Order.h"
 #include "models/Rider.h"
 #include "models/MenuItem.h"
+#include "Logger.h"
+#include "RestaurantMigration.h"
+#include "storage/PagedRecordFile.h"
+
+#ifdef _WIN32
+    #include <windows.h>
+#else
+    #include <mutex>
+#endif
 
 using namespace std;
 vector<Restaurant> loadAllRestaurants();
@@ -30,35 +41,77 @@ private:
     const string RIDER_FILE = "riders.dat";
     const string MENU_ITEM_FILE = "menu_items.dat";
     
-    // FIXED: Safe file operations with validation
+    // Held across every write, including the load-modify-save of the
+    // single-record calls, so a write on one thread can't be lost under a
+    // whole-file replace from another. Recursive: those calls save
+    // through saveAll*.
+#ifdef _WIN32
+    CRITICAL_SECTION fileLock;
+#else
+    recursive_mutex fileLock;
+#endif
+    map<string, uint64_t> writeCounts;     // under fileLock
+    
+    // Replaces a whole record file, as a checksummed paged file, with one
+    // atomic write
     template<typename T>
-    bool safeWriteRecord(ofstream& file, const T& record) {
-        if (!file.is_open()) {
-            cerr << "Error: File not open for writing\n";
+    bool writeAllRecords(const string& filename, const char* schema, const vector<T>& records) {
+        writeCounts[filename]++;
+        if (!PagedRecordFile::write(filename, schema, records)) {
+            LOG_ERROR("Could not write " << filename);
             return false;
         }
-        
-        file.write(reinterpret_cast<const char*>(&record), sizeof(T));
-        
-        if (file.fail()) {
-            cerr << "Error: Failed to write record\n";
+        return true;
+    }
+    
+    // Where stageAll* puts a file until it's published; apart from the
+    // .tmp that writeAllRecords uses, so the two can't overwrite each other
+    static string stagedFile(const string& filename) {
+        return filename + ".checkpoint";
+    }
+    
+    template<typename T>
+    bool stageAllRecords(const string& filename, const char* schema, const vector<T>& records) {
+        if (!PagedRecordFile::stage(stagedFile(filename), schema, records)) {
+            LOG_ERROR("Could not write " << stagedFile(filename));
             return false;
         }
-        
-        file.flush(); // Force write to disk
         return true;
     }
     
+    // Loads a record file. Paged files lose only the records of damaged
+    // pages; files from before the paged format are read as raw records
+    // and converted on their next save.
     template<typename T>
-    bool safeReadRecord(ifstream& file, T& record) {
-        if (!file.is_open()) {
-            cerr << "Error: File not open for reading\n";
-            return false;
+    vector<T> readAllRecords(const string& filename, const char* schema) {
+        vector<T> records;
+        
+        if (PagedRecordFile::isContainer(filename)) {
+            PagedFileReport report;
+            if (!PagedRecordFile::read(filename, schema, records, &report)) {
+                LOG_WARN("⚠️  " << filename << " unreadable: " << report.error);
+            } else if (!report.badPages.empty()) {
+                LOG_WARN("⚠️  " << filename << ": " << report.badPages.size()
+                     << " damaged pages skipped, " << report.recordsLost() << " records lost");
+            }
+            return records;
         }
         
-        file.read(reinterpret_cast<char*>(&record), sizeof(T));
+        size_t recordCount;
+        if (!validateFileStructure<T>(filename, recordCount) || recordCount == 0) {
+            return records;
+        }
         
-        return !file.fail();
+        ifstream file(filename, ios::binary);
+        if (!file) {
+            return records;
+        }
+        
+        records.resize(recordCount);
+        if (!file.read(reinterpret_cast<char*>(&records[0]), recordCount * sizeof(T))) {
+            records.clear();
+        }
+        return records;
     }
     
     // FIXED: Validate file structure before reading
@@ -74,8 +127,8 @@ private:
         size_t fileSize = file.tellg();
         file.close();
         
-        cout << "DEBUG: File " << filename << " size: " << fileSize << " bytes\n";
-        cout << "DEBUG: sizeof(T): " << sizeof(T) << " bytes\n";
+        LOG_DEBUG("File " << filename << " size: " << fileSize << " bytes");
+        LOG_DEBUG("sizeof(T): " << sizeof(T) << " bytes");
         
         if (fileSize == 0) {
             recordCount = 0;
@@ -83,22 +136,103 @@ private:
         }
         
         if (fileSize % sizeof(T) != 0) {
-            cout << "DEBUG: Expected records: " << (fileSize / sizeof(T)) << "\n";
-            cout << "WARNING: File " << filename 
-                 << " appears corrupted! Size doesn't align with record size.\n";
+            LOG_DEBUG("Expected records: " << (fileSize / sizeof(T)));
+            LOG_WARN("File " << filename 
+                 << " appears corrupted! Size doesn't align with record size.");
             recordCount = 0;
             return false;
         }
         
         recordCount = fileSize / sizeof(T);
-        cout << "DEBUG: Successfully validated " << recordCount 
-             << " records in " << filename << "\n";
+        LOG_DEBUG("Successfully validated " << recordCount 
+             << " records in " << filename);
         return true;
     }
 
+    Database(const Database&);
+    Database& operator=(const Database&);
+    
 public:
+    // Keeps other threads from writing the record files while it's alive;
+    // for checking something and writing based on it as one step
+    class FileGuard {
+    private:
+        Database& db;
+    public:
+        FileGuard(Database& database) : db(database) {
+#ifdef _WIN32
+            EnterCriticalSection(&db.fileLock);
+#else
+            db.fileLock.lock();
+#endif
+        }
+        ~FileGuard() {
+#ifdef _WIN32
+            LeaveCriticalSection(&db.fileLock);
+#else
+            db.fileLock.unlock();
+#endif
+        }
+    };
+    
+    // How many times filename has been written (or tried to be) by this
+    // Database; a caller that read the data earlier can tell from it
+    // whether the file was written since
+    uint64_t getWriteCount(const string& filename) {
+        FileGuard guard(*this);
+        map<string, uint64_t>::const_iterator it = writeCounts.find(filename);
+        return it != writeCounts.end() ? it->second : 0;
+    }
+    
+    // A whole-file rewrite in two steps, for a caller that mustn't hold up
+    // the single-record writes while a large file is written. stageAll*
+    // writes the new file beside the old one without fileLock;
+    // publishStaged then renames it into place under fileLock, but only if
+    // nothing wrote the file after writesAt (getWriteCount) - current
+    // says whether that held. force renames it regardless, for a caller
+    // whose copy is known to include every write since.
+    bool stageAllUsers(const vector<UserData>& users) {
+        return stageAllRecords(USER_FILE, RecordSchema::USERS, users);
+    }
+    
+    bool stageAllRestaurants(const vector<Restaurant>& restaurants) {
+        return stageAllRecords(RESTAURANT_FILE, RecordSchema::RESTAURANTS, restaurants);
+    }
+    
+    bool stageAllOrders(const vector<Order>& orders) {
+        return stageAllRecords(ORDER_FILE, RecordSchema::ORDERS, orders);
+    }
+    
+    bool stageAllRiders(const vector<Rider>& riders) {
+        return stageAllRecords(RIDER_FILE, RecordSchema::RIDERS, riders);
+    }
+    
+    bool publishStaged(const string& filename, uint64_t writesAt, bool& current, bool force = false) {
+        FileGuard guard(*this);
+        current = force || writeCounts[filename] == writesAt;
+        if (!current) {
+            AtomicFileWriter::discard(stagedFile(filename));
+            return false;
+        }
+        writeCounts[filename]++;
+        if (!AtomicFileWriter::publish(stagedFile(filename), filename)) {
+            LOG_ERROR("Could not replace " << filename);
+            return false;
+        }
+        return true;
+    }
+    
     Database() {
-        cout << "Database initialized\n";
+#ifdef _WIN32
+        InitializeCriticalSection(&fileLock);
+#endif
+        LOG_DEBUG("Database initialized");
+    }
+    
+    ~Database() {
+#ifdef _WIN32
+        DeleteCriticalSection(&fileLock);
+#endif
     }
     // Add these methods to your Database class:
 
@@ -116,6 +250,7 @@ public:
 // }
 
 bool deleteMenuItem(int itemId) {
+    FileGuard guard(*this);
     vector<MenuItem> allItems = loadAllMenuItems();
     vector<MenuItem> updatedItems;
     
@@ -129,6 +264,7 @@ bool deleteMenuItem(int itemId) {
 }
 
 bool deleteRider(int riderId) {
+    FileGuard guard(*this);
     vector<Rider> allRiders = loadAllRiders();
     vector<Rider> updatedRiders;
     
@@ -142,6 +278,7 @@ bool deleteRider(int riderId) {
 }
 
 bool updateUser(const UserData& user) {
+    FileGuard guard(*this);
     vector<UserData> allUsers = loadAllUsers();
     
     for (auto& u : allUsers) {
@@ -155,61 +292,27 @@ bool updateUser(const UserData& user) {
 }
     // ===== USER OPERATIONS =====
     bool saveUser(const UserData& user) {
-        ofstream file(USER_FILE, ios::binary | ios::app);
-        if (!file) {
-            cerr << "Error: Could not open " << USER_FILE << "\n";
-            return false;
-        }
-        
-        bool success = safeWriteRecord(file, user);
-        file.close();
-        return success;
+        FileGuard guard(*this);
+        vector<UserData> users = loadAllUsers();
+        users.push_back(user);
+        return saveAllUsers(users);
     }
     
     bool saveAllUsers(const vector<UserData>& users) {
-        ofstream file(USER_FILE, ios::binary | ios::trunc);
-        if (!file) {
-            cerr << "Error: Could not open " << USER_FILE << "\n";
-            return false;
-        }
-        
-        for (const auto& user : users) {
-            if (!safeWriteRecord(file, user)) {
-                file.close();
-                return false;
-            }
-        }
-        
-        file.close();
-        return true;
+        FileGuard guard(*this);
+        return writeAllRecords(USER_FILE, RecordSchema::USERS, users);
     }
     
     vector<UserData> loadAllUsers() {
-        vector<UserData> users;
-        size_t recordCount;
-        
-        if (!validateFileStructure<UserData>(USER_FILE, recordCount)) {
-            return users; // Return empty vector if corrupted
-        }
-        
-        ifstream file(USER_FILE, ios::binary);
-        if (!file) {
-            return users;
-        }
-        
-        UserData temp;
-        while (safeReadRecord(file, temp)) {
-            users.push_back(temp);
-        }
-        
-        file.close();
-        cout << "DEBUG: Successfully read " << users.size() 
-             << " records from " << USER_FILE << "\n";
+        vector<UserData> users = readAllRecords<UserData>(USER_FILE, RecordSchema::USERS);
+        LOG_DEBUG("Successfully read " << users.size() 
+             << " records from " << USER_FILE);
         return users;
     }
     
     // ===== RESTAURANT OPERATIONS =====
     bool saveRestaurant(const Restaurant& restaurant) {
+        FileGuard guard(*this);
         // First, load all existing restaurants
         vector<Restaurant> restaurants = loadAllRestaurants();
         
@@ -232,44 +335,46 @@ bool updateUser(const UserData& user) {
     }
     
     bool saveAllRestaurants(const vector<Restaurant>& restaurants) {
-        ofstream file(RESTAURANT_FILE, ios::binary | ios::trunc);
-        if (!file) {
-            cerr << "Error: Could not open " << RESTAURANT_FILE << "\n";
-            return false;
-        }
-        
-        for (const auto& restaurant : restaurants) {
-            if (!safeWriteRecord(file, restaurant)) {
-                file.close();
-                return false;
-            }
-        }
-        
-        file.close();
-        return true;
+        FileGuard guard(*this);
+        return writeAllRecords(RESTAURANT_FILE, RecordSchema::RESTAURANTS, restaurants);
     }
     
     vector<Restaurant> loadAllRestaurants() {
-        vector<Restaurant> restaurants;
-        size_t recordCount;
-        
-        if (!validateFileStructure<Restaurant>(RESTAURANT_FILE, recordCount)) {
-            cout << "⚠️  Restaurant file corrupted. Returning empty vector.\n";
-            return restaurants;
+        if (RestaurantMigration::isLegacyFile(RESTAURANT_FILE)) {
+            migrateLegacyRestaurants();
         }
-        
-        ifstream file(RESTAURANT_FILE, ios::binary);
-        if (!file) {
-            return restaurants;
+        return readAllRecords<Restaurant>(RESTAURANT_FILE, RecordSchema::RESTAURANTS);
+    }
+    
+    // Upgrades a restaurants.dat written while restaurants still embedded
+    // their menus; the embedded items are added to menu_items.dat unless
+    // an item with the same id is already there. False if the file isn't
+    // in the legacy layout.
+    bool migrateLegacyRestaurants() {
+        FileGuard guard(*this);
+        vector<MenuItem> embedded;
+        if (!RestaurantMigration::upgradeFile(RESTAURANT_FILE, embedded)) {
+            return false;
         }
         
-        Restaurant temp;
-        while (safeReadRecord(file, temp)) {
-            restaurants.push_back(temp);
+        vector<MenuItem> items = loadAllMenuItems();
+        size_t stored = items.size();
+        for (const auto& item : embedded) {
+            bool known = false;
+            for (const auto& existing : items) {
+                if (existing.id == item.id) {
+                    known = true;
+                    break;
+                }
+            }
+            if (!known) {
+                items.push_back(item);
+            }
         }
-        
-        file.close();
-        return restaurants;
+        if (items.size() != stored) {
+            return saveAllMenuItems(items);
+        }
+        return true;
     }
     
     bool updateRestaurant(const Restaurant& restaurant) {
@@ -277,6 +382,7 @@ bool updateUser(const UserData& user) {
     }
     
     bool deleteRestaurant(int restaurantId) {
+        FileGuard guard(*this);
         vector<Restaurant> restaurants = loadAllRestaurants();
         
         auto it = restaurants.begin();
@@ -294,6 +400,7 @@ bool updateUser(const UserData& user) {
     
     // ===== ORDER OPERATIONS =====
     bool saveOrder(const Order& order) {
+        FileGuard guard(*this);
         vector<Order> orders = loadAllOrders();
         
         bool found = false;
@@ -313,44 +420,12 @@ bool updateUser(const UserData& user) {
     }
     
     bool saveAllOrders(const vector<Order>& orders) {
-        ofstream file(ORDER_FILE, ios::binary | ios::trunc);
-        if (!file) {
-            cerr << "Error: Could not open " << ORDER_FILE << "\n";
-            return false;
-        }
-        
-        for (const auto& order : orders) {
-            if (!safeWriteRecord(file, order)) {
-                file.close();
-                return false;
-            }
-        }
-        
-        file.close();
-        return true;
+        FileGuard guard(*this);
+        return writeAllRecords(ORDER_FILE, RecordSchema::ORDERS, orders);
     }
     
     vector<Order> loadAllOrders() {
-        vector<Order> orders;
-        size_t recordCount;
-        
-        if (!validateFileStructure<Order>(ORDER_FILE, recordCount)) {
-            cout << "⚠️  Order file corrupted. Returning empty vector.\n";
-            return orders;
-        }
-        
-        ifstream file(ORDER_FILE, ios::binary);
-        if (!file) {
-            return orders;
-        }
-        
-        Order temp;
-        while (safeReadRecord(file, temp)) {
-            orders.push_back(temp);
-        }
-        
-        file.close();
-        return orders;
+        return readAllRecords<Order>(ORDER_FILE, RecordSchema::ORDERS);
     }
     
     bool updateOrder(const Order& order) {
@@ -359,6 +434,7 @@ bool updateUser(const UserData& user) {
     
     // ===== RIDER OPERATIONS =====
     bool saveRider(const Rider& rider) {
+        FileGuard guard(*this);
         vector<Rider> riders = loadAllRiders();
         
         bool found = false;
@@ -378,49 +454,19 @@ bool updateUser(const UserData& user) {
     }
     
     bool saveAllRiders(const vector<Rider>& riders) {
-        ofstream file(RIDER_FILE, ios::binary | ios::trunc);
-        if (!file) {
-            cerr << "Error: Could not open " << RIDER_FILE << "\n";
-            return false;
-        }
-        
-        for (const auto& rider : riders) {
-            if (!safeWriteRecord(file, rider)) {
-                file.close();
-                return false;
-            }
-        }
-        
-        file.close();
-        return true;
+        FileGuard guard(*this);
+        return writeAllRecords(RIDER_FILE, RecordSchema::RIDERS, riders);
     }
     
     vector<Rider> loadAllRiders() {
-        vector<Rider> riders;
-        size_t recordCount;
-        
-        if (!validateFileStructure<Rider>(RIDER_FILE, recordCount)) {
-            return riders;
-        }
-        
-        ifstream file(RIDER_FILE, ios::binary);
-        if (!file) {
-            return riders;
-        }
-        
-        Rider temp;
-        while (safeReadRecord(file, temp)) {
-            riders.push_back(temp);
-        }
-        
-        file.close();
-        return riders;
+        return readAllRecords<Rider>(RIDER_FILE, RecordSchema::RIDERS);
     }
     
     bool updateRider(const Rider& rider) {
         return saveRider(rider);
     }
     bool saveMenuItem(const MenuItem& item) {
+    FileGuard guard(*this);
     // Load all existing items
     vector<MenuItem> items = loadAllMenuItems();
     
@@ -443,81 +489,58 @@ bool updateUser(const UserData& user) {
     return saveAllMenuItems(items);
 }
     bool saveAllMenuItems(const vector<MenuItem>& items) {
-    ofstream file(MENU_ITEM_FILE, ios::binary);
-    if (!file) {
-        return false;
-    }
+    FileGuard guard(*this);
+    BulkBuffer buffer;
+    buffer.reserve(8 + items.size() * 64);
     
     // Write header: "MENU" signature and count
     const char signature[] = "MENU";
-    file.write(signature, 4);
+    buffer.append(signature, 4);
     
     uint32_t count = static_cast<uint32_t>(items.size());
-    file.write(reinterpret_cast<const char*>(&count), sizeof(count));
+    buffer.appendValue(count);
     
-    // Write each item
+    // Each item: ID, restaurant ID, name, description, price, stock, category
     for (const auto& item : items) {
-        // Write ID
-        int id = item.id;
-        file.write(reinterpret_cast<const char*>(&id), sizeof(id));
-        
-        // Write restaurant ID
-        int restaurantId = item.restaurantId;
-        file.write(reinterpret_cast<const char*>(&restaurantId), sizeof(restaurantId));
-        
-        // Write name (with length prefix)
-        string name = item.getName();
-        uint32_t nameLen = static_cast<uint32_t>(name.length());
-        file.write(reinterpret_cast<const char*>(&nameLen), sizeof(nameLen));
-        file.write(name.c_str(), nameLen);
-        
-        // Write description
-        string desc = item.getDescription();
-        uint32_t descLen = static_cast<uint32_t>(desc.length());
-        file.write(reinterpret_cast<const char*>(&descLen), sizeof(descLen));
-        file.write(desc.c_str(), descLen);
-        
-        // Write price
-        double price = item.price;
-        file.write(reinterpret_cast<const char*>(&price), sizeof(price));
-        
-        // Write stock
-        int stock = item.stock;
-        file.write(reinterpret_cast<const char*>(&stock), sizeof(stock));
-        
-        // Write category
-        string category = item.getCategory();
-        uint32_t catLen = static_cast<uint32_t>(category.length());
-        file.write(reinterpret_cast<const char*>(&catLen), sizeof(catLen));
-        file.write(category.c_str(), catLen);
-    }
-    
-    file.close();
-    cout << "✓ Saved " << items.size() << " menu items to binary file" << endl;
+        buffer.appendValue(item.id);
+        buffer.appendValue(item.restaurantId);
+        buffer.appendString(item.getName());
+        buffer.appendString(item.getDescription());
+        buffer.appendValue(item.price);
+        buffer.appendValue(item.stock);
+        buffer.appendString(item.getCategory());
+    }
+    
+    if (!AtomicFileWriter::write(MENU_ITEM_FILE, buffer)) {
+        LOG_ERROR("Could not write " << MENU_ITEM_FILE);
+        return false;
+    }
+    
+    LOG_DEBUG("✓ Saved " << items.size() << " menu items to binary file");
     return true;
 }
     
     vector<MenuItem> loadAllMenuItems() {
     vector<MenuItem> items;
     
-    cout << "\n=== DEBUG loadAllMenuItems START ===\n";
+    LOG_DEBUG("=== loadAllMenuItems START ===");
     
     // Try binary file first
     ifstream binFile("menu_items.dat", ios::binary);
     if (binFile) {
-        cout << "Found menu_items.dat\n";
+        LOG_DEBUG("Found menu_items.dat");
         
         // Check file size
         binFile.seekg(0, ios::end);
         size_t fileSize = binFile.tellg();
         binFile.seekg(0, ios::beg);
         
-        cout << "File size: " << fileSize << " bytes\n";
+        LOG_DEBUG("File size: " << fileSize << " bytes");
         
         if (fileSize < 8) {
-            cout << "File too small (<8 bytes), treating as empty\n";
+            LOG_DEBUG("File too small (<8 bytes), treating as empty");
             binFile.close();
-            cout << "=== DEBUG loadAllMenuItems END (empty) ===\n";
+            LOG_DEBUG("=== loadAllMenuItems END (empty) ===");
             return items;
         }
         
@@ -526,19 +549,19 @@ bool updateUser(const UserData& user) {
         binFile.read(signature, 4);
         signature[4] = '\0';
         
-        cout << "Signature: " << signature << "\n";
+        LOG_DEBUG("Signature: " << signature);
         
         if (string(signature) != "MENU") {
-            cout << "Invalid signature '" << signature << "', expected 'MENU'\n";
+            LOG_WARN("Invalid signature '" << signature << "', expected 'MENU'");
             binFile.close();
-            cout << "=== DEBUG loadAllMenuItems END (invalid) ===\n";
+            LOG_DEBUG("=== loadAllMenuItems END (invalid) ===");
             return items;
         }
         
         // Read count
         uint32_t count;
         binFile.read(reinterpret_cast<char*>(&count), sizeof(count));
-        cout << "Item count in file: " << count << "\n";
+        LOG_DEBUG("Item count in file: " << count);
         
         // Calculate expected size
         // Header: 4 (signature) + 4 (count) = 8 bytes
@@ -546,16 +569,16 @@ bool updateUser(const UserData& user) {
         size_t minSize = 8 + count * (4 + 4 + 4 + 0 + 4 + 0 + 8 + 4 + 4 + 0);
         
         if (fileSize < minSize) {
-            cout << "File size " << fileSize << " < minimum expected " << minSize << "\n";
+            LOG_WARN("File size " << fileSize << " < minimum expected " << minSize);
             binFile.close();
-            cout << "=== DEBUG loadAllMenuItems END (size mismatch) ===\n";
+            LOG_DEBUG("=== loadAllMenuItems END (size mismatch) ===");
             return items;
         }
         
         // Read items
         for (uint32_t i = 0; i < count; i++) {
             try {
-                cout << "Reading item " << (i+1) << "/" << count << "...\n";
+                LOG_DEBUG("Reading item " << (i+1) << "/" << count << "...");
                 
                 // Read ID
                 int id;
@@ -595,11 +618,11 @@ bool updateUser(const UserData& user) {
                 MenuItem item(id, name, description, price, stock, category, restaurantId);
                 items.push_back(item);
                 
-                cout << "  ✓ Loaded: ID=" << id << ", Name=" << name 
-                     << ", Restaurant=" << restaurantId << ", Price=$" << price << "\n";
+                LOG_DEBUG("  ✓ Loaded: ID=" << id << ", Name=" << name 
+                     << ", Restaurant=" << restaurantId << ", Price=$" << price);
                     
             } catch (const exception& e) {
-                cout << "✗ Error reading item " << i << ": " << e.what() << "\n";
+                LOG_WARN("✗ Error reading item " << i << ": " << e.what());
                 break;
             }
         }
@@ -607,19 +630,19 @@ bool updateUser(const UserData& user) {
         binFile.close();
         
         if (!items.empty()) {
-            cout << "✓ Successfully loaded " << items.size() << "/" << count << " menu items from binary\n";
-            cout << "=== DEBUG loadAllMenuItems END (success) ===\n";
+            LOG_DEBUG("✓ Successfully loaded " << items.size() << "/" << count << " menu items from binary");
+            LOG_DEBUG("=== loadAllMenuItems END (success) ===");
             return items;
         }
     } else {
-        cout << "Binary file not found\n";
+        LOG_DEBUG("Binary file not found");
     }
     
     // Fallback to text file
-    cout << "Trying text file fallback...\n";
+    LOG_DEBUG("Trying text file fallback...");
     ifstream textFile("menu_items.txt");
     if (textFile) {
-        cout << "Found menu_items.txt\n";
+        LOG_DEBUG("Found menu_items.txt");
         
         string line;
         size_t loaded = 0;
@@ -648,9 +671,9 @@ bool updateUser(const UserData& user) {
                     items.push_back(item);
                     loaded++;
                     
-                    cout << "  ✓ From text: ID=" << id << ", Name=" << name << "\n";
+                    LOG_DEBUG("  ✓ From text: ID=" << id << ", Name=" << name);
                 } catch (const exception& e) {
-                    cout << "✗ Error parsing line: " << e.what() << "\n";
+                    LOG_WARN("✗ Error parsing line: " << e.what());
                 }
             }
         }
@@ -658,37 +681,37 @@ bool updateUser(const UserData& user) {
         textFile.close();
         
         if (loaded > 0) {
-            cout << "✓ Loaded " << loaded << " items from text file\n";
+            LOG_INFO("✓ Loaded " << loaded << " items from text file");
             
             // Save to binary for next time
             saveAllMenuItems(items);
             
-            cout << "=== DEBUG loadAllMenuItems END (text fallback) ===\n";
+            LOG_DEBUG("=== loadAllMenuItems END (text fallback) ===");
             return items;
         }
     }
     
-    cout << "⚠ No menu items found in any format\n";
-    cout << "=== DEBUG loadAllMenuItems END (empty) ===\n";
+    LOG_WARN("⚠ No menu items found in any format");
+    LOG_DEBUG("=== loadAllMenuItems END (empty) ===");
     return items;
 }
     vector<MenuItem> loadMenuItemsByRestaurant(int restaurantId) {
     vector<MenuItem> allItems = loadAllMenuItems();
     vector<MenuItem> restaurantItems;
     
-    cout << "DEBUG: Looking for menu items for restaurant " << restaurantId << endl;
-    cout << "DEBUG: Total items loaded: " << allItems.size() << endl;
+    LOG_DEBUG("Looking for menu items for restaurant " << restaurantId);
+    LOG_DEBUG("Total items loaded: " << allItems.size());
     
     for (const auto& item : allItems) {
-        cout << "DEBUG: Item ID=" << item.id << ", RestaurantID=" << item.restaurantId 
-             << ", Name=" << item.getName() << endl;
+        LOG_DEBUG("Item ID=" << item.id << ", RestaurantID=" << item.restaurantId 
+             << ", Name=" << item.getName());
         
         if (item.restaurantId == restaurantId) {
             restaurantItems.push_back(item);
         }
     }
     
-    cout << "DEBUG: Found " << restaurantItems.size() << " items for restaurant " << restaurantId << endl;
+    LOG_DEBUG("Found " << restaurantItems.size() << " items for restaurant " << restaurantId);
     return restaurantItems;
 }
     
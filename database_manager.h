@@ -9,8 +9,12 @@
 #include "models/MenuItem.h"
 #include "dataStructures/HashTable.h"
 #include "services/CityGraph.h"
+#include "services/RestaurantDirectory.h"
+#include "services/MenuGroups.h"
 #include "storage/SystemState.h"
+#include "storage/OnlineBackup.h"
 #include "services/UserService.h"
+#include "Logger.h"
 #include <iostream>
 
 using namespace std;
@@ -18,6 +22,9 @@ using namespace std;
 // Forward declaration
 class SystemState;
 
+// Data files covered by backupDatabase, without the .dat
+static const char* const BACKUP_FILES[] = { "users", "restaurants", "orders", "riders", "menu_items" };
+
 class DatabaseManager {
 private:
     Database db;
@@ -26,7 +33,7 @@ private:
     UserManager userManager;
     
     void createSampleMenuItems(int restaurantId, const string& restaurantName) {
-    cout << "Creating menu items for " << restaurantName << " (ID: " << restaurantId << ")\n";
+    LOG_DEBUG("Creating menu items for " << restaurantName << " (ID: " << restaurantId << ")");
     
     vector<MenuItem> menuItems;
     
@@ -68,11 +75,11 @@ private:
     // Save each menu item
     for (const auto& item : menuItems) {
         bool saved = db.saveMenuItem(item);
-        cout << "  " << (saved ? "✓" : "✗") << " Saved: " << item.getName() 
-             << " (ID: " << item.id << ")\n";
+        LOG_DEBUG("  " << (saved ? "✓" : "✗") << " Saved: " << item.getName() 
+             << " (ID: " << item.id << ")");
     }
     
-    cout << "  → Created " << menuItems.size() << " menu items\n";
+    LOG_DEBUG("  → Created " << menuItems.size() << " menu items");
 }
     /*UserData(int i, const string& n, const string& e, const string& p, 
              const string& r = "customer", const string& a = "", 
@@ -216,15 +223,14 @@ void createSampleRiders() {
                 restaurant.getRating(),
                 restaurant.getDeliveryTime()
             );
-            
-            for (const auto& item : allMenuItems) {
-                if (item.restaurantId == restaurant.getRestaurantId()) {
-                    newRestaurant.addMenuItemId(item.id);
-                }
-            }
-            
             restaurants.push_back(newRestaurant);
         }
+        
+        RestaurantDirectory directory;
+        directory.rebuild(restaurants);
+        MenuGroups menuGroups;
+        menuGroups.build(allMenuItems, directory);
+        menuGroups.attachTo(restaurants);
     }
     
     void loadRidersIntoHashTable() {
@@ -242,7 +248,7 @@ void createSampleRiders() {
         });
         
         if (!db.saveAllRiders(riders)) {
-            cout << "Error: Failed to save riders\n";
+            LOG_ERROR("Failed to save riders");
         }
     }
     
@@ -258,7 +264,7 @@ public:
     // Link SystemState
     void setSystemState(SystemState* state) {
         systemState = state;
-        cout << "DEBUG: SystemState linked to DatabaseManager\n";
+        LOG_DEBUG("SystemState linked to DatabaseManager");
     }
     
     // PUBLIC: Database access methods
@@ -303,44 +309,63 @@ public:
     }
     
     // PUBLIC: Database management
-    void backupDatabase() {
-        cout << "Creating database backup...\n";
+    
+    // Copies each data file to <name>_backup.dat as of one moment, while
+    // the server keeps writing; see OnlineBackup
+    // Adds every data file to backup, each to <name>_backup.dat
+    void addBackupFiles(OnlineBackup& backup) const {
+        for (const char* name : BACKUP_FILES) {
+            backup.add(string(name) + ".dat", string(name) + "_backup.dat");
+        }
+    }
+    
+    // Copies a frozen backup and reports how it went
+    bool copyBackup(OnlineBackup& backup) {
+        bool ok = backup.copy();
+        backup.logSummary();
         
-        #ifdef _WIN32
-            system("copy users.dat users_backup.dat >nul 2>&1");
-            system("copy restaurants.dat restaurants_backup.dat >nul 2>&1");
-            system("copy orders.dat orders_backup.dat >nul 2>&1");
-            system("copy riders.dat riders_backup.dat >nul 2>&1");
-            system("copy menu_items.dat menu_items_backup.dat >nul 2>&1");
-        #else
-            system("cp users.dat users_backup.dat 2>/dev/null");
-            system("cp restaurants.dat restaurants_backup.dat 2>/dev/null");
-            system("cp orders.dat orders_backup.dat 2>/dev/null");
-            system("cp riders.dat riders_backup.dat 2>/dev/null");
-            system("cp menu_items.dat menu_items_backup.dat 2>/dev/null");
-        #endif
+        cout << (ok ? "✓ Backup created successfully!\n" : "✗ Backup incomplete, see the log\n");
+        return ok;
+    }
+    
+    bool backupDatabase() {
+        cout << "Creating database backup...\n";
         
-        cout << "✓ Backup created successfully!\n";
+        OnlineBackup backup;
+        addBackupFiles(backup);
+#ifdef _WIN32
+        // Windows won't rename a file over one that is open, so writers
+        // wait for the whole copy, not just the opens
+        Database::FileGuard files(db);
+        backup.freeze();
+#else
+        {
+            // Writers wait only for the files to be opened
+            Database::FileGuard files(db);
+            backup.freeze();
+        }
+#endif
+        return copyBackup(backup);
     }
     
-    void restoreDatabase() {
+    bool restoreDatabase() {
         cout << "Restoring database from backup...\n";
         
-        #ifdef _WIN32
-            system("copy users_backup.dat users.dat >nul 2>&1");
-            system("copy restaurants_backup.dat restaurants.dat >nul 2>&1");
-            system("copy orders_backup.dat orders.dat >nul 2>&1");
-            system("copy riders_backup.dat riders.dat >nul 2>&1");
-            system("copy menu_items_backup.dat menu_items.dat >nul 2>&1");
-        #else
-            system("cp users_backup.dat users.dat 2>/dev/null");
-            system("cp restaurants_backup.dat restaurants.dat 2>/dev/null");
-            system("cp orders_backup.dat orders.dat 2>/dev/null");
-            system("cp riders_backup.dat riders.dat 2>/dev/null");
-            system("cp menu_items_backup.dat menu_items.dat 2>/dev/null");
-        #endif
+        OnlineBackup restore;
+        for (const char* name : BACKUP_FILES) {
+            restore.add(string(name) + "_backup.dat", string(name) + ".dat");
+        }
+        bool ok;
+        {
+            // Nothing may write the data files while they're being replaced
+            Database::FileGuard files(db);
+            restore.freeze();
+            ok = restore.copy();
+        }
+        restore.logSummary();
         
-        cout << "✓ Database restored from backup!\n";
+        cout << (ok ? "✓ Database restored from backup!\n" : "✗ Restore incomplete, see the log\n");
+        return ok;
     }
     
     void clearAllData() {
@@ -465,19 +490,19 @@ public:
     
     // 1. Save users from UserManager (always do this first)
     try {
-        cout << "DEBUG: Extracting users from UserManager...\n";
+        LOG_DEBUG("Extracting users from UserManager...");
         vector<UserData> users = userManager.getAllUsersAsVector();
-        cout << "DEBUG: Found " << users.size() << " users to save\n";
+        LOG_DEBUG("Found " << users.size() << " users to save");
         
         if (db.saveAllUsers(users)) {
             cout << "✓ Saved " << users.size() << " users\n";
             savedCount++;
         } else {
-            cout << "✗ Failed to save users\n";
+            LOG_ERROR("✗ Failed to save users");
             allSaved = false;
         }
     } catch (const exception& e) {
-        cout << "✗ Error saving users: " << e.what() << "\n";
+        LOG_ERROR("✗ Error saving users: " << e.what());
         allSaved = false;
     }
     
@@ -487,10 +512,10 @@ public:
         
         // Add restaurants from SystemState if available
         if (systemState != nullptr) {
-            cout << "DEBUG: Checking SystemState for additional restaurants...\n";
+            LOG_DEBUG("Checking SystemState for additional restaurants...");
             try {
                 vector<Restaurant> stateRestaurants = exportSystemStateRestaurants();
-                cout << "DEBUG: Found " << stateRestaurants.size() << " restaurants in SystemState\n";
+                LOG_DEBUG("Found " << stateRestaurants.size() << " restaurants in SystemState");
                 
                 for (const auto& r : stateRestaurants) {
                     bool exists = false;
@@ -505,61 +530,61 @@ public:
                     }
                 }
             } catch (const exception& e) {
-                cout << "⚠ Could not get restaurants from SystemState: " << e.what() << "\n";
+                LOG_WARN("⚠ Could not get restaurants from SystemState: " << e.what());
             }
         }
         
-        cout << "DEBUG: Saving " << allRestaurants.size() << " restaurants...\n";
+        LOG_DEBUG("Saving " << allRestaurants.size() << " restaurants...");
         if (db.saveAllRestaurants(allRestaurants)) {
             cout << "✓ Saved " << allRestaurants.size() << " restaurants\n";
             savedCount++;
         } else {
-            cout << "✗ Failed to save restaurants\n";
+            LOG_ERROR("✗ Failed to save restaurants");
             allSaved = false;
         }
     } catch (const exception& e) {
-        cout << "✗ Error saving restaurants: " << e.what() << "\n";
+        LOG_ERROR("✗ Error saving restaurants: " << e.what());
         allSaved = false;
     }
     
    // 3. Save menu items (load existing ones first)
 try {
-    cout << "DEBUG: Collecting and saving menu items...\n";
+    LOG_DEBUG("Collecting and saving menu items...");
     vector<MenuItem> allMenuItems = db.loadAllMenuItems();
     
     // DEBUG: Show what was loaded
-    cout << "DEBUG: Loaded " << allMenuItems.size() << " menu items from database\n";
+    LOG_DEBUG("Loaded " << allMenuItems.size() << " menu items from database");
     for (const auto& item : allMenuItems) {
-        cout << "  Item: ID=" << item.id << ", Restaurant=" << item.restaurantId 
-             << ", Name=" << item.getName() << ", Price=" << item.price << "\n";
+        LOG_DEBUG("  Item: ID=" << item.id << ", Restaurant=" << item.restaurantId 
+             << ", Name=" << item.getName() << ", Price=" << item.price);
     }
     
     // If no menu items in DB but we have restaurants, create sample items
     if (allMenuItems.empty()) {
-        cout << "DEBUG: No menu items found, checking restaurants...\n";
+        LOG_DEBUG("No menu items found, checking restaurants...");
         vector<Restaurant> existingRestaurants = db.loadAllRestaurants();
-        cout << "DEBUG: Found " << existingRestaurants.size() << " restaurants\n";
+        LOG_DEBUG("Found " << existingRestaurants.size() << " restaurants");
         
         for (const auto& restaurant : existingRestaurants) {
-            cout << "DEBUG: Creating menu items for " << restaurant.getName() 
-                 << " (ID: " << restaurant.getRestaurantId() << ")\n";
+            LOG_DEBUG("Creating menu items for " << restaurant.getName() 
+                 << " (ID: " << restaurant.getRestaurantId() << ")");
             createSampleMenuItems(restaurant.getRestaurantId(), restaurant.getName());
         }
         
         // Reload after creating
         allMenuItems = db.loadAllMenuItems();
-        cout << "DEBUG: Now have " << allMenuItems.size() << " menu items\n";
+        LOG_DEBUG("Now have " << allMenuItems.size() << " menu items");
     }
     
     if (db.saveAllMenuItems(allMenuItems)) {
         cout << "✓ Saved " << allMenuItems.size() << " menu items\n";
         savedCount++;
     } else {
-        cout << "✗ Failed to save menu items\n";
+        LOG_ERROR("✗ Failed to save menu items");
         allSaved = false;
     }
 } catch (const exception& e) {
-    cout << "✗ Error saving menu items: " << e.what() << "\n";
+    LOG_ERROR("✗ Error saving menu items: " << e.what());
     allSaved = false;
 }
     
@@ -569,10 +594,10 @@ try {
         
         // Add orders from SystemState if available
         if (systemState != nullptr) {
-            cout << "DEBUG: Checking SystemState for additional orders...\n";
+            LOG_DEBUG("Checking SystemState for additional orders...");
             try {
                 vector<Order> stateOrders = exportSystemStateOrders();
-                cout << "DEBUG: Found " << stateOrders.size() << " orders in SystemState\n";
+                LOG_DEBUG("Found " << stateOrders.size() << " orders in SystemState");
                 
                 for (const auto& o : stateOrders) {
                     bool exists = false;
@@ -587,20 +612,20 @@ try {
                     }
                 }
             } catch (const exception& e) {
-                cout << "⚠ Could not get orders from SystemState: " << e.what() << "\n";
+                LOG_WARN("⚠ Could not get orders from SystemState: " << e.what());
             }
         }
         
-        cout << "DEBUG: Saving " << allOrders.size() << " orders...\n";
+        LOG_DEBUG("Saving " << allOrders.size() << " orders...");
         if (db.saveAllOrders(allOrders)) {
             cout << "✓ Saved " << allOrders.size() << " orders\n";
             savedCount++;
         } else {
-            cout << "✗ Failed to save orders\n";
+            LOG_ERROR("✗ Failed to save orders");
             allSaved = false;
         }
     } catch (const exception& e) {
-        cout << "✗ Error saving orders: " << e.what() << "\n";
+        LOG_ERROR("✗ Error saving orders: " << e.what());
         allSaved = false;
     }
     
@@ -610,18 +635,18 @@ try {
         
         // Get riders from SystemState if available
         if (systemState != nullptr) {
-            cout << "DEBUG: Checking SystemState for riders...\n";
+            LOG_DEBUG("Checking SystemState for riders...");
             try {
                 vector<Rider> stateRiders = exportSystemStateRiders();
-                cout << "DEBUG: Found " << stateRiders.size() << " riders in SystemState\n";
+                LOG_DEBUG("Found " << stateRiders.size() << " riders in SystemState");
                 allRiders.insert(allRiders.end(), stateRiders.begin(), stateRiders.end());
             } catch (const exception& e) {
-                cout << "⚠ Could not get riders from SystemState: " << e.what() << "\n";
+                LOG_WARN("⚠ Could not get riders from SystemState: " << e.what());
             }
         }
         
         // Add riders from hash table
-        cout << "DEBUG: Collecting riders from hash table...\n";
+        LOG_DEBUG("Collecting riders from hash table...");
         ridersHashTable.traverse([&](int id, Rider& rider) {
             // Check if rider already exists in the vector
             bool exists = false;
@@ -638,7 +663,7 @@ try {
         
         // If no riders found, create sample riders
         if (allRiders.empty()) {
-            cout << "DEBUG: No riders found, creating sample riders...\n";
+            LOG_DEBUG("No riders found, creating sample riders...");
             createSampleRiders();
             
             // Re-collect from hash table after creating
@@ -647,26 +672,26 @@ try {
             });
         }
         
-        cout << "DEBUG: Saving " << allRiders.size() << " riders...\n";
+        LOG_DEBUG("Saving " << allRiders.size() << " riders...");
         if (db.saveAllRiders(allRiders)) {
             cout << "✓ Saved " << allRiders.size() << " riders\n";
             savedCount++;
         } else {
-            cout << "✗ Failed to save riders\n";
+            LOG_ERROR("✗ Failed to save riders");
             allSaved = false;
         }
     } catch (const exception& e) {
-        cout << "✗ Error saving riders: " << e.what() << "\n";
+        LOG_ERROR("✗ Error saving riders: " << e.what());
         allSaved = false;
     }
     
     // 6. Create a backup after saving
     try {
-        cout << "DEBUG: Creating backup of database...\n";
+        LOG_DEBUG("Creating backup of database...");
         backupDatabase();
         cout << "✓ Database backup created\n";
     } catch (const exception& e) {
-        cout << "⚠ Could not create backup: " << e.what() << "\n";
+        LOG_WARN("⚠ Could not create backup: " << e.what());
     }
     
     // 7. Final summary
@@ -0,0 +1,589 @@
+// load_generator.cpp - Multi-threaded load generator and latency benchmark for QuickBiteServer
+//
+// Every worker thread opens its own connection and runs a closed loop
+// (send, wait for reply, repeat) over a weighted command mix. Latencies
+// are recorded per command in log-linear histograms and reported as
+// p50/p99/p999. A run can be recorded to a JSONL trace and replayed
+// later against another build to catch performance regressions.
+//
+// Usage:
+//   load_generator [--host 127.0.0.1] [--port 8080] [--threads 8]
+//                  [--duration 10] [--requests 0]
+//                  [--mix LOGIN=5,GET_RESTAURANTS=20,...]
+//                  [--email ali@gmail.com] [--password itu123]
+//                  [--rider 10] [--seed 1]
+//                  [--record trace.jsonl] [--replay trace.jsonl] [--paced]
+#include "Client.h"
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <random>
+#include <chrono>
+#include <algorithm>
+
+#ifndef _WIN32
+    #include <thread>
+#endif
+
+using namespace std;
+using namespace std::chrono;
+
+// === LATENCY HISTOGRAM ===
+// Log-linear buckets over microseconds: exact below 64us, then 32
+// sub-buckets per power of two (about 3% relative error), so a whole
+// run fits in a fixed array and per-thread histograms merge by adding.
+class LatencyHistogram {
+private:
+    static const int SUB_BUCKETS = 32;
+    static const int LINEAR_LIMIT = 64;
+    static const int BUCKET_COUNT = LINEAR_LIMIT + 40 * SUB_BUCKETS;
+
+    vector<long long> buckets;
+    long long totalCount;
+    long long maxValue;
+    double sum;
+
+    static int bucketFor(long long value) {
+        if (value < LINEAR_LIMIT) return (int)max(0LL, value);
+
+        int msb = 0;
+        while ((value >> (msb + 1)) != 0) msb++;
+
+        int shift = msb - 5;
+        int index = LINEAR_LIMIT + (msb - 6) * SUB_BUCKETS + (int)((value >> shift) - SUB_BUCKETS);
+        return min(index, BUCKET_COUNT - 1);
+    }
+
+    static long long bucketUpperBound(int index) {
+        if (index < LINEAR_LIMIT) return index;
+
+        int offset = index - LINEAR_LIMIT;
+        int msb = offset / SUB_BUCKETS + 6;
+        long long sub = offset % SUB_BUCKETS;
+        long long width = 1LL << (msb - 5);
+        return (SUB_BUCKETS + sub) * width + width - 1;
+    }
+
+public:
+    LatencyHistogram() : buckets(BUCKET_COUNT, 0), totalCount(0), maxValue(0), sum(0) {}
+
+    void record(long long micros) {
+        buckets[bucketFor(micros)]++;
+        totalCount++;
+        maxValue = max(maxValue, micros);
+        sum += micros;
+    }
+
+    void merge(const LatencyHistogram& other) {
+        for (int i = 0; i < BUCKET_COUNT; i++) {
+            buckets[i] += other.buckets[i];
+        }
+        totalCount += other.totalCount;
+        maxValue = max(maxValue, other.maxValue);
+        sum += other.sum;
+    }
+
+    long long percentile(double p) const {
+        if (totalCount == 0) return 0;
+
+        long long target = (long long)(p / 100.0 * totalCount);
+        if (target >= totalCount) target = totalCount - 1;
+
+        long long seen = 0;
+        for (int i = 0; i < BUCKET_COUNT; i++) {
+            seen += buckets[i];
+            if (seen > target) return min(bucketUpperBound(i), maxValue);
+        }
+        return maxValue;
+    }
+
+    long long getCount() const { return totalCount; }
+    long long getMax() const { return maxValue; }
+    double getMean() const { return totalCount > 0 ? sum / totalCount : 0.0; }
+};
+
+// === TRACE FILES ===
+// One JSON object per line:
+//   {"offset_us":1234,"thread":0,"command":"GET_MENU","data":"1"}
+struct TraceEntry {
+    long long offsetMicros;
+    int thread;
+    string command;
+    string data;
+};
+
+string escapeJson(const string& input) {
+    string output;
+    for (char c : input) {
+        unsigned char byte = (unsigned char)c;
+        if (c == '"' || c == '\\') {
+            output += '\\';
+            output += c;
+        } else if (c == '\n') {
+            output += "\\n";
+        } else if (c == '\r') {
+            output += "\\r";
+        } else if (c == '\t') {
+            output += "\\t";
+        } else if (byte < 0x20) {
+            // Other control bytes would break the one-object-per-line format
+            static const char hex[] = "0123456789abcdef";
+            output += "\\u00";
+            output += hex[byte >> 4];
+            output += hex[byte & 0xf];
+        } else {
+            output += c;
+        }
+    }
+    return output;
+}
+
+string extractJsonField(const string& line, const string& key) {
+    string search = "\"" + key + "\":";
+    size_t pos = line.find(search);
+    if (pos == string::npos) return "";
+    pos += search.length();
+
+    if (pos < line.length() && line[pos] == '"') {
+        string value;
+        for (size_t i = pos + 1; i < line.length() && line[i] != '"'; i++) {
+            if (line[i] != '\\' || i + 1 >= line.length()) {
+                value += line[i];
+                continue;
+            }
+            char escaped = line[++i];
+            if (escaped == 'n') value += '\n';
+            else if (escaped == 'r') value += '\r';
+            else if (escaped == 't') value += '\t';
+            else if (escaped == 'u' && i + 4 < line.length()) {
+                value += (char)strtol(line.substr(i + 1, 4).c_str(), nullptr, 16);
+                i += 4;
+            } else value += escaped;
+        }
+        return value;
+    }
+
+    size_t end = line.find_first_of(",}", pos);
+    return line.substr(pos, end == string::npos ? string::npos : end - pos);
+}
+
+bool writeTrace(const string& path, vector<TraceEntry> entries) {
+    stable_sort(entries.begin(), entries.end(), [](const TraceEntry& a, const TraceEntry& b) {
+        return a.offsetMicros < b.offsetMicros;
+    });
+
+    ofstream file(path);
+    if (!file) return false;
+
+    for (const auto& entry : entries) {
+        file << "{\"offset_us\":" << entry.offsetMicros
+             << ",\"thread\":" << entry.thread
+             << ",\"command\":\"" << escapeJson(entry.command)
+             << "\",\"data\":\"" << escapeJson(entry.data) << "\"}\n";
+    }
+    return true;
+}
+
+vector<TraceEntry> readTrace(const string& path) {
+    vector<TraceEntry> entries;
+    ifstream file(path);
+    string line;
+
+    while (getline(file, line)) {
+        string command = extractJsonField(line, "command");
+        if (command.empty()) continue;   // blank or malformed line
+
+        TraceEntry entry;
+        string offset = extractJsonField(line, "offset_us");
+        string thread = extractJsonField(line, "thread");
+        entry.offsetMicros = offset.empty() ? 0 : stoll(offset);
+        entry.thread = thread.empty() ? 0 : stoi(thread);
+        entry.command = command;
+        entry.data = extractJsonField(line, "data");
+        entries.push_back(entry);
+    }
+    return entries;
+}
+
+// === CONFIGURATION ===
+struct LoadConfig {
+    string host;
+    int port;
+    int threads;
+    int durationSeconds;
+    int requestsPerThread;       // 0 = run for durationSeconds
+    vector<pair<string, int>> mix;
+    string email;
+    string password;
+    int riderId;
+    unsigned int seed;
+    string recordPath;
+    string replayPath;
+    bool paced;                  // replay honouring recorded offsets
+
+    LoadConfig() : host("127.0.0.1"), port(8080), threads(8), durationSeconds(10),
+                   requestsPerThread(0), email("ali@gmail.com"), password("itu123"),
+                   riderId(10), seed(1), paced(false) {
+        mix = {
+            {"LOGIN", 5},
+            {"GET_RESTAURANTS", 25},
+            {"GET_MENU", 30},
+            {"PLACE_ORDER", 10},
+            {"GET_AVAILABLE_ORDERS", 15},
+            {"GET_RIDER_ORDERS", 10},
+            {"UPDATE_ORDER_STATUS", 5}
+        };
+    }
+};
+
+bool parseMix(const string& text, vector<pair<string, int>>& mix) {
+    vector<pair<string, int>> parsed;
+    stringstream ss(text);
+    string entry;
+
+    while (getline(ss, entry, ',')) {
+        size_t eq = entry.find('=');
+        if (eq == string::npos) return false;
+        parsed.push_back({entry.substr(0, eq), stoi(entry.substr(eq + 1))});
+    }
+
+    if (parsed.empty()) return false;
+    mix = parsed;
+    return true;
+}
+
+// === WORKER ===
+class LoadWorker {
+private:
+    int index;
+    const LoadConfig* config;
+    const vector<TraceEntry>* replayEntries;   // entries for this worker when replaying
+    steady_clock::time_point runStart;
+
+    QuickBiteClient client;
+    mt19937 rng;
+    vector<int> restaurantIds;
+    map<int, vector<int>> menuItemIds;
+    vector<int> placedOrders;
+
+    string pickCommand() {
+        int totalWeight = 0;
+        for (const auto& entry : config->mix) totalWeight += entry.second;
+
+        int roll = uniform_int_distribution<int>(0, max(0, totalWeight - 1))(rng);
+        for (const auto& entry : config->mix) {
+            if (roll < entry.second) return entry.first;
+            roll -= entry.second;
+        }
+        return "PING";
+    }
+
+    static vector<string> splitResponse(const string& response) {
+        vector<string> parts;
+        if (response.substr(0, 7) != "SUCCESS" || response.length() <= 8) return parts;
+
+        stringstream ss(response.substr(8));
+        string part;
+        while (getline(ss, part, '|')) parts.push_back(part);
+        return parts;
+    }
+
+    // Catalog lookups are setup, not measured
+    void loadCatalog() {
+        for (const auto& restaurant : splitResponse(client.sendCommand("GET_RESTAURANTS"))) {
+            size_t semi = restaurant.find(';');
+            if (semi == string::npos) continue;
+
+            int restaurantId = stoi(restaurant.substr(0, semi));
+            restaurantIds.push_back(restaurantId);
+
+            for (const auto& item : splitResponse(client.sendCommand("GET_MENU", to_string(restaurantId)))) {
+                size_t itemSemi = item.find(';');
+                if (itemSemi != string::npos) {
+                    menuItemIds[restaurantId].push_back(stoi(item.substr(0, itemSemi)));
+                }
+            }
+        }
+    }
+
+    template <typename T>
+    T pickFrom(const vector<T>& values) {
+        return values[uniform_int_distribution<size_t>(0, values.size() - 1)(rng)];
+    }
+
+    // Builds the payload for a command; falls back to a read if state is missing
+    void buildRequest(string& command, string& data) {
+        if (command == "LOGIN") {
+            data = config->email + "|" + config->password;
+        } else if (command == "GET_MENU" && !restaurantIds.empty()) {
+            data = to_string(pickFrom(restaurantIds));
+        } else if (command == "PLACE_ORDER" && !restaurantIds.empty() && client.getUserId() != -1) {
+            int restaurantId = pickFrom(restaurantIds);
+            const vector<int>& items = menuItemIds[restaurantId];
+            if (items.empty()) {
+                command = "GET_MENU";
+                data = to_string(restaurantId);
+                return;
+            }
+            data = to_string(client.getUserId()) + "|" + to_string(restaurantId) + "|" +
+                   to_string(pickFrom(items)) + ":1";
+        } else if (command == "GET_RIDER_ORDERS") {
+            data = to_string(config->riderId);
+        } else if (command == "UPDATE_ORDER_STATUS" && !placedOrders.empty()) {
+            data = to_string(pickFrom(placedOrders)) + "|Preparing";
+        } else if (command == "GET_MENU" || command == "PLACE_ORDER" || command == "UPDATE_ORDER_STATUS") {
+            command = "GET_RESTAURANTS";
+            data = "";
+        } else {
+            data = "";
+        }
+    }
+
+    void issue(const string& command, const string& data) {
+        steady_clock::time_point sent = steady_clock::now();
+        string response = client.sendCommand(command, data);
+        long long micros = duration_cast<microseconds>(steady_clock::now() - sent).count();
+
+        histograms[command].record(micros);
+        total.record(micros);
+        if (response.substr(0, 5) == "ERROR") errors++;
+
+        if (config->recordPath.length() > 0) {
+            TraceEntry entry;
+            entry.offsetMicros = duration_cast<microseconds>(sent - runStart).count();
+            entry.thread = index;
+            entry.command = command;
+            entry.data = data;
+            trace.push_back(entry);
+        }
+
+        if (command == "PLACE_ORDER" && response.substr(0, 7) == "SUCCESS") {
+            placedOrders.push_back(stoi(response.substr(8)));
+        }
+    }
+
+    void runMix() {
+        client.login(config->email, config->password);
+        loadCatalog();
+
+        steady_clock::time_point deadline = runStart + seconds(config->durationSeconds);
+        long long issued = 0;
+
+        while (client.isConnected()) {
+            if (config->requestsPerThread > 0) {
+                if (issued >= config->requestsPerThread) break;
+            } else if (steady_clock::now() >= deadline) {
+                break;
+            }
+
+            string command = pickCommand();
+            string data;
+            buildRequest(command, data);
+            issue(command, data);
+            issued++;
+        }
+    }
+
+    void runReplay() {
+        for (const auto& entry : *replayEntries) {
+            if (!client.isConnected()) break;
+
+            if (config->paced) {
+                steady_clock::time_point due = runStart + microseconds(entry.offsetMicros);
+                while (steady_clock::now() < due) {
+#ifdef _WIN32
+                    Sleep(0);
+#else
+                    this_thread::yield();
+#endif
+                }
+            }
+            issue(entry.command, entry.data);
+        }
+    }
+
+public:
+    map<string, LatencyHistogram> histograms;
+    LatencyHistogram total;
+    long long errors;
+    vector<TraceEntry> trace;
+    bool connectFailed;
+
+    LoadWorker(int workerIndex, const LoadConfig* cfg, const vector<TraceEntry>* replay,
+               steady_clock::time_point start)
+        : index(workerIndex), config(cfg), replayEntries(replay), runStart(start),
+          client(cfg->host, cfg->port), rng(cfg->seed + workerIndex),
+          errors(0), connectFailed(false) {}
+
+    void run() {
+        if (!client.connectToServer()) {
+            connectFailed = true;
+            return;
+        }
+
+        if (replayEntries) runReplay();
+        else runMix();
+
+        client.disconnect();
+    }
+};
+
+#ifdef _WIN32
+static DWORD WINAPI runWorkerStatic(LPVOID lpParam) {
+    ((LoadWorker*)lpParam)->run();
+    return 0;
+}
+#endif
+
+// === REPORT ===
+void printRow(const string& name, const LatencyHistogram& h, double elapsedSeconds) {
+    cout << left << setw(22) << name << right
+         << setw(10) << h.getCount()
+         << setw(11) << fixed << setprecision(1) << h.getCount() / elapsedSeconds
+         << setw(10) << setprecision(3) << h.getMean() / 1000.0
+         << setw(10) << h.percentile(50) / 1000.0
+         << setw(10) << h.percentile(99) / 1000.0
+         << setw(10) << h.percentile(99.9) / 1000.0
+         << setw(10) << h.getMax() / 1000.0 << "\n";
+}
+
+void printUsage() {
+    cout << "Usage: load_generator [--host IP] [--port N] [--threads N] [--duration SEC]\n"
+         << "                      [--requests N] [--mix CMD=W,CMD=W,...]\n"
+         << "                      [--email E] [--password P] [--rider ID] [--seed N]\n"
+         << "                      [--record FILE] [--replay FILE] [--paced]\n";
+}
+
+int main(int argc, char* argv[]) {
+    LoadConfig config;
+
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (arg == "--paced") config.paced = true;
+        else if (arg == "--help") { printUsage(); return 0; }
+        else if (!hasValue) { printUsage(); return 1; }
+        else if (arg == "--host") config.host = argv[++i];
+        else if (arg == "--port") config.port = stoi(argv[++i]);
+        else if (arg == "--threads") config.threads = max(1, stoi(argv[++i]));
+        else if (arg == "--duration") config.durationSeconds = stoi(argv[++i]);
+        else if (arg == "--requests") config.requestsPerThread = stoi(argv[++i]);
+        else if (arg == "--email") config.email = argv[++i];
+        else if (arg == "--password") config.password = argv[++i];
+        else if (arg == "--rider") config.riderId = stoi(argv[++i]);
+        else if (arg == "--seed") config.seed = (unsigned int)stoul(argv[++i]);
+        else if (arg == "--record") config.recordPath = argv[++i];
+        else if (arg == "--replay") config.replayPath = argv[++i];
+        else if (arg == "--mix") {
+            if (!parseMix(argv[++i], config.mix)) {
+                cerr << "✗ Invalid --mix, expected CMD=WEIGHT,CMD=WEIGHT\n";
+                return 1;
+            }
+        } else {
+            printUsage();
+            return 1;
+        }
+    }
+
+    // Replayed requests keep their recorded thread, folded onto --threads
+    vector<vector<TraceEntry>> replayPerThread;
+    if (!config.replayPath.empty()) {
+        vector<TraceEntry> entries = readTrace(config.replayPath);
+        if (entries.empty()) {
+            cerr << "✗ No requests found in trace " << config.replayPath << "\n";
+            return 1;
+        }
+
+        replayPerThread.resize(config.threads);
+        for (const auto& entry : entries) {
+            replayPerThread[entry.thread % config.threads].push_back(entry);
+        }
+        cout << "Replaying " << entries.size() << " requests from " << config.replayPath << "\n";
+    }
+
+    cout << "Target: " << config.host << ":" << config.port
+         << ", threads: " << config.threads << "\n";
+
+    steady_clock::time_point start = steady_clock::now();
+
+    vector<LoadWorker*> workers;
+    for (int i = 0; i < config.threads; i++) {
+        workers.push_back(new LoadWorker(i, &config,
+                                         replayPerThread.empty() ? nullptr : &replayPerThread[i],
+                                         start));
+    }
+
+#ifdef _WIN32
+    vector<HANDLE> handles;
+    for (auto* worker : workers) {
+        HANDLE handle = CreateThread(NULL, 0, runWorkerStatic, worker, 0, NULL);
+        if (handle) handles.push_back(handle);
+    }
+    for (HANDLE handle : handles) {
+        WaitForSingleObject(handle, INFINITE);
+        CloseHandle(handle);
+    }
+#else
+    vector<thread> threads;
+    for (auto* worker : workers) {
+        threads.push_back(thread(&LoadWorker::run, worker));
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+#endif
+
+    double elapsedSeconds = duration_cast<microseconds>(steady_clock::now() - start).count() / 1e6;
+
+    map<string, LatencyHistogram> perCommand;
+    LatencyHistogram total;
+    long long errors = 0;
+    int failedConnections = 0;
+    vector<TraceEntry> trace;
+
+    for (auto* worker : workers) {
+        for (const auto& entry : worker->histograms) {
+            perCommand[entry.first].merge(entry.second);
+        }
+        total.merge(worker->total);
+        errors += worker->errors;
+        if (worker->connectFailed) failedConnections++;
+        trace.insert(trace.end(), worker->trace.begin(), worker->trace.end());
+        delete worker;
+    }
+
+    cout << "\n========================================\n";
+    cout << "   LOAD TEST RESULTS\n";
+    cout << "========================================\n";
+    cout << "Elapsed: " << fixed << setprecision(2) << elapsedSeconds << " s"
+         << ", requests: " << total.getCount()
+         << ", errors: " << errors;
+    if (failedConnections > 0) cout << ", failed connections: " << failedConnections;
+    cout << "\n\n";
+
+    cout << left << setw(22) << "Command" << right
+         << setw(10) << "Count" << setw(11) << "Req/s" << setw(10) << "Mean ms"
+         << setw(10) << "p50 ms" << setw(10) << "p99 ms" << setw(10) << "p999 ms"
+         << setw(10) << "Max ms" << "\n";
+    cout << string(93, '-') << "\n";
+    for (const auto& entry : perCommand) {
+        printRow(entry.first, entry.second, elapsedSeconds);
+    }
+    cout << string(93, '-') << "\n";
+    printRow("TOTAL", total, elapsedSeconds);
+
+    if (!config.recordPath.empty()) {
+        if (writeTrace(config.recordPath, trace)) {
+            cout << "\n✓ Recorded " << trace.size() << " requests to " << config.recordPath << "\n";
+        } else {
+            cerr << "\n✗ Failed to write trace " << config.recordPath << "\n";
+        }
+    }
+
+    return failedConnections == config.threads ? 1 : 0;
+}
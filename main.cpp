@@ -15,6 +15,8 @@
 #include "models/MenuItem.h"
 #include "services/CityGraph.h"
 #include "services/DeliveryAssignment.h"
+#include "services/RestaurantDirectory.h"
+#include "services/MenuGroups.h"
 #include "dataStructures/HashTable.h"
 #include "Database_manager.h"
 #include "models/CityMapData.h"
@@ -145,6 +147,15 @@ int main() {
             }
         }
         
+        // No RiderService here; riders are matched from the loaded table
+        deliverySystem.setFleet(&dbManager.getRidersHashTable());
+        
+        // Optional time-of-day traffic per road for routing and ETAs
+        if (deliverySystem.loadSpeedProfiles("speed_profiles.txt")) {
+            cout << "✓ Speed profiles loaded\n";
+            cout << flush;
+        }
+        
         // ===== STEP 4: Load all existing data from database =====
         cout << "DEBUG: Calling loadFromDatabase()\n";
         cout << flush;
@@ -334,39 +345,21 @@ void loadFromDatabase() {
         cout << "DEBUG: Found " << allMenuItems.size() << " menu items\n";
         cout << flush;
         
-        // STEP 4: Associate Menu Items - SIMPLIFIED VERSION
+        // STEP 4: Associate Menu Items - one grouping pass over the catalog
         if (!restaurants.empty() && !allMenuItems.empty()) {
-            cout << "DEBUG: Starting menu association loop...\n";
-            cout << flush;
+            RestaurantDirectory directory;
+            directory.rebuild(restaurants);
             
-            // Use simple nested loop with size_t to avoid any issues
-            size_t restCount = restaurants.size();
-            size_t itemCount = allMenuItems.size();
+            MenuGroups menuGroups;
+            menuGroups.build(allMenuItems, directory);
+            size_t attached = menuGroups.attachTo(restaurants);
             
-            cout << "DEBUG: Will process " << restCount << " restaurants and " 
-                 << itemCount << " items\n";
-            cout << flush;
-            
-            for (size_t i = 0; i < restCount; i++) {
-                cout << "DEBUG: Processing restaurant index " << i << "\n";
-                cout << flush;
-                
-                int restaurantId = restaurants[i].getRestaurantId();
-                int menuCount = 0;
-                
-                for (size_t j = 0; j < itemCount; j++) {
-                    if (allMenuItems[j].restaurantId == restaurantId) {
-                        restaurants[i].addMenuItemId(allMenuItems[j].id);
-                        menuCount++;
-                    }
-                }
-                
-                cout << "DEBUG: Restaurant " << restaurantId 
-                     << " has " << menuCount << " menu items\n";
-                cout << flush;
+            cout << "DEBUG: Attached " << attached << " menu items to " 
+                 << restaurants.size() << " restaurants";
+            if (menuGroups.getUnmatchedCount() > 0) {
+                cout << " (" << menuGroups.getUnmatchedCount() << " items have no restaurant)";
             }
-            
-            cout << "DEBUG: Menu association completed\n";
+            cout << "\n";
             cout << flush;
         } else {
             cout << "DEBUG: Skipping menu item association\n";
@@ -1588,8 +1581,12 @@ void manageCityMap() {
                 cin >> nodeId;
                 cin.ignore();
                 
-                if (cityGraph.removeLocation(nodeId)) {
+                vector<RoadData> closedRoads;
+                if (cityGraph.removeLocation(nodeId, &closedRoads)) {
                     cityGraph.saveToDatabase();
+                    for (const auto& road : closedRoads) {
+                        deliverySystem.roadChanged(road.fromNode, road.toNode, road.distance, -1);
+                    }
                     cout << "\n✓ Location removed successfully!\n";
                 } else {
                     cout << "\n✗ Location not found!\n";
@@ -1621,9 +1618,11 @@ void manageCityMap() {
                 } else if (distance <= 0) {
                     cout << "\n✗ Invalid distance!\n";
                 } else {
-                    cityGraph.addRoad(from, to, distance);
+                    int previous = cityGraph.addRoad(from, to, distance);
                     cityGraph.saveToDatabase();
-                    cout << "\n✓ Road added successfully!\n";
+                    int repaired = deliverySystem.roadChanged(from, to, previous, distance);
+                    cout << "\n✓ Road " << (previous < 0 ? "added" : "updated") << " successfully! ("
+                         << repaired << " cached route nodes re-routed)\n";
                     cout << cityGraph.getLocationName(from) << " ↔ " 
                          << cityGraph.getLocationName(to) 
                          << " (" << distance << "m)\n";
@@ -1646,10 +1645,14 @@ void manageCityMap() {
                 cin >> to;
                 cin.ignore();
                 
-                cityGraph.removeRoad(from, to);
-                cityGraph.saveToDatabase();
-                
-                cout << "\n✓ Road removed (if it existed)!\n";
+                int previous = cityGraph.removeRoad(from, to);
+                if (previous < 0) {
+                    cout << "\n✗ No road between those locations!\n";
+                } else {
+                    cityGraph.saveToDatabase();
+                    int repaired = deliverySystem.roadChanged(from, to, previous, -1);
+                    cout << "\n✓ Road removed! (" << repaired << " cached route nodes re-routed)\n";
+                }
                 pauseScreen();
                 break;
             }
@@ -2501,7 +2504,9 @@ void checkAndFixCorruptedDatabase() {
         size_t fileSize = restFile.tellg();
         restFile.close();
         
-        if (fileSize % sizeof(Restaurant) != 0 && fileSize != 0) {
+        if (fileSize % sizeof(Restaurant) != 0 && fileSize != 0 &&
+            !PagedRecordFile::isContainer("restaurants.dat") &&
+            !RestaurantMigration::isLegacyFile("restaurants.dat")) {
             cout << "⚠️  Corrupted: restaurants.dat\n";
             cout << "   Clearing...\n";
             
@@ -2522,7 +2527,8 @@ void checkAndFixCorruptedDatabase() {
         size_t fileSize = orderFile.tellg();
         orderFile.close();
         
-        if (fileSize % sizeof(Order) != 0 && fileSize != 0) {
+        if (fileSize % sizeof(Order) != 0 && fileSize != 0 &&
+            !PagedRecordFile::isContainer("orders.dat")) {
             cout << "⚠️  Corrupted: orders.dat\n";
             cout << "   Clearing...\n";
             
@@ -0,0 +1,59 @@
+// migrate_data.cpp - Upgrades the .dat files in the current directory to the current layout
+//
+// restaurants.dat used to embed up to 50 full menu items in every record.
+// Run this once in the data directory to rewrite it with the slim
+// Restaurant record and move the embedded items into menu_items.dat. The
+// server does the same on startup; the tool lets it be done (or checked)
+// ahead of time. The original file is kept as restaurants.dat.legacy.
+//
+// Usage:
+//   migrate_data [--check]
+#include "Database.h"
+#include "RestaurantMigration.h"
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+int main(int argc, char* argv[]) {
+    bool checkOnly = false;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--check") checkOnly = true;
+        else {
+            cout << "Usage: migrate_data [--check]\n";
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+
+    const string restaurantFile = "restaurants.dat";
+    if (!RestaurantMigration::isLegacyFile(restaurantFile)) {
+        cout << "✓ " << restaurantFile << " is already in the current layout (or absent)\n";
+        return 0;
+    }
+
+    vector<Restaurant> restaurants;
+    vector<MenuItem> menuItems;
+    if (!RestaurantMigration::readLegacy(restaurantFile, restaurants, menuItems)) {
+        cout << "✗ " << restaurantFile << " has the legacy size but its records don't read back\n";
+        return 1;
+    }
+
+    cout << restaurantFile << ": " << restaurants.size() << " legacy restaurants, "
+         << menuItems.size() << " embedded menu items\n";
+    cout << "  record size " << sizeof(LegacyRestaurantRecord) << " -> "
+         << sizeof(Restaurant) << " bytes\n";
+    if (checkOnly) return 0;
+
+    Database db;
+    if (!db.migrateLegacyRestaurants()) {
+        cout << "✗ Migration failed, " << restaurantFile << " left as it was\n";
+        return 1;
+    }
+
+    cout << "✓ Migrated; original kept as " << restaurantFile << ".legacy\n";
+    cout << "  restaurants: " << db.loadAllRestaurants().size()
+         << ", menu items: " << db.loadAllMenuItems().size() << "\n";
+    return 0;
+}
@@ -101,6 +101,30 @@ public:
     int getRiderID() const { return riderId; }
     string getDeliveryAddress() const { return string(deliveryAddress); }
     
+    // Why this record can't be one the program wrote, or nullptr: ids or
+    // counts out of range, a status past the last OrderStatus, a string
+    // missing its terminator, an amount that isn't a price. Used to tell
+    // records from garbage when salvaging a damaged file.
+    const char* fieldError() const {
+        const int maxItems = (int)(sizeof(items) / sizeof(items[0]));
+        const int maxRestaurants = (int)(sizeof(restaurantIds) / sizeof(restaurantIds[0]));
+        
+        if (id <= 0 || customerId < 0 || restaurantId < 0 || riderId < -1) return "id out of range";
+        if (statusInt < 0 || statusInt > (int)OrderStatus::Cancelled) return "status out of range";
+        if (itemCount < 0 || itemCount > maxItems || restaurantCount < 0 || restaurantCount > maxRestaurants) {
+            return "count out of range";
+        }
+        if (!memchr(deliveryAddress, '\0', sizeof(deliveryAddress))) return "unterminated string";
+        if (!(totalAmount >= 0 && totalAmount < 1e9)) return "amount out of range";
+        for (int i = 0; i < itemCount; i++) {
+            if (!memchr(items[i].itemName, '\0', sizeof(items[i].itemName))) return "unterminated string";
+            if (items[i].quantity < 0 || !(items[i].price >= 0 && items[i].price < 1e9)) {
+                return "amount out of range";
+            }
+        }
+        return nullptr;
+    }
+    
     OrderStatus getStatusEnum() const {
         return static_cast<OrderStatus>(statusInt);
     }
@@ -21,9 +21,9 @@ private:
     int locationNode;
     double rating;
     int deliveryTime;
-    MenuItem menuItems[50];
-    int menuItemCount;
     
+    // The menu itself lives in menu_items.dat; a restaurant only keeps the
+    // ids so the record stays small enough to copy and page around.
     // CRITICAL: Don't use vector in serialized class!
     // Use fixed array instead
     int menuItemIdsArray[50];  // Fixed size array
@@ -31,7 +31,7 @@ private:
 
 public:
     Restaurant() : restaurantId(0), locationNode(0), rating(0.0), 
-                   deliveryTime(0), menuItemCount(0), menuItemIdsCount(0) {
+                   deliveryTime(0), menuItemIdsCount(0) {
         memset(name, 0, sizeof(name));
         memset(address, 0, sizeof(address));
         memset(phone, 0, sizeof(phone));
@@ -42,7 +42,7 @@ public:
     Restaurant(int id, const string& n, const string& addr, const string& ph,
                const string& cuis, int location, double rat = 4.0, int delTime = 30)
         : restaurantId(id), locationNode(location), rating(rat), 
-          deliveryTime(delTime), menuItemCount(0), menuItemIdsCount(0) {
+          deliveryTime(delTime), menuItemIdsCount(0) {
         strncpy(name, n.c_str(), sizeof(name) - 1);
         name[sizeof(name) - 1] = '\0';
         
@@ -62,7 +62,7 @@ public:
     Restaurant(int id, const string& n, const string& cuis, const string& addr,
                double rat, int delTime)
         : restaurantId(id), rating(rat), deliveryTime(delTime),
-          menuItemCount(0), menuItemIdsCount(0), locationNode(0) {
+          menuItemIdsCount(0), locationNode(0) {
         strncpy(name, n.c_str(), sizeof(name) - 1);
         name[sizeof(name) - 1] = '\0';
         
@@ -82,14 +82,12 @@ public:
           locationNode(other.locationNode),
           rating(other.rating),
           deliveryTime(other.deliveryTime),
-          menuItemCount(other.menuItemCount),
           menuItemIdsCount(other.menuItemIdsCount) {
         
         memcpy(name, other.name, sizeof(name));
         memcpy(address, other.address, sizeof(address));
         memcpy(phone, other.phone, sizeof(phone));
         memcpy(cuisine, other.cuisine, sizeof(cuisine));
-        memcpy(menuItems, other.menuItems, sizeof(menuItems));
         memcpy(menuItemIdsArray, other.menuItemIdsArray, sizeof(menuItemIdsArray));
     }
     
@@ -100,14 +98,12 @@ public:
             locationNode = other.locationNode;
             rating = other.rating;
             deliveryTime = other.deliveryTime;
-            menuItemCount = other.menuItemCount;
             menuItemIdsCount = other.menuItemIdsCount;
             
             memcpy(name, other.name, sizeof(name));
             memcpy(address, other.address, sizeof(address));
             memcpy(phone, other.phone, sizeof(phone));
             memcpy(cuisine, other.cuisine, sizeof(cuisine));
-            memcpy(menuItems, other.menuItems, sizeof(menuItems));
             memcpy(menuItemIdsArray, other.menuItemIdsArray, sizeof(menuItemIdsArray));
         }
         return *this;
@@ -122,9 +118,25 @@ public:
     int getLocationNode() const { return locationNode; }
     double getRating() const { return rating; }
     int getDeliveryTime() const { return deliveryTime; }
-    int getMenuItemCount() const { return menuItemCount; }
+    int getMenuItemCount() const { return menuItemIdsCount; }
     int getMenuItemIdsCount() const { return menuItemIdsCount; }
     
+    // Why this record can't be one the program wrote, or nullptr; used to
+    // tell restaurants from garbage when salvaging a damaged file
+    const char* fieldError() const {
+        const int maxMenuItems = (int)(sizeof(menuItemIdsArray) / sizeof(menuItemIdsArray[0]));
+        
+        if (restaurantId <= 0 || locationNode < 0) return "id out of range";
+        if (!memchr(name, '\0', sizeof(name)) || !memchr(address, '\0', sizeof(address)) ||
+            !memchr(phone, '\0', sizeof(phone)) || !memchr(cuisine, '\0', sizeof(cuisine))) {
+            return "unterminated string";
+        }
+        if (name[0] == '\0') return "empty name";
+        if (!(rating >= 0 && rating <= 5)) return "rating out of range";
+        if (deliveryTime < 0 || menuItemIdsCount < 0 || menuItemIdsCount > maxMenuItems) return "count out of range";
+        return nullptr;
+    }
+    
     // Setters
     void setName(const string& n) {
         strncpy(name, n.c_str(), sizeof(name) - 1);
@@ -150,17 +162,6 @@ public:
     void setDeliveryTime(int time) { deliveryTime = time; }
     
     // Menu item management
-    bool addMenuItem(const MenuItem& item) {
-        if (hasMenuItem(item.id)) return false;
-        
-        if (menuItemCount < 50) {
-            menuItems[menuItemCount] = item;
-            menuItemCount++;
-        }
-        
-        return addMenuItemId(item.id);
-    }
-    
     bool addMenuItemId(int itemId) {
         // Check if already exists
         if (hasMenuItemId(itemId)) return false;
@@ -183,27 +184,7 @@ public:
         return false;
     }
     
-    bool hasMenuItem(int itemId) const {
-        for (int i = 0; i < menuItemCount; i++) {
-            if (menuItems[i].id == itemId) {
-                return true;
-            }
-        }
-        return false;
-    }
-    
-    MenuItem* getMenuItem(int itemId) {
-        for (int i = 0; i < menuItemCount; i++) {
-            if (menuItems[i].id == itemId) {
-                return &menuItems[i];
-            }
-        }
-        return nullptr;
-    }
-    
-    // FIXED: Remove menu item ID from both arrays
     void removeMenuItemId(int itemId) {
-        // Remove from menuItemIdsArray
         for (int i = 0; i < menuItemIdsCount; i++) {
             if (menuItemIdsArray[i] == itemId) {
                 // Shift all elements after i left by one position
@@ -212,40 +193,11 @@ public:
                 }
                 menuItemIdsArray[menuItemIdsCount - 1] = 0;
                 menuItemIdsCount--;
-                
-                // Also remove from menuItems array if present
-                for (int k = 0; k < menuItemCount; k++) {
-                    if (menuItems[k].id == itemId) {
-                        // Shift all elements after k left by one position
-                        for (int l = k; l < menuItemCount - 1; l++) {
-                            menuItems[l] = menuItems[l + 1];
-                        }
-                        // Clear the last element
-                        memset(&menuItems[menuItemCount - 1], 0, sizeof(MenuItem));
-                        menuItemCount--;
-                        break;
-                    }
-                }
                 return;
             }
         }
     }
     
-    void printMenu() const {
-        if (menuItemCount == 0) {
-            cout << "No menu items available.\n";
-            return;
-        }
-        
-        for (int i = 0; i < menuItemCount; i++) {
-            cout << "  [" << menuItems[i].id << "] " << menuItems[i].name << "\n";
-            cout << "      " << menuItems[i].description << "\n";
-            cout << "      Price: $" << menuItems[i].price << "\n";
-            cout << "      Stock: " << menuItems[i].stock << "\n";
-            cout << "      Category: " << menuItems[i].category << "\n\n";
-        }
-    }
-    
     void printDetails() const {
         cout << "Restaurant ID: " << restaurantId << "\n";
         cout << "Name: " << name << "\n";
@@ -255,8 +207,7 @@ public:
         cout << "Location Node: " << locationNode << "\n";
         cout << "Rating: " << rating << "/5\n";
         cout << "Delivery Time: " << deliveryTime << " minutes\n";
-        cout << "Menu Items: " << menuItemCount << "\n";
-        cout << "Menu Item IDs: " << menuItemIdsCount << "\n";
+        cout << "Menu Items: " << menuItemIdsCount << "\n";
     }
     
     // Get all menu item IDs as vector (for compatibility)
@@ -268,20 +219,9 @@ public:
         return ids;
     }
     
-    // Get menu items as vector
-    vector<MenuItem> getMenuItems() const {
-        vector<MenuItem> items;
-        for (int i = 0; i < menuItemCount; i++) {
-            items.push_back(menuItems[i]);
-        }
-        return items;
-    }
-    
     // Clear all menu items
     void clearMenu() {
-        menuItemCount = 0;
         menuItemIdsCount = 0;
-        memset(menuItems, 0, sizeof(menuItems));
         memset(menuItemIdsArray, 0, sizeof(menuItemIdsArray));
     }
      void setLocationNode(int node) { locationNode = node; }
@@ -0,0 +1,61 @@
+#pragma once
+#ifndef RESTAURANT_SUMMARY_H
+#define RESTAURANT_SUMMARY_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+using namespace std;
+
+// The part of a restaurant that listing, ranking and routing look at.
+// Four of them fit in a cache line, so scanning every restaurant touches
+// none of the names, addresses or menus kept in the full Restaurant record.
+struct RestaurantSummary {
+    int restaurantId;
+    int locationNode;
+    float rating;
+    short deliveryTime;     // minutes
+    short cuisineId;        // index in a CuisineTable
+
+    RestaurantSummary() : restaurantId(0), locationNode(0), rating(0.0f),
+                          deliveryTime(0), cuisineId(-1) {}
+};
+
+// Cuisine names interned to small ids, so summaries compare and group by
+// cuisine without carrying the text
+class CuisineTable {
+private:
+    vector<string> names;
+    unordered_map<string, int> ids;
+
+public:
+    // Id of name, adding it if it's new
+    int intern(const string& name) {
+        auto it = ids.find(name);
+        if (it != ids.end()) return it->second;
+        int id = names.size();
+        names.push_back(name);
+        ids[name] = id;
+        return id;
+    }
+
+    // -1 if no restaurant has that cuisine
+    int find(const string& name) const {
+        auto it = ids.find(name);
+        return it != ids.end() ? it->second : -1;
+    }
+
+    string name(int id) const {
+        return (id >= 0 && id < (int)names.size()) ? names[id] : string();
+    }
+
+    int size() const { return names.size(); }
+
+    void clear() {
+        names.clear();
+        ids.clear();
+    }
+};
+
+#endif // RESTAURANT_SUMMARY_H
@@ -150,9 +150,11 @@ public:
         location = newLocation;
     }
     
-    double calculatePriority(int pickupLocation, int deliveryLocation) const {
-        double distanceToPickup = abs(location - pickupLocation);
-        return 100.0 / (distanceToPickup + 1);
+    // Score from the road distance (not node id difference) to the pickup;
+    // a negative distance means unreachable
+    double calculatePriority(int roadDistanceToPickup) const {
+        if (roadDistanceToPickup < 0) return 0.0;
+        return 100.0 / (roadDistanceToPickup + 1);
     }
     
     // Display
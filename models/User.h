@@ -179,6 +179,19 @@ public:
     }
     
     
+    // Adds users read from disk in one go, without a console line per
+    // user. Ids already registered are skipped; returns how many were added.
+    size_t loadUsers(const vector<UserData>& loaded) {
+        users.reserve((int)loaded.size());
+        size_t added = 0;
+        for (const auto& user : loaded) {
+            if (users.searchTable(user.id) != nullptr) continue;
+            users.insertItem(user.id, user);
+            added++;
+        }
+        return added;
+    }
+    
     // Add user without password (for backward compatibility)
     bool addUser(int id, const string& name, const string& email, 
                 const string& phone, const string& role = "customer", 
@@ -197,6 +210,12 @@ public:
         cout << "User " << id << " removed successfully.\n";
         return true;
     }
+    // Copies every user into out, reusing the memory it already has
+    void copyAllUsers(vector<UserData>& out) const {
+        out.clear();
+        users.traverse([&](int id, const UserData& u) { out.push_back(u); });
+    }
+    
     vector<UserData> getAllUsersAsVector() const {
     vector<UserData> allUsers;
     users.traverse([&](int id, const UserData& u) {
@@ -239,6 +239,36 @@ void viewMyAssignedOrders() {
                     cout << "└─────────────────────────────────────┘\n\n";
                 }
             }
+
+            // Stops in the order the trip was planned: seq;PICKUP|DROPOFF;order;node;place
+            string stopsResponse = client.sendCommand("GET_RIDER_ORDERS", data + "|STOPS");
+            if (stopsResponse.substr(0, 7) == "SUCCESS" && stopsResponse.length() > 8) {
+                string stopsData = stopsResponse.substr(8);
+                cout << "🗺️  Your Route:\n";
+
+                size_t stopStart = 0, stopEnd;
+                while (stopStart < stopsData.length()) {
+                    stopEnd = stopsData.find('|', stopStart);
+                    if (stopEnd == string::npos) stopEnd = stopsData.length();
+                    string stopStr = stopsData.substr(stopStart, stopEnd - stopStart);
+                    stopStart = stopEnd + 1;
+
+                    vector<string> parts;
+                    size_t pos = 0, next;
+                    while ((next = stopStr.find(';', pos)) != string::npos) {
+                        parts.push_back(stopStr.substr(pos, next - pos));
+                        pos = next + 1;
+                    }
+                    parts.push_back(stopStr.substr(pos));
+
+                    if (parts.size() >= 5) {
+                        cout << "  " << parts[0] << ". "
+                             << (parts[1] == "PICKUP" ? "Pick up  " : "Drop off ")
+                             << "Order #" << parts[2] << " at " << parts[4] << "\n";
+                    }
+                }
+                cout << "\n";
+            }
         }
     } else {
         cout << "\n✗ Failed to retrieve your orders.\n";
@@ -399,22 +429,25 @@ void viewDeliveryRoute() {
     cin.ignore();
     
     // Request route from server
-    string routeData = to_string(orderId) + "|" + to_string(riderLoc);
+    string routeData = to_string(orderId) + "|" + to_string(riderLoc) + "|3";
     string routeResponse = client.sendCommand("GET_DELIVERY_ROUTE", routeData);
     
     if (routeResponse.substr(0, 7) == "SUCCESS") {
         cout << "\n🗺️  Calculated Delivery Route:\n\n";
         
-        // Parse route: SUCCESS|TO_RESTAURANT|1,2,3|TO_CUSTOMER|3,4,5
+        // Parse route: SUCCESS|TO_RESTAURANT|1,2,3|TO_CUSTOMER|3,4,5[|ALT|leg;rank;meters;nodes...]
         string routeInfo = routeResponse.substr(8);
         
         size_t toRestPos = routeInfo.find("TO_RESTAURANT|");
         size_t toCustomerPos = routeInfo.find("|TO_CUSTOMER|");
+        size_t altPos = routeInfo.find("|ALT|");
         
         if (toRestPos != string::npos && toCustomerPos != string::npos) {
             // Extract routes
             string route1Str = routeInfo.substr(toRestPos + 14, toCustomerPos - toRestPos - 14);
-            string route2Str = routeInfo.substr(toCustomerPos + 13);
+            string route2Str = (altPos == string::npos)
+                ? routeInfo.substr(toCustomerPos + 13)
+                : routeInfo.substr(toCustomerPos + 13, altPos - toCustomerPos - 13);
             
             // Display route to restaurant
             cout << "══════════════════════════════════════\n";
@@ -452,6 +485,42 @@ void viewDeliveryRoute() {
                 }
             }
             
+            // Next-best routes per leg: TO_RESTAURANT;2;1650;1,5,3
+            if (altPos != string::npos) {
+                cout << "\n══════════════════════════════════════\n";
+                cout << "  Alternative Routes\n";
+                cout << "══════════════════════════════════════\n";
+                
+                stringstream altStream(routeInfo.substr(altPos + 5));
+                string alternative;
+                while (getline(altStream, alternative, '|')) {
+                    if (alternative == "ALT") continue;
+                    
+                    stringstream fields(alternative);
+                    string leg, rank, meters, nodes;
+                    getline(fields, leg, ';');
+                    getline(fields, rank, ';');
+                    getline(fields, meters, ';');
+                    getline(fields, nodes);
+                    
+                    cout << "  " << (leg == "TO_RESTAURANT" ? "To restaurant" : "To customer")
+                         << " #" << rank << " (" << meters << "m): ";
+                    stringstream nodeStream(nodes);
+                    bool firstNode = true;
+                    while (getline(nodeStream, node, ',')) {
+                        int nodeId = stoi(node);
+                        if (!firstNode) cout << " → ";
+                        firstNode = false;
+                        if (locations.find(nodeId) != locations.end()) {
+                            cout << locations[nodeId];
+                        } else {
+                            cout << nodeId;
+                        }
+                    }
+                    cout << "\n";
+                }
+            }
+            
             cout << "\n✓ Route calculated using Dijkstra's algorithm\n";
         }
     } else {
@@ -3,6 +3,7 @@
 #include <iostream>
 #include <string>
 #include <limits>
+#include <fstream>
 
 using namespace std;
 
@@ -72,6 +73,31 @@ int main() {
                 cout << "Server Status: Running\n";
                 cout << "Port: " << port << "\n";
                 cout << "========================================\n";
+                
+                ServerMetrics& metrics = server.getMetrics();
+                ServerMetrics::Totals totals;
+                metrics.collect(totals);
+                
+                cout << "Uptime: " << metrics.uptimeSeconds() << " s"
+                     << ", Clients: " << metrics.connectedClients.load() << "\n";
+                cout << "Bytes In/Out: " << totals.bytesReceived << " / " << totals.bytesSent << "\n";
+                cout << "dataMutex wait p99: " << totals.lockWait.percentile(99) << " us"
+                     << ", hold p99: " << totals.lockHold.percentile(99) << " us\n\n";
+                
+                for (int i = 0; i < METRIC_COMMAND_COUNT; i++) {
+                    const HistogramSnapshot& h = totals.commandLatency[i];
+                    if (h.count == 0) continue;
+                    cout << "  " << METRIC_COMMANDS[i] << ": " << h.count << " requests, "
+                         << totals.commandErrors[i] << " errors, p50 " << h.percentile(50)
+                         << " us, p99 " << h.percentile(99) << " us\n";
+                }
+                
+                {
+                    ofstream promFile("metrics.prom");
+                    promFile << metrics.formatPrometheus();
+                }
+                cout << "\n✓ Prometheus metrics written to metrics.prom\n";
+                cout << "========================================\n";
                 cout << "\nPress Enter to continue...";
                 cin.get();
                 break;
@@ -87,9 +113,7 @@ int main() {
                 
             case 3: {
                 cout << "\nCreating backup...\n";
-                DatabaseManager tempDB;
-                tempDB.backupDatabase();
-                cout << "✓ Backup created successfully!\n";
+                server.backupSystemData();
                 cout << "\nPress Enter to continue...";
                 cin.get();
                 break;
@@ -12,6 +12,8 @@
 #include "../dataStructures/LinkedList.h"
 #include "../models/CityMapData.h"
 #include "../CityMapDatabase.h"
+#include "../Logger.h"
+#include "ShortestPathCache.h"
 
 using namespace std;
 
@@ -21,10 +23,12 @@ private:
     map<int, string> locationNames;
     map<int, string> locationTypes;
     CityMapDatabase mapDB;
+    ShortestPathCache routeCache;   // repaired on every road change
     
 public:
     CityGraph(int maxNodes = 500) {
         graph = new Graph(maxNodes);
+        routeCache.setRoadNetwork(graph);
         loadFromDatabase();  // Load on construction
     }
     
@@ -38,6 +42,7 @@ public:
         // Clear existing data first
         locationNames.clear();
         locationTypes.clear();
+        routeCache.clear();
         
         // Load locations
         vector<LocationData> locations = mapDB.loadAllLocations();
@@ -53,8 +58,8 @@ public:
             graph->addEdge(road.fromNode, road.toNode, road.distance);
         }
         
-        cout << "DEBUG: CityGraph loaded " << locationNames.size() 
-             << " locations and " << roads.size() << " roads\n";
+        LOG_DEBUG("CityGraph loaded " << locationNames.size() 
+             << " locations and " << roads.size() << " roads");
     }
     
     // Get total number of roads
@@ -122,18 +127,23 @@ public:
         locationTypes[nodeId] = type;
     }
     
-    // Remove a location
-    bool removeLocation(int nodeId) {
+    // Remove a location. Roads that went with it are added to removedRoads
+    // so callers can repair their own route caches.
+    bool removeLocation(int nodeId, vector<RoadData>* removedRoads = nullptr) {
         if (locationNames.find(nodeId) == locationNames.end()) {
             return false;
         }
         
         // Remove all edges connected to this node
-        LinkedList<int> neighbors = graph->getNeighbors(nodeId);
-        auto* current = neighbors.getHead();
-        while (current != nullptr) {
-            graph->removeEdge(nodeId, current->data);
-            current = current->next;
+        vector<RoadData> roads;
+        graph->forEachEdge(nodeId, [&](int neighbor, int distance) {
+            roads.push_back(RoadData(nodeId, neighbor, distance));
+        });
+        for (const auto& road : roads) {
+            removeRoad(road.fromNode, road.toNode);
+        }
+        if (removedRoads) {
+            removedRoads->insert(removedRoads->end(), roads.begin(), roads.end());
         }
         
         locationNames.erase(nodeId);
@@ -141,14 +151,22 @@ public:
         return true;
     }
     
-    // Add a road
-    void addRoad(int from, int to, int distance) {
+    // Add a road, or change its length if it exists. Returns the previous
+    // length (-1 if the road is new) for callers keeping their own caches.
+    int addRoad(int from, int to, int distance) {
+        int previous = graph->getEdgeWeight(from, to);
         graph->addEdge(from, to, distance);
+        routeCache.roadChanged(from, to, previous, distance);
+        return previous;
     }
     
-    // Remove a road
-    void removeRoad(int from, int to) {
+    // Remove a road (e.g. a closure). Returns its length, -1 if there was none.
+    int removeRoad(int from, int to) {
+        int previous = graph->getEdgeWeight(from, to);
+        if (previous < 0) return -1;
         graph->removeEdge(from, to);
+        routeCache.roadChanged(from, to, previous, -1);
+        return previous;
     }
     
     // Check if location exists
@@ -167,48 +185,36 @@ public:
         return maxId + 1;
     }
     
-    // Find shortest path - FIXED VERSION
+    // Shortest path and its length, read from the cached shortest-path
+    // tree of start (built on first use, repaired as roads change)
     pair<LinkedList<int>, int> findShortestPath(int start, int end) {
-        // cout << "DEBUG findShortestPath: start=" << start << ", end=" << end << endl;
+        pair<LinkedList<int>, int> result;
+        result.second = 0;
         
-        LinkedList<int> path = graph->dijkstra(start, end);
+        if (!graph->hasNode(start) || !graph->hasNode(end)) {
+            return result;
+        }
         
-        int totalDistance = 0;
-        
-        if (!path.isEmpty()) {
-            // Debug: Print the path
-            // cout << "DEBUG: Path nodes: ";
-            // Node<int>* node = path.getHead();
-            // while (node != nullptr) {
-            //     cout << node->data << " ";
-            //     node = node->next;
-            // }
-            // cout << endl;
-            
-            // Calculate total distance
-            Node<int>* current = path.getHead();
-            while (current != nullptr && current->next != nullptr) {
-                int u = current->data;
-                int v = current->next->data;
-                int weight = graph->getEdgeWeight(u, v);
-                if (weight != -1) {
-                    totalDistance += weight;
-                } else {
-                    // cout << "DEBUG: No edge between " << u << " and " << v << endl;
-                }
-                current = current->next;
-            }
-        } else {
-            // cout << "DEBUG: No path found from " << start << " to " << end << endl;
+        vector<int> nodes = routeCache.path(start, end);
+        for (int node : nodes) {
+            result.first.insertAtEnd(node);
+        }
+        if (!nodes.empty()) {
+            result.second = routeCache.distance(start, end);
         }
         
-        return make_pair(path, totalDistance);
+        return result;
     }
     
     int getDirectDistance(int from, int to) {
         return graph->getEdgeWeight(from, to);
     }
     
+    // Underlying road graph, for searches such as RiderLocationIndex::nearest
+    const Graph* getGraph() const {
+        return graph;
+    }
+    
     string getLocationName(int nodeId) {
         if (locationNames.find(nodeId) != locationNames.end()) {
             return locationNames[nodeId];
@@ -468,8 +474,8 @@ void connectToExistingNetwork(int newNode, int maxConnections = 3) {
         addRoad(newNode, existingNode, distance);
         connections++;
         
-        cout << "  Connected node " << newNode << " to " << existingNode 
-             << " (" << getLocationName(existingNode) << ") - " << distance << "m\n";
+        LOG_DEBUG("  Connected node " << newNode << " to " << existingNode 
+             << " (" << getLocationName(existingNode) << ") - " << distance << "m");
     }
 }
 };
@@ -3,11 +3,17 @@
 #define DELIVERY_ASSIGNMENT_H
 
 #include "CityGraph.h"
+#include "RiderService.h"
+#include "RouteOptimizer.h"
+#include "TravelTimeModel.h"
 #include "models/Rider.h"
 #include "models/Order.h"
 #include "models/Restaurant.h"
+#include "dataStructures/HashTable.h"
 #include "dataStructures/LinkedList.h"
+#include "dataStructures/WorkStealingPool.h"
 #include <climits>
+#include <unordered_map>
 
 struct DeliveryRoute {
     int riderId;
@@ -16,6 +22,7 @@ struct DeliveryRoute {
     LinkedList<int> pathToRestaurant;
     LinkedList<int> pathToCustomer;
     LinkedList<int> completePath;  // For multi-restaurant
+    vector<int> pickupSequence;    // Restaurant nodes in visiting order
     int totalDistance;
     int estimatedTime;  // minutes
     
@@ -26,165 +33,252 @@ struct DeliveryRoute {
 class DeliveryAssignmentSystem {
 private:
     CityGraph* cityGraph;
+    RiderService* riderService;         // keeps available riders indexed by node
+    HashTable<Rider>* fleet;            // scanned instead when there's no riderService
+    WorkStealingPool workers;           // shared by every route evaluation
+    RouteOptimizer routeOptimizer;      // caches stop-to-stop distances
+    TravelTimeModel travelTimes;        // time-of-day speed per road
     
-    // Calculate estimated time based on distance and vehicle type
-    int calculateDeliveryTime(int distance, const string& vehicleType) {
-        // Average speeds: bike=300m/min, motorcycle=600m/min, car=800m/min
-        int speed;
-        if (vehicleType == "bike") speed = 300;
-        else if (vehicleType == "motorcycle") speed = 600;
-        else if (vehicleType == "car") speed = 800;
-        else speed = 400; // default
+    enum {
+        PICKUP_MINUTES = 5,     // to collect from a restaurant
+        HANDOVER_MINUTES = 2    // to hand the order to the customer
+    };
+    
+    // Appends the shortest path from -> to, without repeating the node
+    // the route is already on
+    bool appendLeg(LinkedList<int>& path, int from, int to) {
+        auto leg = cityGraph->findShortestPath(from, to);
+        if (leg.first.isEmpty()) return false;
+        
+        auto* pathNode = leg.first.getHead();
+        while (pathNode != nullptr) {
+            if (path.isEmpty() || path.getTail()->data != pathNode->data) {
+                path.insertAtEnd(pathNode->data);
+            }
+            pathNode = pathNode->next;
+        }
+        return true;
+    }
+    
+    // Estimated minutes for a delivery whose driving takes travelSeconds,
+    // plus time at the restaurants and the door
+    int calculateDeliveryTime(int travelSeconds, int pickups = 1) {
+        return (travelSeconds + 59) / 60 + pickups * PICKUP_MINUTES + HANDOVER_MINUTES;
+    }
+    
+    static int pathDistance(const Graph& roads, const vector<int>& path) {
+        int total = 0;
+        for (size_t i = 0; i + 1 < path.size(); i++) {
+            total += roads.getEdgeWeight(path[i], path[i + 1]);
+        }
+        return total;
+    }
+    
+    static void toLinkedList(const vector<int>& nodes, LinkedList<int>& out) {
+        for (int node : nodes) out.insertAtEnd(node);
+    }
+    
+    static bool isEligible(const Rider& rider) {
+        return strcmp(rider.status, "available") == 0 || strcmp(rider.status, "Active") == 0;
+    }
+    
+    // Up to k available riders closest to node by road distance, nearest
+    // first. Taken from the rider service's location index, which is kept
+    // up to date as riders move, so the cost doesn't grow with the fleet;
+    // without one, the fleet is grouped by node and a single search from
+    // node stops at the k-th rider.
+    vector<pair<Rider*, int>> findNearestEligibleRiders(int node, int k) {
+        if (riderService) return riderService->findNearestRiders(node, k);
+        
+        vector<pair<Rider*, int>> nearest;
+        if (!fleet || k <= 0) return nearest;
         
-        int travelTime = distance / speed;
-        int pickupTime = 5;  // 5 minutes to collect from restaurant
-        int deliveryTime = 2; // 2 minutes to deliver
+        unordered_map<int, vector<Rider*>> ridersAt;
+        fleet->traverse([&](int, Rider& rider) {
+            if (isEligible(rider)) ridersAt[rider.location].push_back(&rider);
+        });
+        if (ridersAt.empty()) return nearest;
         
-        return travelTime + pickupTime + deliveryTime;
+        cityGraph->getGraph()->expandFrom(node, [&](int reached, int distance) {
+            auto it = ridersAt.find(reached);
+            if (it == ridersAt.end()) return false;
+            for (Rider* rider : it->second) {
+                if ((int)nearest.size() == k) break;
+                nearest.push_back(make_pair(rider, distance));
+            }
+            return (int)nearest.size() == k;
+        });
+        return nearest;
     }
     
 public:
-    DeliveryAssignmentSystem(CityGraph* graph) : cityGraph(graph) {}
+    DeliveryAssignmentSystem(CityGraph* graph, RiderService* riders = nullptr) 
+        : cityGraph(graph), riderService(riders), fleet(nullptr), routeOptimizer(graph ? graph->getGraph() : nullptr, &workers),
+          travelTimes(TravelTimeModel::dispatchSpeed) {}
+    
+    // Drops every cached distance; prefer roadChanged() for single roads
+    void invalidateDistances() {
+        routeOptimizer.invalidate();
+    }
+    
+    // Call after a road is added (oldWeight -1), removed (newWeight -1) or
+    // re-weighted; cached distances are repaired instead of rebuilt.
+    // Returns the number of cached nodes that had to be re-settled.
+    int roadChanged(int from, int to, int oldWeight, int newWeight) {
+        return routeOptimizer.roadChanged(from, to, oldWeight, newWeight);
+    }
+    
+    // Per-road speed profiles used for routing and ETAs; without them every
+    // road runs at free-flow speed
+    bool loadSpeedProfiles(const string& filename) {
+        return travelTimes.loadFromFile(filename);
+    }
+    
+    // Riders for orders are looked up in this service
+    void setRiderService(RiderService* riders) {
+        riderService = riders;
+    }
+    
+    // For callers without a RiderService: riders are found by searching
+    // outward from the pickup over this table instead of an index
+    void setFleet(HashTable<Rider>* riders) {
+        fleet = riders;
+    }
     
-    // Find best rider for a single restaurant order
-    DeliveryRoute assignRiderToOrder(const Order& order, 
-                                     const LinkedList<Rider>& availableRiders,
-                                     int restaurantLocation) {
+    // Find best rider for a single restaurant order: of the riders nearest
+    // by road, the one that gets the food to the customer first at the
+    // traffic of the time each leg is driven
+    DeliveryRoute assignRiderToOrder(const Order& order, int restaurantLocation) {
         DeliveryRoute bestRoute;
-        int minTotalDistance = INT_MAX;
+        const Graph& roads = *cityGraph->getGraph();
+        int now = TravelTimeModel::currentSecondOfDay();
         
-        auto* riderNode = availableRiders.getHead();
-        while (riderNode != nullptr) {
-            const Rider& rider = riderNode->data;
-            
-            if (strcmp(rider.status, "available") != 0 && 
-                strcmp(rider.status, "Active") != 0) {
-                riderNode = riderNode->next;
-                continue;
-            }
-            
-            // Calculate path from rider to restaurant
-            auto toRestaurant = cityGraph->findShortestPath(rider.location, restaurantLocation);
-            
-            // Calculate path from restaurant to customer
-            auto toCustomer = cityGraph->findShortestPath(restaurantLocation, order.deliveryLocation);
+        const Rider* bestRider = nullptr;
+        vector<int> bestToRestaurant, bestToCustomer;
+        int bestArrival = INT_MAX;
+        
+        for (const auto& candidate : findNearestEligibleRiders(restaurantLocation, TravelTimeModel::ETA_CANDIDATES)) {
+            const Rider* rider = candidate.first;
+            int atRestaurant = 0, atCustomer = 0;
             
-            if (toRestaurant.first.isEmpty() || toCustomer.first.isEmpty()) {
-                riderNode = riderNode->next;
-                continue; // No valid path
-            }
+            vector<int> toRestaurant = travelTimes.fastestPath(roads, rider->location, restaurantLocation,
+                                                               now, rider->getVehicle(), &atRestaurant);
+            if (toRestaurant.empty()) continue;
             
-            int totalDist = toRestaurant.second + toCustomer.second;
+            vector<int> toCustomer = travelTimes.fastestPath(roads, restaurantLocation, order.deliveryLocation,
+                                                             atRestaurant + PICKUP_MINUTES * 60,
+                                                             rider->getVehicle(), &atCustomer);
+            if (toCustomer.empty()) continue; // No valid path for this rider
             
-            if (totalDist < minTotalDistance) {
-                minTotalDistance = totalDist;
-                
-                bestRoute.riderId = rider.id;
-                bestRoute.restaurantLocation = restaurantLocation;
-                bestRoute.customerLocation = order.deliveryLocation;
-                bestRoute.pathToRestaurant = toRestaurant.first;
-                bestRoute.pathToCustomer = toCustomer.first;
-                bestRoute.totalDistance = totalDist;
-                bestRoute.estimatedTime = calculateDeliveryTime(totalDist, rider.getVehicle());
+            if (atCustomer < bestArrival) {
+                bestArrival = atCustomer;
+                bestRider = rider;
+                bestToRestaurant.swap(toRestaurant);
+                bestToCustomer.swap(toCustomer);
             }
-            
-            riderNode = riderNode->next;
         }
+        if (!bestRider) {
+            return bestRoute;
+        }
+        
+        bestRoute.riderId = bestRider->id;
+        bestRoute.restaurantLocation = restaurantLocation;
+        bestRoute.customerLocation = order.deliveryLocation;
+        toLinkedList(bestToRestaurant, bestRoute.pathToRestaurant);
+        toLinkedList(bestToCustomer, bestRoute.pathToCustomer);
+        bestRoute.totalDistance = pathDistance(roads, bestToRestaurant) + pathDistance(roads, bestToCustomer);
+        // The pickup wait is already inside bestArrival
+        bestRoute.estimatedTime = calculateDeliveryTime(bestArrival - now - PICKUP_MINUTES * 60);
         
         return bestRoute;
     }
     
-    // For multi-restaurant orders
+    // For multi-restaurant orders: every rider is planned with its own best
+    // pickup order in a single pass over the cached distance matrix. The
+    // candidates are the riders nearest by road to each pickup, from the
+    // RiderService or fleet; availableRiders is only scanned when neither
+    // is set. The matrix rows and per-rider plans are computed on the
+    // worker pool; the best plan is then picked in candidate order, ties
+    // going to the rider listed first, so the result is the same on any
+    // number of cores.
     DeliveryRoute assignRiderToMultiRestaurantOrder(const Order& order,
                                                     const LinkedList<Rider>& availableRiders,
                                                     const LinkedList<int>& restaurantLocations) {
         DeliveryRoute bestRoute;
-        int minTotalDistance = INT_MAX;
         
-        auto* riderNode = availableRiders.getHead();
-        while (riderNode != nullptr) {
-            const Rider& rider = riderNode->data;
-            
-            if (strcmp(rider.status, "available") != 0 && 
-                strcmp(rider.status, "Active") != 0) {
-                riderNode = riderNode->next;
-                continue;
+        vector<int> pickups;
+        auto* restNode = restaurantLocations.getHead();
+        while (restNode != nullptr) {
+            if (find(pickups.begin(), pickups.end(), restNode->data) == pickups.end()) {
+                pickups.push_back(restNode->data);
             }
-            
-            // Calculate total path: rider -> restaurants -> customer
-            int totalDist = 0;
-            LinkedList<int> completePath;
-            int currentLoc = rider.location;
-            bool pathValid = true;
-            
-            // Visit each restaurant
-            auto* restNode = restaurantLocations.getHead();
-            while (restNode != nullptr) {
-                int restLoc = restNode->data;
-                auto segment = cityGraph->findShortestPath(currentLoc, restLoc);
-                
-                if (segment.first.isEmpty()) {
-                    pathValid = false;
-                    break;
-                }
-                
-                totalDist += segment.second;
-                
-                // Add path segment
-                auto* pathNode = segment.first.getHead();
-                while (pathNode != nullptr) {
-                    // Skip duplicate nodes
-                    if (completePath.isEmpty() || 
-                        completePath.getTail()->data != pathNode->data) {
-                        completePath.insertAtEnd(pathNode->data);
-                    }
-                    pathNode = pathNode->next;
+            restNode = restNode->next;
+        }
+        
+        vector<const Rider*> candidates;
+        vector<int> riderNodes;
+        if (riderService || fleet) {
+            vector<int> seen;
+            for (int pickup : pickups) {
+                for (const auto& hit : findNearestEligibleRiders(pickup, TravelTimeModel::ETA_CANDIDATES)) {
+                    if (find(seen.begin(), seen.end(), hit.first->id) != seen.end()) continue;
+                    seen.push_back(hit.first->id);
+                    candidates.push_back(hit.first);
+                    riderNodes.push_back(hit.first->location);
                 }
-                
-                currentLoc = restLoc;
-                restNode = restNode->next;
             }
-            
-            if (!pathValid) {
-                riderNode = riderNode->next;
-                continue;
-            }
-            
-            // Finally, go to customer
-            auto toCustomer = cityGraph->findShortestPath(currentLoc, order.deliveryLocation);
-            if (toCustomer.first.isEmpty()) {
-                riderNode = riderNode->next;
-                continue;
-            }
-            
-            totalDist += toCustomer.second;
-            
-            // Add final segment
-            auto* pathNode = toCustomer.first.getHead();
-            bool skipFirst = true;
-            while (pathNode != nullptr) {
-                if (skipFirst) {
-                    skipFirst = false;
-                    pathNode = pathNode->next;
-                    continue;
+        } else {
+            auto* riderNode = availableRiders.getHead();
+            while (riderNode != nullptr) {
+                const Rider& rider = riderNode->data;
+                if (isEligible(rider)) {
+                    candidates.push_back(&rider);
+                    riderNodes.push_back(rider.location);
                 }
-                completePath.insertAtEnd(pathNode->data);
-                pathNode = pathNode->next;
-            }
-            
-            if (totalDist < minTotalDistance) {
-                minTotalDistance = totalDist;
-                
-                bestRoute.riderId = rider.id;
-                bestRoute.customerLocation = order.deliveryLocation;
-                bestRoute.completePath = completePath;
-                bestRoute.totalDistance = totalDist;
-                bestRoute.estimatedTime = calculateDeliveryTime(totalDist, rider.getVehicle());
+                riderNode = riderNode->next;
             }
-            
-            riderNode = riderNode->next;
+        }
+        if (candidates.empty()) {
+            return bestRoute;
+        }
+        
+        vector<PickupPlan> plans = routeOptimizer.planForRiders(riderNodes, pickups, 
+                                                                order.deliveryLocation);
+        
+        size_t best = 0;
+        for (size_t i = 1; i < plans.size(); i++) {
+            if (plans[i].totalDistance < plans[best].totalDistance) best = i;
+        }
+        if (plans[best].totalDistance >= RouteOptimizer::UNREACHABLE) {
+            return bestRoute; // No valid path
         }
         
+        const Rider* rider = candidates[best];
+        LinkedList<int>& completePath = bestRoute.completePath;
+        int currentLoc = rider->location;
+        for (int stop : plans[best].sequence) {
+            if (!appendLeg(completePath, currentLoc, stop)) return bestRoute;
+            currentLoc = stop;
+        }
+        if (!appendLeg(completePath, currentLoc, order.deliveryLocation)) {
+            return bestRoute;
+        }
+        
+        int totalDist = plans[best].totalDistance;
+        
+        // ETA along the route just planned, at the traffic of when each road is driven
+        int now = TravelTimeModel::currentSecondOfDay();
+        int arrival = travelTimes.travelAlongPath(*cityGraph->getGraph(), completePath, now,
+                                                  rider->getVehicle());
+        int travelSeconds = arrival >= 0 ? arrival - now
+                                         : totalDist * 60 / travelTimes.speedOf(rider->getVehicle());
+        
+        bestRoute.riderId = rider->id;
+        bestRoute.customerLocation = order.deliveryLocation;
+        bestRoute.pickupSequence = plans[best].sequence;
+        bestRoute.totalDistance = totalDist;
+        bestRoute.estimatedTime = calculateDeliveryTime(travelSeconds, plans[best].sequence.size());
+        
         return bestRoute;
     }
     
@@ -206,6 +300,15 @@ public:
         cout << "   Estimated Time: " << route.estimatedTime << " minutes\n";
         
         if (isMultiRestaurant) {
+            if (!route.pickupSequence.empty()) {
+                cout << "   Pickup Order: ";
+                for (size_t i = 0; i < route.pickupSequence.size(); i++) {
+                    if (i > 0) cout << " → ";
+                    cout << cityGraph->getLocationName(route.pickupSequence[i]);
+                }
+                cout << "\n";
+            }
+            
             cout << "\n=== 🛣️ COMPLETE ROUTE (Multi-Restaurant) ===\n";
             cityGraph->printPathDetails(route.completePath, route.totalDistance);
         } else {
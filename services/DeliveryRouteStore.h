@@ -0,0 +1,204 @@
+#pragma once
+#ifndef DELIVERY_ROUTE_STORE_H
+#define DELIVERY_ROUTE_STORE_H
+
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include "../dataStructures/Graph.h"
+#include "ShortestPathCache.h"
+
+using namespace std;
+
+// The road route planned for one order: every node the rider drives
+// through, from where the rider was when the route was planned, past any
+// earlier stops of the trip, to the restaurant and on to the customer.
+struct StoredRoute {
+    int orderId;
+    int riderId;
+    vector<int> nodes;
+    vector<int> cumulative;     // meters from nodes[0] to nodes[i]
+    vector<int> nextVisit;      // next index with the same node as i, -1 if none
+    unordered_map<int, int> firstVisit;     // node -> first index in nodes
+    vector<int> stops;          // stop nodes, in visiting order
+    vector<int> stopIndex;      // index in nodes where each stop is reached
+    int pickupStop;             // index in stops of the restaurant, -1 once passed
+    int progress;               // index in nodes of the last reported position
+    int reroutes;
+    bool stale;                 // a road on the rest of the route got worse
+
+    StoredRoute() : orderId(-1), riderId(-1), pickupStop(-1), progress(0),
+                    reroutes(0), stale(false) {}
+
+    int totalDistance() const { return cumulative.empty() ? 0 : cumulative.back(); }
+    int remainingDistance() const { return totalDistance() - cumulative[progress]; }
+
+    // Index in nodes where the restaurant is reached (progress once passed)
+    int pickupIndex() const {
+        return pickupStop >= 0 ? max(progress, stopIndex[pickupStop]) : progress;
+    }
+};
+
+// Delivery routes computed once per assignment and kept with the order.
+//
+// Riders report where they are as they drive; advance() finds the position
+// on the stored node array through a node -> visit index, so progress
+// queries are O(1) and serving the route again is just slicing the array.
+// Only a position off the rest of the route, or a route that lost a road,
+// triggers re-planning from where the rider is.
+//
+// Legs come from a ShortestPathCache, so forward roadChanged() here after
+// every road change.
+class DeliveryRouteStore {
+private:
+    const Graph* roads;
+    ShortestPathCache paths;
+    unordered_map<int, StoredRoute> routes;     // by order id
+
+    // Fills route.nodes/cumulative/stopIndex from start through the stops.
+    // False if some stop can't be reached.
+    bool build(StoredRoute& route, int start) {
+        route.nodes.assign(1, start);
+        route.cumulative.assign(1, 0);
+        route.stopIndex.clear();
+        route.progress = 0;
+        route.stale = false;
+
+        for (int stop : route.stops) {
+            int from = route.nodes.back();
+            vector<int> leg = paths.path(from, stop);
+            if (leg.empty()) return false;
+
+            for (size_t i = 1; i < leg.size(); i++) {
+                route.cumulative.push_back(route.cumulative.back() + roads->getEdgeWeight(leg[i - 1], leg[i]));
+                route.nodes.push_back(leg[i]);
+            }
+            route.stopIndex.push_back(route.nodes.size() - 1);
+        }
+
+        // Chain the visits of each node so a reported position is found
+        // without scanning the route
+        route.nextVisit.assign(route.nodes.size(), -1);
+        route.firstVisit.clear();
+        for (int i = (int)route.nodes.size() - 1; i >= 0; i--) {
+            auto seen = route.firstVisit.find(route.nodes[i]);
+            if (seen != route.firstVisit.end()) route.nextVisit[i] = seen->second;
+            route.firstVisit[route.nodes[i]] = i;
+        }
+        return true;
+    }
+
+    // First index at or after the rider's progress where the route passes
+    // node, -1 if it doesn't
+    static int positionOf(const StoredRoute& route, int node) {
+        auto it = route.firstVisit.find(node);
+        int index = (it != route.firstVisit.end()) ? it->second : -1;
+        while (index != -1 && index < route.progress) index = route.nextVisit[index];
+        return index;
+    }
+
+    // Re-plans from node through the stops not reached by progress; the
+    // caller moves progress to node first when node is on the route
+    bool reroute(StoredRoute& route, int node) {
+        size_t reached = 0;
+        while (reached < route.stopIndex.size() && route.stopIndex[reached] <= route.progress) {
+            reached++;
+        }
+        route.stops.erase(route.stops.begin(), route.stops.begin() + reached);
+        if (route.pickupStop >= 0) {
+            route.pickupStop = (route.pickupStop < (int)reached) ? -1 : route.pickupStop - (int)reached;
+        }
+
+        route.reroutes++;
+        return build(route, node);
+    }
+
+public:
+    DeliveryRouteStore(const Graph* roadGraph = nullptr) : roads(roadGraph), paths(roadGraph) {}
+
+    void setRoadNetwork(const Graph* roadGraph) {
+        roads = roadGraph;
+        paths.setRoadNetwork(roadGraph);
+        routes.clear();
+    }
+
+    // Call after the graph has changed (-1 = no road). Routes still ahead
+    // of a road that got longer or closed are re-planned on their next
+    // advance(); new or shorter roads leave planned routes alone.
+    void roadChanged(int from, int to, int oldWeight, int newWeight) {
+        paths.roadChanged(from, to, oldWeight, newWeight);
+        if (newWeight >= 0 && (oldWeight < 0 || newWeight <= oldWeight)) return;
+
+        for (auto& entry : routes) {
+            StoredRoute& route = entry.second;
+            for (size_t i = route.progress; i + 1 < route.nodes.size(); i++) {
+                int a = route.nodes[i], b = route.nodes[i + 1];
+                if ((a == from && b == to) || (a == to && b == from)) {
+                    route.stale = true;
+                    break;
+                }
+            }
+        }
+    }
+
+    // Plans (or re-plans) the order's route from start through stops;
+    // pickupStop is the index in stops of the order's restaurant. Returns
+    // nullptr, keeping nothing, if a stop can't be reached.
+    const StoredRoute* plan(int orderId, int riderId, int start,
+                            const vector<int>& stops, int pickupStop) {
+        if (!roads || !roads->hasNode(start)) return nullptr;
+
+        StoredRoute route;
+        route.orderId = orderId;
+        route.riderId = riderId;
+        route.stops = stops;
+        route.pickupStop = pickupStop;
+        if (!build(route, start)) {
+            routes.erase(orderId);
+            return nullptr;
+        }
+
+        StoredRoute& stored = routes[orderId];
+        stored = route;
+        return &stored;
+    }
+
+    const StoredRoute* find(int orderId) const {
+        auto it = routes.find(orderId);
+        return it != routes.end() ? &it->second : nullptr;
+    }
+
+    // The rider of orderId reports being at node. Moves progress to where
+    // the rest of the route passes node, or re-plans from node if it
+    // doesn't. Positions that aren't on the map leave the route as is.
+    const StoredRoute* advance(int orderId, int node) {
+        auto it = routes.find(orderId);
+        if (it == routes.end()) return nullptr;
+        StoredRoute& route = it->second;
+
+        // Even on a stale route, a position on it tells which stops are
+        // behind the rider before re-planning the rest
+        int index = positionOf(route, node);
+        if (index >= 0) {
+            route.progress = index;
+            // Reached the restaurant: the rest is all the customer leg
+            if (route.pickupStop >= 0 && route.stopIndex[route.pickupStop] <= index) {
+                route.pickupStop = -1;
+            }
+            if (!route.stale) return &route;
+        }
+        if (!roads || !roads->hasNode(node)) return &route;
+
+        if (!reroute(route, node)) {
+            routes.erase(it);
+            return nullptr;
+        }
+        return &route;
+    }
+
+    void remove(int orderId) { routes.erase(orderId); }
+
+    int size() const { return routes.size(); }
+};
+
+#endif // DELIVERY_ROUTE_STORE_H
@@ -0,0 +1,320 @@
+#pragma once
+#ifndef DISPATCH_ENGINE_H
+#define DISPATCH_ENGINE_H
+
+#include <vector>
+#include <unordered_map>
+#include <climits>
+#include <chrono>
+#include <atomic>
+#include "../dataStructures/Graph.h"
+#include "../dataStructures/WorkStealingPool.h"
+
+using namespace std;
+
+// An order waiting for a rider, identified by where it is picked up
+struct DispatchRequest {
+    int orderId;
+    int pickupNode;
+
+    DispatchRequest() : orderId(-1), pickupNode(-1) {}
+    DispatchRequest(int id, int node) : orderId(id), pickupNode(node) {}
+};
+
+struct DispatchCandidate {
+    int riderId;
+    int node;
+
+    DispatchCandidate() : riderId(-1), node(-1) {}
+    DispatchCandidate(int id, int n) : riderId(id), node(n) {}
+};
+
+struct DispatchAssignment {
+    int orderId;
+    int riderId;
+    int pickupDistance;     // -1 when rider or pickup isn't on the map
+
+    DispatchAssignment() : orderId(-1), riderId(-1), pickupDistance(0) {}
+    DispatchAssignment(int o, int r, int d) : orderId(o), riderId(r), pickupDistance(d) {}
+};
+
+// Batches orders over a short window and assigns the whole batch at once
+// with a min-cost matching on road distance (Hungarian algorithm), instead
+// of greedily giving each order the nearest rider as it arrives.
+//
+// The engine only plans. Callers take the pending batch, solve it against
+// the riders that are free right now, then apply every assignment under
+// their own lock and requeue() anything that no longer applies. It holds
+// no lock itself; callers serialize access.
+class DispatchEngine {
+public:
+    enum {
+        UNREACHABLE = 1000000000,
+        // Rider or pickup not on the map: still assignable, but after any
+        // rider whose distance is actually known
+        UNKNOWN_LOCATION = 100000000
+    };
+
+private:
+    const Graph* roads;
+    int windowMillis;
+    WorkStealingPool workers;
+
+    vector<DispatchRequest> pending;
+    chrono::steady_clock::time_point windowStart;
+    
+    // Copies of pending.size() and windowStart that can be read without
+    // the callers' lock (see windowMayHaveElapsed)
+    atomic<size_t> queued;
+    atomic<long long> windowStartMillis;
+    
+    static long long steadyMillis(chrono::steady_clock::time_point at) {
+        return chrono::duration_cast<chrono::milliseconds>(at.time_since_epoch()).count();
+    }
+
+    // Distance from each order's pickup to every distinct rider node; one
+    // graph expansion per order, stopped once all rider nodes are settled
+    void computeRow(int pickup, const vector<int>& riderNodes,
+                    const unordered_map<int, size_t>& slotOf, vector<int>& out) const {
+        out.assign(riderNodes.size(), UNREACHABLE);
+
+        size_t remaining = riderNodes.size();
+        if (!roads->hasNode(pickup)) {
+            out.assign(riderNodes.size(), UNKNOWN_LOCATION);
+            return;
+        }
+        for (size_t i = 0; i < riderNodes.size(); i++) {
+            if (!roads->hasNode(riderNodes[i])) {
+                out[i] = UNKNOWN_LOCATION;
+                remaining--;
+            }
+        }
+        if (remaining == 0) return;
+
+        roads->expandFrom(pickup, [&](int node, int distance) {
+            auto it = slotOf.find(node);
+            if (it == slotOf.end()) return false;
+            out[it->second] = distance;
+            return --remaining == 0;
+        });
+    }
+
+    vector<vector<int>> buildNodeDistances(const vector<DispatchRequest>& orders,
+                                           const vector<int>& riderNodes) const {
+        vector<vector<int>> nodeDistances(orders.size());
+        if (orders.empty() || riderNodes.empty()) return nodeDistances;
+
+        unordered_map<int, size_t> slotOf;
+        for (size_t i = 0; i < riderNodes.size(); i++) slotOf[riderNodes[i]] = i;
+
+        // Searches stop as soon as every rider node is settled, so rows
+        // vary a lot in cost; the pool balances them across cores
+        workers.parallelFor(orders.size(), [&](size_t row, int) {
+            computeRow(orders[row].pickupNode, riderNodes, slotOf, nodeDistances[row]);
+        });
+        return nodeDistances;
+    }
+
+public:
+    DispatchEngine(const Graph* roadGraph = nullptr, int windowMs = 2000, int workerThreads = 0)
+        : roads(roadGraph), windowMillis(windowMs), workers(workerThreads), queued(0), windowStartMillis(0) {}
+
+    void setRoadNetwork(const Graph* roadGraph) { roads = roadGraph; }
+    void setWindowMillis(int windowMs) { windowMillis = windowMs; }
+    int getWindowMillis() const { return windowMillis; }
+
+    // Queue an order for the next batch; re-submitting updates its pickup
+    void submit(const DispatchRequest& request) {
+        for (auto& existing : pending) {
+            if (existing.orderId == request.orderId) {
+                existing.pickupNode = request.pickupNode;
+                return;
+            }
+        }
+        if (pending.empty()) {
+            windowStart = chrono::steady_clock::now();
+            windowStartMillis.store(steadyMillis(windowStart), memory_order_relaxed);
+        }
+        pending.push_back(request);
+        queued.store(pending.size(), memory_order_release);
+    }
+
+    bool cancel(int orderId) {
+        for (size_t i = 0; i < pending.size(); i++) {
+            if (pending[i].orderId == orderId) {
+                pending.erase(pending.begin() + i);
+                queued.store(pending.size(), memory_order_release);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool isPending(int orderId) const {
+        for (const auto& request : pending) {
+            if (request.orderId == orderId) return true;
+        }
+        return false;
+    }
+
+    int pendingCount() const { return pending.size(); }
+
+    // True once the oldest pending order has waited a full window
+    bool windowElapsed() const {
+        if (pending.empty()) return false;
+        auto waited = chrono::duration_cast<chrono::milliseconds>(
+            chrono::steady_clock::now() - windowStart).count();
+        return waited >= windowMillis;
+    }
+    
+    // windowElapsed() for a caller that doesn't hold its lock, so a poller
+    // can skip taking the lock while nothing is due. May be briefly out of
+    // date; check windowElapsed() again under the lock.
+    bool windowMayHaveElapsed() const {
+        if (queued.load(memory_order_acquire) == 0) return false;
+        long long waited = steadyMillis(chrono::steady_clock::now()) -
+                           windowStartMillis.load(memory_order_relaxed);
+        return waited >= windowMillis;
+    }
+
+    vector<DispatchRequest> takePending() {
+        vector<DispatchRequest> batch;
+        batch.swap(pending);
+        queued.store(0, memory_order_release);
+        return batch;
+    }
+
+    // Put orders that could not be assigned back into the next window
+    void requeue(const vector<DispatchRequest>& requests) {
+        for (const auto& request : requests) submit(request);
+    }
+
+    // Min-cost assignment of orders to riders by road distance to pickup.
+    // Orders with no reachable rider (or more orders than riders) are left
+    // out of the result and listed in unassigned.
+    vector<DispatchAssignment> solve(const vector<DispatchRequest>& orders,
+                                     const vector<DispatchCandidate>& riders,
+                                     vector<DispatchRequest>* unassigned = nullptr) const {
+        vector<DispatchAssignment> result;
+        vector<bool> assigned(orders.size(), false);
+
+        if (roads && !orders.empty() && !riders.empty()) {
+            // Riders sharing a node share a column of distances
+            vector<int> riderNodes;
+            unordered_map<int, size_t> slotOf;
+            vector<size_t> riderSlot(riders.size());
+            for (size_t r = 0; r < riders.size(); r++) {
+                auto it = slotOf.find(riders[r].node);
+                if (it == slotOf.end()) {
+                    it = slotOf.emplace(riders[r].node, riderNodes.size()).first;
+                    riderNodes.push_back(riders[r].node);
+                }
+                riderSlot[r] = it->second;
+            }
+
+            vector<vector<int>> nodeDistances = buildNodeDistances(orders, riderNodes);
+
+            vector<vector<long long>> cost(orders.size(), vector<long long>(riders.size()));
+            for (size_t o = 0; o < orders.size(); o++) {
+                for (size_t r = 0; r < riders.size(); r++) {
+                    cost[o][r] = nodeDistances[o][riderSlot[r]];
+                }
+            }
+
+            vector<int> match = solveAssignment(cost);
+            for (size_t o = 0; o < orders.size(); o++) {
+                int r = match[o];
+                if (r < 0 || cost[o][r] >= UNREACHABLE) continue;
+                int distance = cost[o][r] >= UNKNOWN_LOCATION ? -1 : (int)cost[o][r];
+                result.push_back(DispatchAssignment(orders[o].orderId, riders[r].riderId,
+                                                    distance));
+                assigned[o] = true;
+            }
+        }
+
+        if (unassigned) {
+            for (size_t o = 0; o < orders.size(); o++) {
+                if (!assigned[o]) unassigned->push_back(orders[o]);
+            }
+        }
+        return result;
+    }
+
+    // Hungarian algorithm (O(n^2 m)) on a rows x cols cost matrix. Returns
+    // the column chosen for each row, or -1 for rows left over when there
+    // are more rows than columns.
+    static vector<int> solveAssignment(const vector<vector<long long>>& cost) {
+        size_t rows = cost.size();
+        size_t cols = rows ? cost[0].size() : 0;
+        vector<int> result(rows, -1);
+        if (rows == 0 || cols == 0) return result;
+
+        // The algorithm needs rows <= cols; solve the transpose otherwise
+        if (rows > cols) {
+            vector<vector<long long>> transposed(cols, vector<long long>(rows));
+            for (size_t i = 0; i < rows; i++)
+                for (size_t j = 0; j < cols; j++)
+                    transposed[j][i] = cost[i][j];
+
+            vector<int> colToRow = solveAssignment(transposed);
+            for (size_t j = 0; j < cols; j++) {
+                if (colToRow[j] >= 0) result[colToRow[j]] = (int)j;
+            }
+            return result;
+        }
+
+        const long long INF = LLONG_MAX / 4;
+        size_t n = rows, m = cols;
+        vector<long long> u(n + 1, 0), v(m + 1, 0);
+        vector<size_t> p(m + 1, 0), way(m + 1, 0);
+
+        for (size_t i = 1; i <= n; i++) {
+            p[0] = i;
+            size_t j0 = 0;
+            vector<long long> minv(m + 1, INF);
+            vector<bool> used(m + 1, false);
+
+            do {
+                used[j0] = true;
+                size_t i0 = p[j0], j1 = 0;
+                long long delta = INF;
+
+                for (size_t j = 1; j <= m; j++) {
+                    if (used[j]) continue;
+                    long long cur = cost[i0 - 1][j - 1] - u[i0] - v[j];
+                    if (cur < minv[j]) {
+                        minv[j] = cur;
+                        way[j] = j0;
+                    }
+                    if (minv[j] < delta) {
+                        delta = minv[j];
+                        j1 = j;
+                    }
+                }
+
+                for (size_t j = 0; j <= m; j++) {
+                    if (used[j]) {
+                        u[p[j]] += delta;
+                        v[j] -= delta;
+                    } else {
+                        minv[j] -= delta;
+                    }
+                }
+                j0 = j1;
+            } while (p[j0] != 0);
+
+            do {
+                size_t j1 = way[j0];
+                p[j0] = p[j1];
+                j0 = j1;
+            } while (j0 != 0);
+        }
+
+        for (size_t j = 1; j <= m; j++) {
+            if (p[j] != 0) result[p[j] - 1] = (int)(j - 1);
+        }
+        return result;
+    }
+};
+
+#endif // DISPATCH_ENGINE_H
@@ -0,0 +1,319 @@
+#pragma once
+#ifndef K_SHORTEST_PATHS_H
+#define K_SHORTEST_PATHS_H
+
+#include <vector>
+#include <list>
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
+#include <climits>
+#include <algorithm>
+#include "../dataStructures/Graph.h"
+#include "../dataStructures/IndexedPriorityQueue.h"
+
+using namespace std;
+
+// One of the ranked routes between two locations
+struct RankedRoute {
+    vector<int> nodes;
+    int distance;
+
+    RankedRoute() : distance(0) {}
+    RankedRoute(const vector<int>& path, int length) : nodes(path), distance(length) {}
+};
+
+// Point-to-point Dijkstra run from both ends at once; roads are two-way, so
+// the backward search uses the same edges. Nodes and roads can be blocked
+// for a single search without touching the graph. The distance arrays are
+// kept between searches and invalidated with a stamp instead of being
+// refilled, so a search only costs the nodes it actually reaches.
+class BidirectionalSearch {
+private:
+    const Graph* roads;
+    vector<int> dist[2];            // 0 = from start, 1 = from end
+    vector<int> prev[2];
+    vector<unsigned> reached[2];    // == stamp when dist/prev are valid
+    vector<unsigned> blockedAt;     // == blockStamp when the node is blocked
+    unsigned stamp;
+    unsigned blockStamp;
+    unordered_set<long long> blockedRoads;
+
+    static long long roadKey(int from, int to) {
+        if (from > to) swap(from, to);
+        return ((long long)from << 32) | (unsigned int)to;
+    }
+
+    void ensureSize() {
+        size_t n = roads ? roads->getMaxNodes() : 0;
+        if (blockedAt.size() == n) return;
+        for (int side = 0; side < 2; side++) {
+            dist[side].assign(n, INT_MAX);
+            prev[side].assign(n, -1);
+            reached[side].assign(n, 0);
+        }
+        blockedAt.assign(n, 0);
+        stamp = 0;
+        blockStamp = 1;
+    }
+
+    bool isReached(int side, int node) const { return reached[side][node] == stamp; }
+
+    int distOf(int side, int node) const {
+        return isReached(side, node) ? dist[side][node] : INT_MAX;
+    }
+
+public:
+    BidirectionalSearch(const Graph* roadGraph = nullptr)
+        : roads(roadGraph), stamp(0), blockStamp(1) {}
+
+    void setRoadNetwork(const Graph* roadGraph) {
+        roads = roadGraph;
+        blockedAt.clear();
+        clearBlocks();
+    }
+
+    void clearBlocks() {
+        blockStamp++;
+        blockedRoads.clear();
+    }
+
+    void blockNode(int node) {
+        ensureSize();
+        if (node >= 0 && node < (int)blockedAt.size()) blockedAt[node] = blockStamp;
+    }
+
+    void blockRoad(int from, int to) { blockedRoads.insert(roadKey(from, to)); }
+
+    // Shortest start -> end path avoiding the blocked nodes and roads.
+    // Returns false if there is none.
+    bool find(int start, int end, vector<int>& path, int& distance) {
+        path.clear();
+        distance = 0;
+        if (!roads || !roads->hasNode(start) || !roads->hasNode(end)) return false;
+        ensureSize();
+        if (start == end) {
+            path.push_back(start);
+            return true;
+        }
+
+        if (++stamp == 0) {
+            reached[0].assign(reached[0].size(), 0);
+            reached[1].assign(reached[1].size(), 0);
+            stamp = 1;
+        }
+
+        IndexedPriorityQueue<int> frontier[2];
+        int ends[2] = { start, end };
+        for (int side = 0; side < 2; side++) {
+            dist[side][ends[side]] = 0;
+            prev[side][ends[side]] = -1;
+            reached[side][ends[side]] = stamp;
+            frontier[side].enqueue(ends[side], 0);
+        }
+
+        int best = INT_MAX;
+        int meet = -1;
+        while (!frontier[0].isEmpty() && !frontier[1].isEmpty()) {
+            // Nothing left in either queue can beat the best meeting point
+            long long lowest = (long long)frontier[0].peekPriority() + frontier[1].peekPriority();
+            if (lowest >= best) break;
+
+            int side = frontier[0].peekPriority() <= frontier[1].peekPriority() ? 0 : 1;
+            int other = 1 - side;
+            int d = frontier[side].peekPriority();
+            int u = frontier[side].dequeue();
+
+            roads->forEachEdge(u, [&](int v, int weight) {
+                if (blockedAt[v] == blockStamp) return;
+                if (!blockedRoads.empty() && blockedRoads.count(roadKey(u, v))) return;
+
+                int candidate = d + weight;
+                if (candidate < distOf(side, v)) {
+                    dist[side][v] = candidate;
+                    prev[side][v] = u;
+                    reached[side][v] = stamp;
+                    frontier[side].enqueue(v, candidate);
+                }
+                if (isReached(other, v) && (long long)dist[side][v] + dist[other][v] < best) {
+                    best = dist[side][v] + dist[other][v];
+                    meet = v;
+                }
+            });
+        }
+        if (meet < 0) return false;
+
+        for (int node = meet; node != -1; node = prev[0][node]) {
+            path.push_back(node);
+        }
+        reverse(path.begin(), path.end());
+        for (int node = prev[1][meet]; node != -1; node = prev[1][node]) {
+            path.push_back(node);
+        }
+        distance = best;
+        return true;
+    }
+};
+
+// The k shortest loopless routes between two locations (Yen's algorithm),
+// shortest first, computed without modifying the road graph.
+//
+// Route i+1 is found by branching off route i at each of its nodes: the
+// part up to the branch node (the root) is kept, the roads that earlier
+// routes with the same root took next are blocked, the root's other nodes
+// are blocked so the route can't loop back, and a bidirectional search
+// finds the rest. The cheapest branch not yet taken becomes the next route.
+//
+// Results are cached per (from, to) pair, least recently used pair dropped
+// first. Any road change can make a different set of routes the shortest,
+// so roadChanged() drops the whole cache. Not thread safe; the search
+// scratch is shared between calls.
+class KShortestPaths {
+public:
+    enum { DEFAULT_CACHE_LIMIT = 512 };
+
+private:
+    struct Entry {
+        vector<RankedRoute> routes;
+        int searched;               // k the routes were computed for
+        list<long long>::iterator recent;
+    };
+
+    const Graph* roads;
+    BidirectionalSearch search;
+    size_t cacheLimit;
+    unordered_map<long long, Entry> cache;
+    list<long long> recentPairs;    // most recently used first
+    long long hits;
+    long long misses;
+
+    static long long pairKey(int from, int to) {
+        return ((long long)from << 32) | (unsigned int)to;
+    }
+
+    int roadLength(const vector<int>& nodes, size_t upTo) const {
+        int length = 0;
+        for (size_t i = 0; i < upTo; i++) {
+            length += roads->getEdgeWeight(nodes[i], nodes[i + 1]);
+        }
+        return length;
+    }
+
+    vector<RankedRoute> compute(int from, int to, int k) {
+        vector<RankedRoute> routes;
+        vector<int> path;
+        int distance;
+
+        search.clearBlocks();
+        if (!search.find(from, to, path, distance)) return routes;
+        routes.push_back(RankedRoute(path, distance));
+
+        set<pair<int, vector<int>>> candidates;    // ordered by length, then nodes
+        while ((int)routes.size() < k) {
+            const vector<int>& last = routes.back().nodes;
+
+            for (size_t i = 0; i + 1 < last.size(); i++) {
+                int spurNode = last[i];
+                search.clearBlocks();
+
+                // Roads taken next by earlier routes sharing this root
+                for (const auto& route : routes) {
+                    const vector<int>& nodes = route.nodes;
+                    if (nodes.size() > i + 1 && equal(last.begin(), last.begin() + i + 1, nodes.begin())) {
+                        search.blockRoad(nodes[i], nodes[i + 1]);
+                    }
+                }
+                for (size_t j = 0; j < i; j++) search.blockNode(last[j]);
+
+                vector<int> spur;
+                int spurLength;
+                if (!search.find(spurNode, to, spur, spurLength)) continue;
+
+                vector<int> candidate(last.begin(), last.begin() + i);
+                candidate.insert(candidate.end(), spur.begin(), spur.end());
+                candidates.insert(make_pair(roadLength(last, i) + spurLength, candidate));
+            }
+
+            // Cheapest candidate that isn't already a route
+            bool added = false;
+            while (!candidates.empty() && !added) {
+                auto next = *candidates.begin();
+                candidates.erase(candidates.begin());
+
+                bool known = false;
+                for (const auto& route : routes) {
+                    if (route.nodes == next.second) { known = true; break; }
+                }
+                if (!known) {
+                    routes.push_back(RankedRoute(next.second, next.first));
+                    added = true;
+                }
+            }
+            if (!added) break;  // fewer than k routes exist
+        }
+
+        search.clearBlocks();
+        return routes;
+    }
+
+public:
+    KShortestPaths(const Graph* roadGraph = nullptr, size_t pairLimit = DEFAULT_CACHE_LIMIT)
+        : roads(roadGraph), search(roadGraph), cacheLimit(pairLimit), hits(0), misses(0) {}
+
+    void setRoadNetwork(const Graph* roadGraph) {
+        roads = roadGraph;
+        search.setRoadNetwork(roadGraph);
+        clear();
+    }
+
+    void clear() {
+        cache.clear();
+        recentPairs.clear();
+    }
+
+    // Call after any road is added, removed or re-weighted
+    void roadChanged() { clear(); }
+
+    int size() const { return cache.size(); }
+    long long getHits() const { return hits; }
+    long long getMisses() const { return misses; }
+
+    // Up to k routes from -> to, shortest first; empty if unreachable
+    vector<RankedRoute> routes(int from, int to, int k) {
+        vector<RankedRoute> result;
+        if (!roads || k <= 0) return result;
+
+        long long key = pairKey(from, to);
+        auto it = cache.find(key);
+        // A cached set is good for any k up to the one it was computed for,
+        // or any k at all if it came up short
+        if (it != cache.end() &&
+            (k <= it->second.searched || (int)it->second.routes.size() < it->second.searched)) {
+            hits++;
+            recentPairs.splice(recentPairs.begin(), recentPairs, it->second.recent);
+            const vector<RankedRoute>& cached = it->second.routes;
+            result.assign(cached.begin(), cached.begin() + min((size_t)k, cached.size()));
+            return result;
+        }
+
+        misses++;
+        if (it != cache.end()) {
+            recentPairs.erase(it->second.recent);
+            cache.erase(it);
+        }
+        while (cacheLimit > 0 && cache.size() >= cacheLimit) {
+            cache.erase(recentPairs.back());
+            recentPairs.pop_back();
+        }
+
+        result = compute(from, to, k);
+        recentPairs.push_front(key);
+        Entry& entry = cache[key];
+        entry.routes = result;
+        entry.searched = k;
+        entry.recent = recentPairs.begin();
+        return result;
+    }
+};
+
+#endif // K_SHORTEST_PATHS_H
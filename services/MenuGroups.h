@@ -0,0 +1,77 @@
+#pragma once
+#ifndef MENU_GROUPS_H
+#define MENU_GROUPS_H
+
+#include <vector>
+#include "../models/MenuItem.h"
+#include "../models/Restaurant.h"
+#include "RestaurantDirectory.h"
+
+using namespace std;
+
+// Menu item ids grouped by restaurant, for attaching a whole catalog to
+// its restaurants at load time.
+//
+// Built with a counting sort on the restaurant's directory slot: one pass
+// looks up and counts each item's slot, a prefix sum turns the counts
+// into offsets, and a second pass drops every id into place. Each
+// restaurant then gets one contiguous run of ids, so linking R
+// restaurants and M items costs O(R + M) instead of comparing every
+// restaurant with every item. Within a run, items keep their file order.
+class MenuGroups {
+private:
+    vector<int> offsets;        // run of slot s is [offsets[s], offsets[s + 1])
+    vector<int> itemIds;
+    size_t unmatched;           // items whose restaurant isn't in the directory
+
+public:
+    MenuGroups() : unmatched(0) {}
+
+    void build(const vector<MenuItem>& items, const RestaurantDirectory& directory) {
+        size_t groups = directory.size();
+        vector<int> itemSlots(items.size());
+        offsets.assign(groups + 1, 0);
+        unmatched = 0;
+
+        for (size_t i = 0; i < items.size(); i++) {
+            int slot = directory.slotOf(items[i].restaurantId);
+            itemSlots[i] = slot;
+            if (slot >= 0) offsets[slot + 1]++;
+            else unmatched++;
+        }
+        for (size_t s = 0; s < groups; s++) {
+            offsets[s + 1] += offsets[s];
+        }
+
+        itemIds.assign(offsets[groups], 0);
+        vector<int> next(offsets.begin(), offsets.end() - 1);
+        for (size_t i = 0; i < items.size(); i++) {
+            if (itemSlots[i] >= 0) itemIds[next[itemSlots[i]]++] = items[i].id;
+        }
+    }
+
+    int groupCount() const { return offsets.empty() ? 0 : (int)offsets.size() - 1; }
+
+    // The menu item ids of the restaurant in directory slot slot
+    const int* begin(int slot) const { return itemIds.data() + offsets[slot]; }
+    const int* end(int slot) const { return itemIds.data() + offsets[slot + 1]; }
+    int count(int slot) const { return offsets[slot + 1] - offsets[slot]; }
+
+    size_t getUnmatchedCount() const { return unmatched; }
+
+    // Adds each restaurant's run to its menu. restaurants must be the list
+    // the directory was built from, so slot s is restaurants[s]. Returns
+    // how many ids were added.
+    size_t attachTo(vector<Restaurant>& restaurants) const {
+        size_t attached = 0;
+        int groups = groupCount();
+        for (int slot = 0; slot < groups && slot < (int)restaurants.size(); slot++) {
+            for (const int* id = begin(slot); id != end(slot); ++id) {
+                if (restaurants[slot].addMenuItemId(*id)) attached++;
+            }
+        }
+        return attached;
+    }
+};
+
+#endif // MENU_GROUPS_H
@@ -8,6 +8,7 @@
 #include "../dataStructures/BTree.h"
 #include "../dataStructures/LinkedList.h"
 #include "../dataStructures/Queue.h"
+#include "../Logger.h"
 using namespace std;
 
 class OrderService {
@@ -42,13 +43,13 @@ public:
             for (const auto& order : allOrders) {
                 orderCache.insertItem(order.id, order);
             }
-            cout << "Loaded " << allOrders.size() << " orders from persistent storage.\n";
+            LOG_INFO("Loaded " << allOrders.size() << " orders from persistent storage.");
         }
     }
 
     bool addOrder(const Order& o) {
         if (orderCache.searchTable(o.id) != nullptr) {
-            cout << "Order with ID " << o.id << " already exists.\n";
+            LOG_WARN("Order with ID " << o.id << " already exists.");
             return false;
         }
         
@@ -70,13 +71,13 @@ public:
             readyOrders->enqueue(o);
         }
         
-        cout << "Order #" << o.id << " added successfully.\n";
+        LOG_INFO("Order #" << o.id << " added successfully.");
         return true;
     }
 
     bool removeOrder(int orderId) {
         if (orderCache.searchTable(orderId) == nullptr) {
-            cout << "Order #" << orderId << " not found.\n";
+            LOG_WARN("Order #" << orderId << " not found.");
             return false;
         }
         
@@ -90,7 +91,7 @@ public:
             orders->remove(dummy);
         }
         
-        cout << "Order #" << orderId << " removed.\n";
+        LOG_INFO("Order #" << orderId << " removed.");
         return true;
     }
 
@@ -105,7 +106,7 @@ public:
     bool updateOrderStatus(int orderId, OrderStatus newStatus) {
         Order* o = orderCache.searchTable(orderId);
         if (!o) {
-            cout << "Order #" << orderId << " not found.\n";
+            LOG_WARN("Order #" << orderId << " not found.");
             return false;
         }
         
@@ -120,7 +121,7 @@ public:
             orders->insert(*o);
         }
         
-        cout << "Order #" << orderId << " status updated to " << o->getStatus() << "\n";
+        LOG_INFO("Order #" << orderId << " status updated to " << o->getStatus());
         return true;
     }
     
@@ -138,7 +139,7 @@ public:
         else if (statusStr == "delivered") newStatus = OrderStatus::Delivered;
         else if (statusStr == "cancelled") newStatus = OrderStatus::Cancelled;
         else {
-            cout << "Invalid status string: " << statusStr << "\n";
+            LOG_WARN("Invalid status string: " << statusStr);
             return false;
         }
         
@@ -148,7 +149,7 @@ public:
     bool assignRiderToOrder(int orderId, int riderId) {
         Order* o = orderCache.searchTable(orderId);
         if (!o) {
-            cout << "Order #" << orderId << " not found.\n";
+            LOG_WARN("Order #" << orderId << " not found.");
             return false;
         }
         
@@ -162,7 +163,7 @@ public:
             orders->insert(*o);
         }
         
-        cout << "Rider #" << riderId << " assigned to Order #" << orderId << "\n";
+        LOG_INFO("Rider #" << riderId << " assigned to Order #" << orderId);
         return true;
     }
 
@@ -332,17 +333,17 @@ public:
     bool cancelOrder(int orderId) {
         Order* o = orderCache.searchTable(orderId);
         if (!o) {
-            cout << "Order #" << orderId << " not found.\n";
+            LOG_WARN("Order #" << orderId << " not found.");
             return false;
         }
         
         if (o->isDelivered()) {
-            cout << "Cannot cancel delivered order.\n";
+            LOG_WARN("Cannot cancel delivered order.");
             return false;
         }
         
         if (o->isCancelled()) {
-            cout << "Order already cancelled.\n";
+            LOG_WARN("Order already cancelled.");
             return false;
         }
         
@@ -353,12 +354,12 @@ public:
     bool markOrderDelivered(int orderId) {
         Order* o = orderCache.searchTable(orderId);
         if (!o) {
-            cout << "Order #" << orderId << " not found.\n";
+            LOG_WARN("Order #" << orderId << " not found.");
             return false;
         }
         
         if (o->riderId == -1) {
-            cout << "Cannot mark as delivered: No rider assigned.\n";
+            LOG_WARN("Cannot mark as delivered: No rider assigned.");
             return false;
         }
         
@@ -382,7 +383,7 @@ public:
         if (orders) {
             orders->clear();
         }
-        cout << "All orders cleared.\n";
+        LOG_INFO("All orders cleared.");
     }
 };
 
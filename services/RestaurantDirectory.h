@@ -0,0 +1,75 @@
+#pragma once
+#ifndef RESTAURANT_DIRECTORY_H
+#define RESTAURANT_DIRECTORY_H
+
+#include <vector>
+#include <unordered_map>
+#include "../models/Restaurant.h"
+#include "../models/RestaurantSummary.h"
+
+using namespace std;
+
+// Hot index over a list of full Restaurant records.
+//
+// Summaries are kept densely in the same order as the records they were
+// built from, so slotOf(id) is also the position of the cold record in
+// that list. Rebuild after the list is added to, removed from or reloaded;
+// the slots of a stale directory point at the wrong records.
+class RestaurantDirectory {
+private:
+    vector<RestaurantSummary> summaries;
+    unordered_map<int, int> slots;      // restaurant id -> index in summaries
+    CuisineTable cuisines;
+
+public:
+    static RestaurantSummary summarize(const Restaurant& r, CuisineTable& cuisines) {
+        RestaurantSummary summary;
+        summary.restaurantId = r.getRestaurantId();
+        summary.locationNode = r.getLocationNode();
+        summary.rating = (float)r.getRating();
+        summary.deliveryTime = (short)r.getDeliveryTime();
+        summary.cuisineId = (short)cuisines.intern(r.getCuisine());
+        return summary;
+    }
+
+    void rebuild(const vector<Restaurant>& restaurants) {
+        summaries.clear();
+        summaries.reserve(restaurants.size());
+        slots.clear();
+        for (const auto& r : restaurants) {
+            slots[r.getRestaurantId()] = summaries.size();
+            summaries.push_back(summarize(r, cuisines));
+        }
+    }
+
+    // -1 if there's no restaurant with that id
+    int slotOf(int restaurantId) const {
+        auto it = slots.find(restaurantId);
+        return it != slots.end() ? it->second : -1;
+    }
+
+    const RestaurantSummary* find(int restaurantId) const {
+        int slot = slotOf(restaurantId);
+        return slot >= 0 ? &summaries[slot] : nullptr;
+    }
+
+    const vector<RestaurantSummary>& all() const { return summaries; }
+
+    vector<RestaurantSummary> byCuisine(const string& cuisine) const {
+        vector<RestaurantSummary> result;
+        int id = cuisines.find(cuisine);
+        if (id < 0) return result;
+        for (const auto& summary : summaries) {
+            if (summary.cuisineId == id) result.push_back(summary);
+        }
+        return result;
+    }
+
+    string cuisineName(const RestaurantSummary& summary) const {
+        return cuisines.name(summary.cuisineId);
+    }
+
+    int size() const { return summaries.size(); }
+};
+
+#endif // RESTAURANT_DIRECTORY_H
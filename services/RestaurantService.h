@@ -17,6 +17,7 @@ using namespace std;
 class RestaurantService {
 private:
     HashTable<Restaurant> restaurants;
+    HashTable<MenuItem> menuItems;      // by item id; restaurants only keep the ids
     PersistentBTree<Restaurant>* persistentRestaurants;
     PersistentBTree<MenuItem>* menuItemsBTree;
 
@@ -56,8 +57,12 @@ public:
     }
 
     bool removeRestaurant(int restaurantId) {
-        if (restaurants.searchTable(restaurantId) == nullptr) return false;
+        Restaurant* r = restaurants.searchTable(restaurantId);
+        if (r == nullptr) return false;
         
+        for (int itemId : r->getMenuItemIds()) {
+            menuItems.removeItem(itemId);
+        }
         restaurants.removeItem(restaurantId);
         
         if (persistentRestaurants) {
@@ -80,8 +85,8 @@ public:
         // Check if restaurant can add more items - use getter
         if (r->getMenuItemCount() >= 50) return false;
         
-        // Check for duplicate ID in restaurant - use Restaurant method
-        if (r->hasMenuItem(item.id)) return false;
+        // Check for duplicate ID
+        if (menuItems.searchTable(item.id) != nullptr) return false;
         
         // Add menu item to menuItemsBTree
         if (menuItemsBTree) {
@@ -93,8 +98,10 @@ public:
             menuItemsBTree->insert(item);
         }
         
-        // Add menu item using Restaurant's method
-        bool added = r->addMenuItem(item);
+        bool added = r->addMenuItemId(item.id);
+        if (added) {
+            menuItems.insertItem(item.id, item);
+        }
         
         if (added && persistentRestaurants) {
             // Update restaurant in persistent storage
@@ -105,55 +112,50 @@ public:
         return added;
     }
 
-    // FIXED: Use Restaurant class methods
+    // Puts an item read back from menu_items.dat on its restaurant's menu,
+    // without writing anything
+    bool loadMenuItem(const MenuItem& item) {
+        Restaurant* r = restaurants.searchTable(item.restaurantId);
+        if (!r) return false;
+        
+        if (!r->hasMenuItemId(item.id) && !r->addMenuItemId(item.id)) return false;
+        menuItems.insertItem(item.id, item);
+        return true;
+    }
+
     bool removeMenuItem(int restaurantId, int itemId) {
         Restaurant* r = restaurants.searchTable(restaurantId);
         if (!r) return false;
         
         // First check if restaurant has this item
-        if (!r->hasMenuItem(itemId)) return false;
-        
-        // For simplicity, we'll just remove from the IDs array
-        // In a real implementation, you might want to also remove from menuItems array
-        bool removed = false;
-        
-        // Get all menu item IDs
-        vector<int> itemIds = r->getMenuItemIds();
+        if (!r->hasMenuItemId(itemId)) return false;
         
-        // Find and remove the item ID
-        auto it = find(itemIds.begin(), itemIds.end(), itemId);
-        if (it != itemIds.end()) {
-            itemIds.erase(it);
-            removed = true;
-        }
+        r->removeMenuItemId(itemId);
+        menuItems.removeItem(itemId);
         
         // Remove from menuItemsBTree
-        if (removed && menuItemsBTree) {
+        if (menuItemsBTree) {
             MenuItem dummy(itemId, "", "", 0.0, 0, "", 0);
             menuItemsBTree->remove(dummy);
         }
         
-        // Note: Since Restaurant doesn't have a remove method for menuItems array,
-        // we need to handle this differently or add that method to Restaurant class
+        if (persistentRestaurants) {
+            persistentRestaurants->remove(*r);
+            persistentRestaurants->insert(*r);
+        }
         
-        return removed;
+        return true;
     }
 
-    // FIXED: Use Restaurant class methods
     MenuItem* getMenuItem(int restaurantId, int itemId) {
-        Restaurant* r = restaurants.searchTable(restaurantId);
-        if (!r) return nullptr;
-        
-        // Use Restaurant's method
-        return r->getMenuItem(itemId);
+        MenuItem* item = menuItems.searchTable(itemId);
+        if (!item || item->restaurantId != restaurantId) return nullptr;
+        return item;
     }
 
     // FIXED: Update menu item stock
     bool updateMenuItemStock(int restaurantId, int itemId, int newStock) {
-        Restaurant* r = restaurants.searchTable(restaurantId);
-        if (!r) return false;
-        
-        MenuItem* item = r->getMenuItem(itemId);
+        MenuItem* item = getMenuItem(restaurantId, itemId);
         if (!item) return false;
         
         item->stock = newStock;
@@ -171,20 +173,12 @@ public:
             }
         }
         
-        if (persistentRestaurants) {
-            persistentRestaurants->remove(*r);
-            persistentRestaurants->insert(*r);
-        }
-        
         return true;
     }
 
     // FIXED: Update menu item price
     bool updateMenuItemPrice(int restaurantId, int itemId, double newPrice) {
-        Restaurant* r = restaurants.searchTable(restaurantId);
-        if (!r) return false;
-        
-        MenuItem* item = r->getMenuItem(itemId);
+        MenuItem* item = getMenuItem(restaurantId, itemId);
         if (!item) return false;
         
         item->price = newPrice;
@@ -202,11 +196,6 @@ public:
             }
         }
         
-        if (persistentRestaurants) {
-            persistentRestaurants->remove(*r);
-            persistentRestaurants->insert(*r);
-        }
-        
         return true;
     }
 
@@ -214,10 +203,7 @@ public:
     bool updateMenuItem(int restaurantId, int itemId, const string& newName = "", 
                        double newPrice = -1, int newStock = -1, 
                        const string& newDescription = "", const string& newCategory = "") {
-        Restaurant* r = restaurants.searchTable(restaurantId);
-        if (!r) return false;
-        
-        MenuItem* item = r->getMenuItem(itemId);
+        MenuItem* item = getMenuItem(restaurantId, itemId);
         if (!item) return false;
         
         // Update fields
@@ -272,36 +258,26 @@ public:
             }
         }
         
-        if (persistentRestaurants) {
-            persistentRestaurants->remove(*r);
-            persistentRestaurants->insert(*r);
-        }
-        
         return true;
     }
 
     // FIXED: Get all menu items for a restaurant
     vector<MenuItem> getRestaurantMenu(int restaurantId) {
-        vector<MenuItem> menuItems;
+        vector<MenuItem> menu;
         
         Restaurant* r = restaurants.searchTable(restaurantId);
-        if (!r) return menuItems;
-        
-        // Use Restaurant's method to get menu items
-        // We need to add a method to Restaurant to get all menu items
-        // For now, let's assume we can get them
+        if (!r) return menu;
         
-        // Get all menu item IDs first
         vector<int> itemIds = r->getMenuItemIds();
         
         for (int itemId : itemIds) {
-            MenuItem* item = r->getMenuItem(itemId);
+            MenuItem* item = menuItems.searchTable(itemId);
             if (item) {
-                menuItems.push_back(*item);
+                menu.push_back(*item);
             }
         }
         
-        return menuItems;
+        return menu;
     }
 
     // FIXED: Print restaurant menu
@@ -312,7 +288,19 @@ public:
             return;
         }
         
-        r->printMenu();
+        vector<MenuItem> menu = getRestaurantMenu(restaurantId);
+        if (menu.empty()) {
+            cout << "No menu items available.\n";
+            return;
+        }
+        
+        for (const auto& item : menu) {
+            cout << "  [" << item.id << "] " << item.name << "\n";
+            cout << "      " << item.description << "\n";
+            cout << "      Price: $" << item.price << "\n";
+            cout << "      Stock: " << item.stock << "\n";
+            cout << "      Category: " << item.category << "\n\n";
+        }
     }
 
     // FIXED: Get restaurants by cuisine
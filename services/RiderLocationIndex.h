@@ -0,0 +1,96 @@
+#pragma once
+#ifndef RIDER_LOCATION_INDEX_H
+#define RIDER_LOCATION_INDEX_H
+
+#include <vector>
+#include <unordered_map>
+#include <climits>
+#include "../dataStructures/Graph.h"
+
+using namespace std;
+
+// Available riders bucketed by the graph node they are standing on.
+// nearest() answers "k closest riders to node R by road distance" with a
+// single Dijkstra expansion from R that stops once k riders have been
+// reached, so its cost depends on how far the search has to spread rather
+// than on how many riders are on shift.
+class RiderLocationIndex {
+private:
+    unordered_map<int, int> riderNode;              // riderId -> node
+    unordered_map<int, vector<int>> ridersAtNode;   // node -> riderIds
+
+    void detach(int riderId, int node) {
+        auto bucket = ridersAtNode.find(node);
+        if (bucket == ridersAtNode.end()) return;
+
+        vector<int>& ids = bucket->second;
+        for (size_t i = 0; i < ids.size(); i++) {
+            if (ids[i] == riderId) {
+                ids[i] = ids.back();
+                ids.pop_back();
+                break;
+            }
+        }
+        if (ids.empty()) ridersAtNode.erase(bucket);
+    }
+
+public:
+    // Insert a rider or move it to a new node
+    void update(int riderId, int node) {
+        auto it = riderNode.find(riderId);
+        if (it != riderNode.end()) {
+            if (it->second == node) return;
+            detach(riderId, it->second);
+            it->second = node;
+        } else {
+            riderNode[riderId] = node;
+        }
+        ridersAtNode[node].push_back(riderId);
+    }
+
+    bool remove(int riderId) {
+        auto it = riderNode.find(riderId);
+        if (it == riderNode.end()) return false;
+        detach(riderId, it->second);
+        riderNode.erase(it);
+        return true;
+    }
+
+    bool contains(int riderId) const {
+        return riderNode.find(riderId) != riderNode.end();
+    }
+
+    int size() const {
+        return riderNode.size();
+    }
+
+    void clear() {
+        riderNode.clear();
+        ridersAtNode.clear();
+    }
+
+    // Up to k (riderId, roadDistance) pairs, closest first. Riders on nodes
+    // that can't reach the target are never returned.
+    vector<pair<int, int>> nearest(const Graph& roads, int node, int k,
+                                   int maxDistance = INT_MAX) const {
+        vector<pair<int, int>> result;
+        if (k <= 0 || riderNode.empty()) return result;
+
+        roads.expandFrom(node, [&](int current, int distance) {
+            auto bucket = ridersAtNode.find(current);
+            if (bucket != ridersAtNode.end()) {
+                for (int riderId : bucket->second) {
+                    result.push_back(make_pair(riderId, distance));
+                    if ((int)result.size() >= k) return true;
+                }
+                // Every indexed rider found; no point expanding further
+                if (result.size() == riderNode.size()) return true;
+            }
+            return false;
+        }, maxDistance);
+
+        return result;
+    }
+};
+
+#endif // RIDER_LOCATION_INDEX_H
@@ -7,15 +7,20 @@
 #include "../models/Rider.h"
 #include "../dataStructures/HashTable.h"
 #include "../dataStructures/LinkedList.h"
-#include "../dataStructures/PriorityQueue.h"
+#include "../dataStructures/IndexedPriorityQueue.h"
 #include "../dataStructures/BTree.h"
+#include "../dataStructures/Graph.h"
+#include "RiderLocationIndex.h"
+#include "../Logger.h"
 using namespace std;
 
 class RiderService {
 private:
     HashTable<Rider> riders;
-    PriorityQueue<Rider*>* availableRiders;
+    IndexedPriorityQueue<Rider*>* availableRiders;
     PersistentBTree<Rider>* persistentRiders;
+    const Graph* roadNetwork;
+    RiderLocationIndex locationIndex;   // available riders by graph node
 
     int calculatePriority(Rider* rider) {
         // Lower number = higher priority
@@ -26,32 +31,35 @@ private:
     
     // Helper to remove rider from priority queue
     void removeFromAvailableQueue(Rider* rider) {
-        if (!availableRiders || !rider) return;
-        
-        // Get all elements from queue
-        vector<pair<Rider*, int>> tempItems;
-        
-        while (!availableRiders->isEmpty()) {
-            Rider* current = availableRiders->peek();
-            int priority = availableRiders->peekPriority();
-            availableRiders->dequeue();
-            
-            if (current && current->id != rider->id) {
-                tempItems.push_back(make_pair(current, priority));
-            }
-        }
-        
-        // Rebuild queue without the removed rider
-        for (const auto& item : tempItems) {
-            availableRiders->enqueue(item.first, item.second);
-        }
+        if (!rider) return;
+        locationIndex.remove(rider->id);
+        if (availableRiders) availableRiders->remove(rider);
+    }
+    
+    // Helper to add (or re-rank) a rider in the available queue and index
+    void addToAvailableQueue(Rider* rider) {
+        if (!rider) return;
+        locationIndex.update(rider->id, rider->location);
+        if (availableRiders) availableRiders->enqueue(rider, calculatePriority(rider));
+    }
+    
+    int roadDistance(int from, int to) const {
+        if (!roadNetwork) return -1;
+        int result = -1;
+        roadNetwork->expandFrom(from, [&](int node, int distance) {
+            if (node != to) return false;
+            result = distance;
+            return true;
+        });
+        return result;
     }
 
 public:
-    RiderService() : availableRiders(nullptr), persistentRiders(nullptr) {}
+    RiderService() : availableRiders(nullptr), persistentRiders(nullptr), roadNetwork(nullptr) {}
     
-    RiderService(PersistentBTree<Rider>* persistent, PriorityQueue<Rider*>* riderQueue = nullptr) 
-        : persistentRiders(persistent), availableRiders(riderQueue) {
+    RiderService(PersistentBTree<Rider>* persistent, IndexedPriorityQueue<Rider*>* riderQueue = nullptr,
+                 const Graph* roads = nullptr) 
+        : availableRiders(riderQueue), persistentRiders(persistent), roadNetwork(roads) {
         // Load riders from persistent storage to cache
         if (persistentRiders && !persistentRiders->isEmpty()) {
             loadRidersFromPersistent();
@@ -73,21 +81,17 @@ public:
         for (const Rider& r : allRiders) {
             riders.insertItem(r.id, r);
             
-            if (availableRiders && strcmp(r.status, "available") == 0) {
-                Rider* riderPtr = riders.searchTable(r.id);
-                if (riderPtr) {
-                    int priority = calculatePriority(riderPtr);
-                    availableRiders->enqueue(riderPtr, priority);
-                }
+            if (strcmp(r.status, "available") == 0) {
+                addToAvailableQueue(riders.searchTable(r.id));
             }
         }
         
-        cout << "Loaded " << allRiders.size() << " riders from persistent storage.\n";
+        LOG_INFO("Loaded " << allRiders.size() << " riders from persistent storage.");
     }
 
     bool addRider(const Rider& r) {
         if (riders.searchTable(r.id) != nullptr) {
-            cout << "ERROR: Rider with ID " << r.id << " already exists.\n";
+            LOG_WARN("Rider with ID " << r.id << " already exists.");
             return false;
         }
         
@@ -97,27 +101,23 @@ public:
             persistentRiders->insert(r);
         }
         
-        if (availableRiders && strcmp(r.status, "available") == 0) {
-            Rider* riderPtr = riders.searchTable(r.id);
-            if (riderPtr) {
-                int priority = calculatePriority(riderPtr);
-                availableRiders->enqueue(riderPtr, priority);
-            }
+        if (strcmp(r.status, "available") == 0) {
+            addToAvailableQueue(riders.searchTable(r.id));
         }
         
-        cout << "Rider " << r.name << " (ID: " << r.id << ") added successfully.\n";
+        LOG_INFO("Rider " << r.name << " (ID: " << r.id << ") added successfully.");
         return true;
     }
 
     bool removeRider(int riderId) {
         Rider* rider = riders.searchTable(riderId);
         if (rider == nullptr) {
-            cout << "ERROR: Rider with ID " << riderId << " not found.\n";
+            LOG_WARN("Rider with ID " << riderId << " not found.");
             return false;
         }
         
         // Remove from available riders if present
-        if (availableRiders && strcmp(rider->status, "available") == 0) {
+        if (strcmp(rider->status, "available") == 0) {
             removeFromAvailableQueue(rider);
         }
         
@@ -129,7 +129,7 @@ public:
         // Remove from hash table
         riders.removeItem(riderId);
         
-        cout << "Rider ID " << riderId << " removed successfully.\n";
+        LOG_INFO("Rider ID " << riderId << " removed successfully.");
         return true;
     }
 
@@ -144,7 +144,7 @@ public:
     bool updateRiderLocation(int riderId, int newLocation) {
         Rider* r = riders.searchTable(riderId);
         if (!r) {
-            cout << "ERROR: Rider with ID " << riderId << " not found.\n";
+            LOG_WARN("Rider with ID " << riderId << " not found.");
             return false;
         }
         
@@ -152,11 +152,8 @@ public:
         r->location = newLocation;
         
         // Update priority if in available riders
-        if (availableRiders && strcmp(r->status, "available") == 0) {
-            // Remove and re-add with new priority
-            removeFromAvailableQueue(r);
-            int priority = calculatePriority(r);
-            availableRiders->enqueue(r, priority);
+        if (strcmp(r->status, "available") == 0) {
+            addToAvailableQueue(r);
         }
         
         // Update persistent storage
@@ -167,8 +164,8 @@ public:
             persistentRiders->insert(*r);
         }
         
-        cout << "Rider ID " << riderId << " location updated from " 
-             << oldLocation << " to " << newLocation << ".\n";
+        LOG_DEBUG("Rider ID " << riderId << " location updated from " 
+             << oldLocation << " to " << newLocation << ".");
         return true;
     }
     Rider* findRiderByEmail(const string& email) {
@@ -184,7 +181,7 @@ public:
     bool updateRiderStatus(int riderId, const string& status) {
         Rider* r = riders.searchTable(riderId);
         if (!r) {
-            cout << "ERROR: Rider with ID " << riderId << " not found.\n";
+            LOG_WARN("Rider with ID " << riderId << " not found.");
             return false;
         }
         
@@ -192,7 +189,7 @@ public:
         strcpy(oldStatus, r->status);
         
         if (strcmp(oldStatus, status.c_str()) == 0) {
-            cout << "Rider ID " << riderId << " already has status: " << status << "\n";
+            LOG_DEBUG("Rider ID " << riderId << " already has status: " << status);
             return true;
         }
         
@@ -200,15 +197,10 @@ public:
         r->status[sizeof(r->status) - 1] = '\0';
         
         // Update available riders queue
-        if (availableRiders) {
-            if (status == "available" && strcmp(oldStatus, "available") != 0) {
-                // Add to available queue
-                int priority = calculatePriority(r);
-                availableRiders->enqueue(r, priority);
-            } else if (status != "available" && strcmp(oldStatus, "available") == 0) {
-                // Remove from available queue
-                removeFromAvailableQueue(r);
-            }
+        if (status == "available" && strcmp(oldStatus, "available") != 0) {
+            addToAvailableQueue(r);
+        } else if (status != "available" && strcmp(oldStatus, "available") == 0) {
+            removeFromAvailableQueue(r);
         }
         
         // Update persistent storage
@@ -219,8 +211,8 @@ public:
             persistentRiders->insert(*r);
         }
         
-        cout << "Rider ID " << riderId << " status updated from '" 
-             << oldStatus << "' to '" << status << "'.\n";
+        LOG_DEBUG("Rider ID " << riderId << " status updated from '" 
+             << oldStatus << "' to '" << status << "'.");
         return true;
     }
 
@@ -234,12 +226,43 @@ public:
         return available;
     }
 
-    Rider* findBestRider(int pickupLocation, int deliveryLocation) {
+    // Road graph used for distance-based matching; without one the
+    // rating-ordered queue is used instead
+    void setRoadNetwork(const Graph* roads) {
+        roadNetwork = roads;
+    }
+    
+    // Up to k available riders closest to node by road distance, nearest
+    // first, as (rider, distance) pairs. One graph search regardless of how
+    // many riders are available.
+    vector<pair<Rider*, int>> findNearestRiders(int node, int k) {
+        vector<pair<Rider*, int>> result;
+        if (!roadNetwork) return result;
+        
+        for (const auto& hit : locationIndex.nearest(*roadNetwork, node, k)) {
+            Rider* rider = riders.searchTable(hit.first);
+            if (rider) result.push_back(make_pair(rider, hit.second));
+        }
+        return result;
+    }
+    
+    Rider* findBestRider(int pickupLocation) {
+        // Nearest available rider to the pickup by road distance
+        if (roadNetwork) {
+            vector<pair<Rider*, int>> nearest = findNearestRiders(pickupLocation, 1);
+            if (!nearest.empty()) {
+                LOG_DEBUG("Best rider (nearest): " << nearest[0].first->name 
+                     << " (ID: " << nearest[0].first->id << ") at distance " 
+                     << nearest[0].second);
+                return nearest[0].first;
+            }
+        }
+        
         if (!availableRiders || availableRiders->isEmpty()) {
             // Fallback: find best available rider manually
             LinkedList<Rider> available = getAvailableRiders();
             if (available.isEmpty()) {
-                cout << "No available riders found.\n";
+                LOG_DEBUG("No available riders found.");
                 return nullptr;
             }
             
@@ -249,7 +272,8 @@ public:
             
             auto* node = available.getHead();
             while (node != nullptr) {
-                double score = node->data.calculatePriority(pickupLocation, deliveryLocation);
+                int distance = roadDistance(node->data.location, pickupLocation);
+                double score = node->data.calculatePriority(distance);
                 if (score > bestScore) {
                     bestScore = score;
                     // Get pointer from hash table
@@ -259,8 +283,8 @@ public:
             }
             
             if (best) {
-                cout << "Best rider (fallback): " << best->name 
-                     << " (ID: " << best->id << ") with score: " << bestScore << "\n";
+                LOG_DEBUG("Best rider (fallback): " << best->name 
+                     << " (ID: " << best->id << ") with score: " << bestScore);
             }
             return best;
         }
@@ -268,9 +292,9 @@ public:
         // Get highest priority rider from queue
         Rider* best = availableRiders->peek();
         if (best) {
-            cout << "Best rider from queue: " << best->name 
+            LOG_DEBUG("Best rider from queue: " << best->name 
                  << " (ID: " << best->id 
-                 << ", Priority: " << availableRiders->peekPriority() << ")\n";
+                 << ", Priority: " << availableRiders->peekPriority() << ")");
         }
         return best;
     }
@@ -279,19 +303,19 @@ public:
     bool assignRiderToOrder(int riderId, int orderId) {
         Rider* rider = getRider(riderId);
         if (!rider) {
-            cout << "ERROR: Rider with ID " << riderId << " not found.\n";
+            LOG_WARN("Rider with ID " << riderId << " not found.");
             return false;
         }
         
         if (strcmp(rider->status, "available") != 0) {
-            cout << "ERROR: Rider ID " << riderId << " is not available (Status: " 
-                 << rider->status << ").\n";
+            LOG_WARN("Rider ID " << riderId << " is not available (Status: " 
+                 << rider->status << ").");
             return false;
         }
         
         // Update status to busy
-        cout << "Assigning Rider " << rider->name << " (ID: " << riderId 
-             << ") to Order " << orderId << ".\n";
+        LOG_INFO("Assigning Rider " << rider->name << " (ID: " << riderId 
+             << ") to Order " << orderId << ".");
         return updateRiderStatus(riderId, "busy");
     }
     
@@ -299,11 +323,11 @@ public:
     bool completeDelivery(int riderId, int newLocation) {
         Rider* rider = getRider(riderId);
         if (!rider) {
-            cout << "ERROR: Rider with ID " << riderId << " not found.\n";
+            LOG_WARN("Rider with ID " << riderId << " not found.");
             return false;
         }
         
-        cout << "Completing delivery for Rider " << rider->name << " (ID: " << riderId << ").\n";
+        LOG_INFO("Completing delivery for Rider " << rider->name << " (ID: " << riderId << ").");
         
         // Update location
         if (!updateRiderLocation(riderId, newLocation)) {
@@ -397,12 +421,12 @@ public:
     bool updateRiderRating(int riderId, double newRating) {
         Rider* r = riders.searchTable(riderId);
         if (!r) {
-            cout << "ERROR: Rider with ID " << riderId << " not found.\n";
+            LOG_WARN("Rider with ID " << riderId << " not found.");
             return false;
         }
         
         if (newRating < 0.0 || newRating > 5.0) {
-            cout << "ERROR: Invalid rating. Must be between 0.0 and 5.0.\n";
+            LOG_WARN("Invalid rating. Must be between 0.0 and 5.0.");
             return false;
         }
         
@@ -410,10 +434,8 @@ public:
         r->rating = newRating;
         
         // Update priority if in available queue
-        if (availableRiders && strcmp(r->status, "available") == 0) {
-            removeFromAvailableQueue(r);
-            int priority = calculatePriority(r);
-            availableRiders->enqueue(r, priority);
+        if (strcmp(r->status, "available") == 0) {
+            addToAvailableQueue(r);
         }
         
         // Update persistent storage
@@ -424,8 +446,8 @@ public:
             persistentRiders->insert(*r);
         }
         
-        cout << "Rider ID " << riderId << " rating updated from " 
-             << oldRating << " to " << newRating << ".\n";
+        LOG_INFO("Rider ID " << riderId << " rating updated from " 
+             << oldRating << " to " << newRating << ".");
         return true;
     }
     
@@ -433,7 +455,7 @@ public:
     bool updateRiderVehicle(int riderId, const string& newVehicle) {
         Rider* r = riders.searchTable(riderId);
         if (!r) {
-            cout << "ERROR: Rider with ID " << riderId << " not found.\n";
+            LOG_WARN("Rider with ID " << riderId << " not found.");
             return false;
         }
         
@@ -451,8 +473,8 @@ public:
             persistentRiders->insert(*r);
         }
         
-        cout << "Rider ID " << riderId << " vehicle updated from '" 
-             << oldVehicle << "' to '" << newVehicle << "'.\n";
+        LOG_INFO("Rider ID " << riderId << " vehicle updated from '" 
+             << oldVehicle << "' to '" << newVehicle << "'.");
         return true;
     }
     
@@ -496,13 +518,14 @@ public:
     // Clear all riders
     void clearAllRiders() {
         riders.clear();
+        locationIndex.clear();
         if (availableRiders) {
             availableRiders->clear();
         }
         if (persistentRiders) {
             persistentRiders->clear();
         }
-        cout << "All riders cleared from the system.\n";
+        LOG_INFO("All riders cleared from the system.");
     }
     
     // Friend operator for output
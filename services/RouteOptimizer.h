@@ -0,0 +1,271 @@
+#pragma once
+#ifndef ROUTE_OPTIMIZER_H
+#define ROUTE_OPTIMIZER_H
+
+#include <vector>
+#include <climits>
+#include <algorithm>
+#include "../dataStructures/Graph.h"
+#include "../dataStructures/WorkStealingPool.h"
+#include "ShortestPathCache.h"
+
+using namespace std;
+
+// A pickup order for one rider: restaurants in visiting order, then the
+// customer. totalDistance counts from the rider's node to the drop-off.
+struct PickupPlan {
+    int riderNode;
+    vector<int> sequence;
+    int totalDistance;      // RouteOptimizer::UNREACHABLE if no route
+
+    PickupPlan() : riderNode(-1), totalDistance(0) {}
+};
+
+// Chooses the order in which a rider collects several restaurants before
+// heading to the customer.
+//
+// Stop-to-stop road distances come from one shortest-path tree per stop,
+// cached and repaired in place through roadChanged(). Up to
+// HELD_KARP_LIMIT pickups are solved exactly with Held-Karp, computed
+// backwards from the drop-off so the table is shared by every rider; each
+// candidate rider then only costs one lookup per first stop. Larger
+// routes use nearest-neighbour construction improved by 2-opt and Or-opt.
+//
+// With a WorkStealingPool attached, missing trees are built in parallel
+// and the per-rider 2-opt passes run in parallel; results are collected
+// by index, so the plans don't depend on thread timing.
+class RouteOptimizer {
+public:
+    enum {
+        UNREACHABLE = INT_MAX / 4,
+        HELD_KARP_LIMIT = 10
+    };
+
+private:
+    const Graph* roads;
+    WorkStealingPool* workers;
+    ShortestPathCache paths;
+
+    static int add(int a, int b) {
+        if (a >= UNREACHABLE || b >= UNREACHABLE) return UNREACHABLE;
+        return min(a + b, (int)UNREACHABLE);
+    }
+
+    // Cost of start -> path[0] -> ... -> path.back() -> dropoff
+    static int pathCost(const vector<int>& fromStart, const vector<vector<int>>& between,
+                        const vector<int>& toDropoff, const vector<int>& path) {
+        if (path.empty()) return 0;
+        int total = fromStart[path[0]];
+        for (size_t i = 0; i + 1 < path.size(); i++) {
+            total = add(total, between[path[i]][path[i + 1]]);
+        }
+        return add(total, toDropoff[path.back()]);
+    }
+
+    // Nearest neighbour, then 2-opt and Or-opt until neither improves
+    static vector<int> improveRoute(const vector<int>& fromStart, const vector<vector<int>>& between,
+                                    const vector<int>& toDropoff) {
+        size_t n = toDropoff.size();
+        vector<int> path;
+        vector<bool> used(n, false);
+
+        for (size_t step = 0; step < n; step++) {
+            int best = -1;
+            int bestCost = INT_MAX;
+            for (size_t j = 0; j < n; j++) {
+                if (used[j]) continue;
+                int cost = path.empty() ? fromStart[j] : between[path.back()][j];
+                if (cost < bestCost) {
+                    bestCost = cost;
+                    best = (int)j;
+                }
+            }
+            used[best] = true;
+            path.push_back(best);
+        }
+
+        int current = pathCost(fromStart, between, toDropoff, path);
+        bool improved = true;
+        while (improved) {
+            improved = false;
+
+            // 2-opt: reverse path[i..k]
+            for (size_t i = 0; i + 1 < n && !improved; i++) {
+                for (size_t k = i + 1; k < n && !improved; k++) {
+                    reverse(path.begin() + i, path.begin() + k + 1);
+                    int cost = pathCost(fromStart, between, toDropoff, path);
+                    if (cost < current) {
+                        current = cost;
+                        improved = true;
+                    } else {
+                        reverse(path.begin() + i, path.begin() + k + 1);
+                    }
+                }
+            }
+
+            // Or-opt: move a run of 1-3 stops to another position
+            for (size_t len = 1; len <= 3 && len < n && !improved; len++) {
+                for (size_t i = 0; i + len <= n && !improved; i++) {
+                    vector<int> segment(path.begin() + i, path.begin() + i + len);
+                    vector<int> rest(path.begin(), path.begin() + i);
+                    rest.insert(rest.end(), path.begin() + i + len, path.end());
+
+                    for (size_t pos = 0; pos <= rest.size() && !improved; pos++) {
+                        if (pos == i) continue;
+                        vector<int> candidate(rest.begin(), rest.begin() + pos);
+                        candidate.insert(candidate.end(), segment.begin(), segment.end());
+                        candidate.insert(candidate.end(), rest.begin() + pos, rest.end());
+
+                        int cost = pathCost(fromStart, between, toDropoff, candidate);
+                        if (cost < current) {
+                            current = cost;
+                            path = candidate;
+                            improved = true;
+                        }
+                    }
+                }
+            }
+        }
+        return path;
+    }
+
+public:
+    RouteOptimizer(const Graph* roadGraph = nullptr, WorkStealingPool* pool = nullptr)
+        : roads(roadGraph), workers(pool), paths(roadGraph) {}
+
+    void setWorkers(WorkStealingPool* pool) { workers = pool; }
+
+    void setRoadNetwork(const Graph* roadGraph) {
+        roads = roadGraph;
+        paths.setRoadNetwork(roadGraph);
+    }
+
+    // Drops every cached distance
+    void invalidate() {
+        paths.clear();
+    }
+
+    // Call after a road is added, removed or re-weighted (weight -1 = no
+    // road); cached distances are repaired rather than dropped. Returns
+    // the number of nodes whose distances were recomputed.
+    int roadChanged(int from, int to, int oldWeight, int newWeight) {
+        return paths.roadChanged(from, to, oldWeight, newWeight);
+    }
+
+    // Builds the cached trees for every source not cached yet, spread
+    // over the pool
+    void prefetch(const vector<int>& sources) {
+        paths.prefetch(sources, workers);
+    }
+
+    int distance(int from, int to) {
+        int d = paths.distance(from, to);
+        return d == ShortestPathCache::UNREACHABLE ? (int)UNREACHABLE : d;
+    }
+
+    // Best pickup order from each rider node through every pickup to the
+    // drop-off. Plans come back in the same order as riderNodes.
+    vector<PickupPlan> planForRiders(const vector<int>& riderNodes,
+                                     const vector<int>& pickups, int dropoff) {
+        vector<PickupPlan> plans(riderNodes.size());
+        size_t n = pickups.size();
+
+        prefetch(pickups);
+
+        // Pickup-to-pickup and pickup-to-dropoff legs, shared by all riders.
+        // Roads are undirected, so a pickup's row also gives rider -> pickup.
+        vector<vector<int>> between(n, vector<int>(n, 0));
+        vector<int> toDropoff(n);
+        for (size_t i = 0; i < n; i++) {
+            for (size_t j = 0; j < n; j++) {
+                if (i != j) between[i][j] = distance(pickups[i], pickups[j]);
+            }
+            toDropoff[i] = distance(pickups[i], dropoff);
+        }
+
+        if (n == 0) {
+            for (size_t r = 0; r < riderNodes.size(); r++) {
+                plans[r].riderNode = riderNodes[r];
+                plans[r].totalDistance = distance(dropoff, riderNodes[r]);
+            }
+            return plans;
+        }
+
+        if (n <= HELD_KARP_LIMIT) {
+            // best[mask][i]: shortest way to finish at the drop-off when
+            // standing at pickup i with the pickups in mask already done
+            size_t full = ((size_t)1 << n) - 1;
+            vector<vector<int>> best(full + 1, vector<int>(n, UNREACHABLE));
+            vector<vector<int>> next(full + 1, vector<int>(n, -1));
+
+            for (size_t i = 0; i < n; i++) best[full][i] = toDropoff[i];
+
+            for (size_t mask = full; mask-- > 0;) {
+                for (size_t i = 0; i < n; i++) {
+                    if (!(mask & ((size_t)1 << i))) continue;
+                    for (size_t j = 0; j < n; j++) {
+                        if (mask & ((size_t)1 << j)) continue;
+                        int cost = add(between[i][j], best[mask | ((size_t)1 << j)][j]);
+                        if (cost < best[mask][i]) {
+                            best[mask][i] = cost;
+                            next[mask][i] = (int)j;
+                        }
+                    }
+                }
+            }
+
+            for (size_t r = 0; r < riderNodes.size(); r++) {
+                PickupPlan& plan = plans[r];
+                plan.riderNode = riderNodes[r];
+                plan.totalDistance = UNREACHABLE;
+
+                int first = -1;
+                for (size_t i = 0; i < n; i++) {
+                    int cost = add(distance(pickups[i], riderNodes[r]), best[(size_t)1 << i][i]);
+                    if (cost < plan.totalDistance) {
+                        plan.totalDistance = cost;
+                        first = (int)i;
+                    }
+                }
+                if (first < 0) continue;
+
+                size_t mask = (size_t)1 << first;
+                for (int at = first; at >= 0;) {
+                    plan.sequence.push_back(pickups[at]);
+                    int following = next[mask][at];
+                    if (following >= 0) mask |= (size_t)1 << following;
+                    at = following;
+                }
+            }
+            return plans;
+        }
+
+        // Lookups touch the shared cache, so gather them before going parallel
+        vector<vector<int>> fromStart(riderNodes.size(), vector<int>(n));
+        for (size_t r = 0; r < riderNodes.size(); r++) {
+            for (size_t i = 0; i < n; i++) fromStart[r][i] = distance(pickups[i], riderNodes[r]);
+        }
+
+        auto planRider = [&](size_t r, int) {
+            vector<int> order = improveRoute(fromStart[r], between, toDropoff);
+
+            PickupPlan& plan = plans[r];
+            plan.riderNode = riderNodes[r];
+            plan.totalDistance = pathCost(fromStart[r], between, toDropoff, order);
+            for (int i : order) plan.sequence.push_back(pickups[i]);
+        };
+
+        if (workers) {
+            workers->parallelFor(riderNodes.size(), planRider);
+        } else {
+            for (size_t r = 0; r < riderNodes.size(); r++) planRider(r, 0);
+        }
+        return plans;
+    }
+
+    PickupPlan plan(int riderNode, const vector<int>& pickups, int dropoff) {
+        return planForRiders(vector<int>(1, riderNode), pickups, dropoff)[0];
+    }
+};
+
+#endif // ROUTE_OPTIMIZER_H
@@ -8,6 +8,9 @@
 #include "../dataStructures/Graph.h"
 #include "../models/Rider.h"
 #include "../dataStructures/LinkedList.h"
+#include "TravelTimeModel.h"
+#include "ShortestPathCache.h"
+#include "KShortestPaths.h"
 
 using namespace std;
 
@@ -15,14 +18,20 @@ class RoutingService {
 private:
     Graph* cityMap; // Graph representing the city map
     bool ownsGraph; // Track if we own the graph pointer
+    TravelTimeModel travelTimes; // Time-of-day speed profiles per road
+    ShortestPathCache pathCache; // Shortest-path trees, repaired on road changes
+    KShortestPaths alternatives; // Ranked alternative routes per (from, to)
 
 public:
     RoutingService() : cityMap(nullptr), ownsGraph(false) {}
     
-    RoutingService(Graph* graph) : cityMap(graph), ownsGraph(false) {}
+    RoutingService(Graph* graph)
+        : cityMap(graph), ownsGraph(false), pathCache(graph), alternatives(graph) {}
     
     RoutingService(int numLocations) : ownsGraph(true) {
         cityMap = new Graph(numLocations);
+        pathCache.setRoadNetwork(cityMap);
+        alternatives.setRoadNetwork(cityMap);
     }
     
     ~RoutingService() {
@@ -41,23 +50,40 @@ public:
     // Add a road/edge between two locations with weight (e.g., distance or time)
     void addRoad(int from, int to, int weight) {
         if (cityMap) {
+            int previous = cityMap->getEdgeWeight(from, to);
             cityMap->addEdge(from, to, weight);
+            roadChanged(from, to, previous, weight);
         }
     }
 
     // Remove a road
     void removeRoad(int from, int to) {
         if (cityMap) {
+            int previous = cityMap->getEdgeWeight(from, to);
+            if (previous == -1) return;
             cityMap->removeEdge(from, to);
+            roadChanged(from, to, previous, -1);
         }
     }
 
-    // Calculate shortest path between two nodes using Dijkstra
+    // Call after changing a road on the graph directly (not through
+    // addRoad/removeRoad); -1 stands for "no road"
+    int roadChanged(int from, int to, int oldWeight, int newWeight) {
+        if (oldWeight != newWeight) alternatives.roadChanged();
+        return pathCache.roadChanged(from, to, oldWeight, newWeight);
+    }
+
+    // Shortest path between two nodes, read from the cached shortest-path
+    // tree of startNode
     LinkedList<int> getShortestPath(int startNode, int endNode) {
-        if (!cityMap) {
-            return LinkedList<int>();
+        LinkedList<int> path;
+        if (!cityMap || !cityMap->hasNode(startNode) || !cityMap->hasNode(endNode)) {
+            return path;
+        }
+        for (int node : pathCache.path(startNode, endNode)) {
+            path.insertAtEnd(node);
         }
-        return cityMap->dijkstra(startNode, endNode);
+        return path;
     }
     
     // Get shortest path as vector (for compatibility with existing code)
@@ -77,43 +103,49 @@ public:
 
     // Calculate distance of shortest path
     int getShortestDistance(int startNode, int endNode) {
-        if (!cityMap) return -1;
-        
-        LinkedList<int> path = getShortestPath(startNode, endNode);
-        if (path.isEmpty()) return -1;
-        
-        int distance = 0;
-        auto* current = path.getHead();
-        auto* next = (current != nullptr) ? current->next : nullptr;
+        if (!cityMap || !cityMap->hasNode(startNode) || !cityMap->hasNode(endNode)) return -1;
         
-        while (current != nullptr && next != nullptr) {
-            int weight = cityMap->getEdgeWeight(current->data, next->data);
-            if (weight == -1) return -1; // Edge not found
-            distance += weight;
-            current = next;
-            next = next->next;
-        }
-        return distance;
+        int distance = pathCache.distance(startNode, endNode);
+        return (distance == ShortestPathCache::UNREACHABLE) ? -1 : distance;
     }
 
-    // Estimate delivery time based on distance and vehicle type
+    // Load per-road speed profiles; without them every road is free flow
+    bool loadSpeedProfiles(const string& filename) {
+        return travelTimes.loadFromFile(filename);
+    }
+    
+    TravelTimeModel& getTravelTimes() {
+        return travelTimes;
+    }
+    
+    // Earliest-arrival path for a vehicle leaving at departSecond (seconds
+    // since midnight, -1 = now). arrivalSecond receives the arrival time.
+    vector<int> getFastestPath(int startNode, int endNode, const string& vehicleType,
+                               int departSecond = -1, int* arrivalSecond = nullptr) {
+        if (!cityMap) return vector<int>();
+        if (departSecond < 0) departSecond = TravelTimeModel::currentSecondOfDay();
+        return travelTimes.fastestPath(*cityMap, startNode, endNode, departSecond,
+                                       vehicleType, arrivalSecond);
+    }
+    
+    // Minutes to drive a route that was already planned, at the traffic of
+    // the time it is driven. Returns -1 if the route isn't connected.
+    int estimateTravelTime(const vector<int>& path, const string& vehicleType,
+                           int departSecond = -1) {
+        if (!cityMap) return -1;
+        if (departSecond < 0) departSecond = TravelTimeModel::currentSecondOfDay();
+        
+        int arrival = travelTimes.travelAlongPath(*cityMap, path, departSecond, vehicleType);
+        if (arrival < 0) return -1;
+        return (arrival - departSecond + 59) / 60;
+    }
+    
+    // Estimate delivery time from distance alone (free-flow speed); use
+    // estimateTravelTime() when the route is known
     int estimateDeliveryTime(int distance, const string& vehicleType) {
         if (distance <= 0) return 0;
         
-        // Average speeds in meters per minute
-        int speed = 200; // default: 12 km/h
-        
-        if (vehicleType == "motorcycle" || vehicleType == "motorbike") {
-            speed = 400; // 24 km/h
-        } else if (vehicleType == "car") {
-            speed = 500; // 30 km/h
-        } else if (vehicleType == "bike" || vehicleType == "bicycle") {
-            speed = 150; // 9 km/h
-        } else if (vehicleType == "walking") {
-            speed = 80;  // 4.8 km/h
-        }
-        
-        int timeMinutes = distance / speed;
+        int timeMinutes = distance / TravelTimeModel::freeFlowSpeed(vehicleType);
         return max(5, timeMinutes); // Minimum 5 minutes
     }
     
@@ -199,6 +231,8 @@ public:
         }
         cityMap = graph;
         ownsGraph = false;
+        pathCache.setRoadNetwork(graph);
+        alternatives.setRoadNetwork(graph);
     }
     
     // Get edge weight between two nodes
@@ -234,38 +268,23 @@ public:
         return totalDistance;
     }
     
-    // Get alternative route (second shortest) - simplified version
+    // Up to k loopless routes, shortest first (the first is the shortest
+    // path). Cached per (start, end) until a road changes.
+    vector<RankedRoute> getAlternativeRoutes(int startNode, int endNode, int k) {
+        if (!cityMap) return vector<RankedRoute>();
+        return alternatives.routes(startNode, endNode, k);
+    }
+    
+    // Second shortest loopless route, empty if there is none
     LinkedList<int> getAlternativeRoute(int startNode, int endNode) {
-        if (!cityMap) return LinkedList<int>();
+        LinkedList<int> alternativePath;
+        vector<RankedRoute> ranked = getAlternativeRoutes(startNode, endNode, 2);
+        if (ranked.size() < 2) return alternativePath;
         
-        // Get the shortest path
-        LinkedList<int> shortestPath = getShortestPath(startNode, endNode);
-        if (shortestPath.isEmpty() || shortestPath.getSize() < 2) {
-            return LinkedList<int>();
+        for (int node : ranked[1].nodes) {
+            alternativePath.insertAtEnd(node);
         }
-        
-        // Simple alternative: remove the first edge of shortest path and find new path
-        auto* head = shortestPath.getHead();
-        if (head && head->next) {
-            int firstNode = head->data;
-            int secondNode = head->next->data;
-            
-            // Temporarily remove this edge
-            int weight = cityMap->getEdgeWeight(firstNode, secondNode);
-            if (weight != -1) {
-                cityMap->removeEdge(firstNode, secondNode);
-                
-                // Find alternative path
-                LinkedList<int> alternativePath = getShortestPath(startNode, endNode);
-                
-                // Restore the edge
-                cityMap->addEdge(firstNode, secondNode, weight);
-                
-                return alternativePath;
-            }
-        }
-        
-        return LinkedList<int>();
+        return alternativePath;
     }
     
     // Print a path nicely
@@ -0,0 +1,256 @@
+#pragma once
+#ifndef SHORTEST_PATH_CACHE_H
+#define SHORTEST_PATH_CACHE_H
+
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <climits>
+#include <algorithm>
+#include "../dataStructures/Graph.h"
+#include "../dataStructures/IndexedPriorityQueue.h"
+#include "../dataStructures/WorkStealingPool.h"
+
+using namespace std;
+
+// Shortest-path trees from recently used sources, kept correct while roads
+// change instead of being thrown away.
+//
+// Call roadChanged() after every road is added, removed or re-weighted and
+// each cached tree is repaired in the style of Ramalingam and Reps:
+//   - a road that got shorter (or is new) can only improve nodes reachable
+//     through it, so a Dijkstra pass starts at its far end and stops
+//     where distances no longer improve;
+//   - a road that got longer (or closed) matters only if it is a tree
+//     edge; then just the subtree hanging below it is cut loose, each of
+//     its nodes is re-attached through its best neighbour outside the
+//     subtree, and a Dijkstra pass restricted to the subtree settles the
+//     rest.
+// Everything outside the affected region keeps its distance and parent.
+//
+// At most maxTrees sources are kept; the least recently used is dropped.
+class ShortestPathCache {
+public:
+    enum { UNREACHABLE = INT_MAX };
+
+private:
+    struct Tree {
+        vector<int> dist;
+        vector<int> parent;     // -1 for the source and unreachable nodes
+        list<int>::iterator recent;
+    };
+
+    const Graph* roads;
+    size_t maxTrees;
+    unordered_map<int, Tree> trees;
+    list<int> recentSources;    // most recently used first
+    long long repairedNodes;
+
+    static void buildTree(const Graph* roadGraph, int source, Tree& tree) {
+        int n = roadGraph ? roadGraph->getMaxNodes() : 0;
+        tree.dist.assign(n, UNREACHABLE);
+        tree.parent.assign(n, -1);
+        if (!roadGraph || !roadGraph->hasNode(source)) return;
+
+        IndexedPriorityQueue<int> frontier;
+        tree.dist[source] = 0;
+        frontier.enqueue(source, 0);
+        settle(roadGraph, tree, frontier, nullptr);
+    }
+
+    // Dijkstra from whatever is queued. With within set, only nodes marked
+    // there may be relaxed. Returns the number of nodes settled.
+    static int settle(const Graph* roadGraph, Tree& tree, IndexedPriorityQueue<int>& frontier,
+                      const vector<bool>* within) {
+        int settled = 0;
+        while (!frontier.isEmpty()) {
+            int d = frontier.peekPriority();
+            int u = frontier.dequeue();
+            if (d > tree.dist[u]) continue;
+            settled++;
+
+            roadGraph->forEachEdge(u, [&](int v, int weight) {
+                if (within && !(*within)[v]) return;
+                if (d + weight < tree.dist[v]) {
+                    tree.dist[v] = d + weight;
+                    tree.parent[v] = u;
+                    frontier.enqueue(v, tree.dist[v]);
+                }
+            });
+        }
+        return settled;
+    }
+
+    // from -> to became cheaper (weight is its new length)
+    int repairDecrease(Tree& tree, int from, int to, int weight) {
+        IndexedPriorityQueue<int> frontier;
+        int ends[2][2] = { { from, to }, { to, from } };
+        for (auto& end : ends) {
+            int a = end[0], b = end[1];
+            if (tree.dist[a] == UNREACHABLE) continue;
+            if (tree.dist[a] + weight < tree.dist[b]) {
+                tree.dist[b] = tree.dist[a] + weight;
+                tree.parent[b] = a;
+                frontier.enqueue(b, tree.dist[b]);
+            }
+        }
+        return settle(roads, tree, frontier, nullptr);
+    }
+
+    // from -> to became longer or was removed
+    int repairIncrease(Tree& tree, int from, int to) {
+        int child;
+        if (tree.parent[to] == from) child = to;
+        else if (tree.parent[from] == to) child = from;
+        else return 0;  // not on any shortest path from this source
+
+        // Subtree below the edge: nodes whose parent chain passes child
+        vector<bool> affected(tree.dist.size(), false);
+        vector<int> nodes(1, child);
+        affected[child] = true;
+        for (size_t i = 0; i < nodes.size(); i++) {
+            int u = nodes[i];
+            roads->forEachEdge(u, [&](int v, int) {
+                if (!affected[v] && tree.parent[v] == u) {
+                    affected[v] = true;
+                    nodes.push_back(v);
+                }
+            });
+        }
+        for (int u : nodes) {
+            tree.dist[u] = UNREACHABLE;
+            tree.parent[u] = -1;
+        }
+
+        // Re-attach each node through its best unaffected neighbour
+        IndexedPriorityQueue<int> frontier;
+        for (int u : nodes) {
+            roads->forEachEdge(u, [&](int v, int weight) {
+                if (affected[v] || tree.dist[v] == UNREACHABLE) return;
+                if (tree.dist[v] + weight < tree.dist[u]) {
+                    tree.dist[u] = tree.dist[v] + weight;
+                    tree.parent[u] = v;
+                }
+            });
+            if (tree.dist[u] != UNREACHABLE) frontier.enqueue(u, tree.dist[u]);
+        }
+        settle(roads, tree, frontier, &affected);
+        return nodes.size();
+    }
+
+    Tree& treeFor(int source) {
+        auto it = trees.find(source);
+        if (it != trees.end()) {
+            recentSources.splice(recentSources.begin(), recentSources, it->second.recent);
+            return it->second;
+        }
+
+        Tree tree;
+        buildTree(roads, source, tree);
+        return insertTree(source, tree);
+    }
+
+    Tree& insertTree(int source, Tree& built) {
+        while (maxTrees > 0 && trees.size() >= maxTrees) {
+            trees.erase(recentSources.back());
+            recentSources.pop_back();
+        }
+        recentSources.push_front(source);
+
+        Tree& tree = trees[source];
+        tree.dist.swap(built.dist);
+        tree.parent.swap(built.parent);
+        tree.recent = recentSources.begin();
+        return tree;
+    }
+
+    bool inRange(const Tree& tree, int node) const {
+        return node >= 0 && node < (int)tree.dist.size();
+    }
+
+public:
+    ShortestPathCache(const Graph* roadGraph = nullptr, size_t treeLimit = 256)
+        : roads(roadGraph), maxTrees(treeLimit), repairedNodes(0) {}
+
+    void setRoadNetwork(const Graph* roadGraph) {
+        roads = roadGraph;
+        clear();
+    }
+
+    void clear() {
+        trees.clear();
+        recentSources.clear();
+    }
+
+    int size() const { return trees.size(); }
+
+    // Nodes re-settled by repairs since construction
+    long long getRepairedNodes() const { return repairedNodes; }
+
+    bool hasTree(int source) const {
+        return trees.find(source) != trees.end();
+    }
+
+    // Builds trees for the sources not cached yet, spread over the pool
+    void prefetch(const vector<int>& sources, const WorkStealingPool* pool = nullptr) {
+        vector<int> missing;
+        for (int source : sources) {
+            if (!hasTree(source) && find(missing.begin(), missing.end(), source) == missing.end()) {
+                missing.push_back(source);
+            }
+        }
+        if (missing.empty()) return;
+
+        vector<Tree> built(missing.size());
+        const Graph* roadGraph = roads;
+        if (pool && missing.size() > 1) {
+            pool->parallelFor(missing.size(), [&](size_t i, int) {
+                buildTree(roadGraph, missing[i], built[i]);
+            });
+        } else {
+            for (size_t i = 0; i < missing.size(); i++) buildTree(roadGraph, missing[i], built[i]);
+        }
+        for (size_t i = 0; i < missing.size(); i++) insertTree(missing[i], built[i]);
+    }
+
+    int distance(int from, int to) {
+        if (from == to) return 0;
+        Tree& tree = treeFor(from);
+        return inRange(tree, to) ? tree.dist[to] : (int)UNREACHABLE;
+    }
+
+    // Nodes from -> to, empty if to can't be reached
+    vector<int> path(int from, int to) {
+        vector<int> nodes;
+        Tree& tree = treeFor(from);
+        if (!inRange(tree, to) || tree.dist[to] == UNREACHABLE) return nodes;
+
+        for (int node = to; node != -1; node = tree.parent[node]) {
+            nodes.push_back(node);
+        }
+        reverse(nodes.begin(), nodes.end());
+        return nodes;
+    }
+
+    // Call after the graph has changed. oldWeight is -1 for a new road,
+    // newWeight -1 for a removed one. Returns the nodes re-settled.
+    int roadChanged(int from, int to, int oldWeight, int newWeight) {
+        if (oldWeight == newWeight || !roads) return 0;
+
+        int touched = 0;
+        for (auto& entry : trees) {
+            Tree& tree = entry.second;
+            if (!inRange(tree, from) || !inRange(tree, to)) continue;
+
+            if (newWeight >= 0 && (oldWeight < 0 || newWeight < oldWeight)) {
+                touched += repairDecrease(tree, from, to, newWeight);
+            } else {
+                touched += repairIncrease(tree, from, to);
+            }
+        }
+        repairedNodes += touched;
+        return touched;
+    }
+};
+
+#endif // SHORTEST_PATH_CACHE_H
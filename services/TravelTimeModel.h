@@ -0,0 +1,301 @@
+#pragma once
+#ifndef TRAVEL_TIME_MODEL_H
+#define TRAVEL_TIME_MODEL_H
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <climits>
+#include <ctime>
+#include "../dataStructures/Graph.h"
+#include "../dataStructures/IndexedPriorityQueue.h"
+#include "../Logger.h"
+
+using namespace std;
+
+// How congested a class of roads is over the day: travel-time multipliers
+// at breakpoints (minute of day), linear in between and wrapping past
+// midnight. A factor of 1.8 means the road takes 1.8x its free-flow time.
+struct SpeedProfile {
+    string name;
+    vector<pair<int, double>> points;   // (minute of day, factor), sorted
+
+    SpeedProfile() {}
+    SpeedProfile(const string& n) : name(n) {}
+
+    void addPoint(int minute, double factor) {
+        points.push_back(make_pair(((minute % 1440) + 1440) % 1440, factor));
+        sort(points.begin(), points.end());
+    }
+
+    double factorAt(double minuteOfDay) const {
+        if (points.empty()) return 1.0;
+        if (points.size() == 1) return points[0].second;
+
+        double t = minuteOfDay - 1440.0 * (long long)(minuteOfDay / 1440.0);
+        if (t < 0) t += 1440.0;
+
+        // Neighbouring breakpoints, treating the day as a circle
+        pair<double, double> before(points.back().first - 1440.0, points.back().second);
+        pair<double, double> after(points.front().first + 1440.0, points.front().second);
+        for (const auto& point : points) {
+            if (point.first <= t) {
+                before = make_pair((double)point.first, point.second);
+            } else {
+                after = make_pair((double)point.first, point.second);
+                break;
+            }
+        }
+
+        if (after.first <= before.first) return before.second;
+        double share = (t - before.first) / (after.first - before.first);
+        return before.second + share * (after.second - before.second);
+    }
+};
+
+// Time-of-day travel times over the road graph.
+//
+// Each road may be tagged with a SpeedProfile; its travel time when
+// entered at time t is length / vehicle speed * factor(t), a piecewise-
+// linear function of t. Roads without a tag use the default profile, or
+// free flow if none is set. Times are in seconds from midnight of the
+// day the trip starts and may run past 86400.
+//
+// fastestPath() is Dijkstra over arrival times, which is exact as long as
+// no profile falls faster than time passes (leaving later never gets you
+// there earlier); real congestion curves are far from that. ETAs for a
+// route that was already planned go through travelAlongPath(), which
+// walks the path once instead of searching again.
+//
+// Profiles are loaded from a text file:
+//   # comment
+//   profile <name> <minute>:<factor> <minute>:<factor> ...
+//   road <from> <to> <profile>
+//   default <profile>
+class TravelTimeModel {
+private:
+    vector<SpeedProfile> profiles;
+    unordered_map<long long, int> roadProfile;  // road key -> index in profiles
+    int defaultProfile;                          // -1 = free flow
+    int (*speedTable)(const string&);            // vehicle -> meters per minute
+
+    static long long roadKey(int from, int to) {
+        if (from > to) swap(from, to);
+        return ((long long)from << 32) | (unsigned int)to;
+    }
+
+    int findProfile(const string& name) const {
+        for (size_t i = 0; i < profiles.size(); i++) {
+            if (profiles[i].name == name) return (int)i;
+        }
+        return -1;
+    }
+
+    double factorFor(int from, int to, int atSecond) const {
+        auto it = roadProfile.find(roadKey(from, to));
+        int index = (it != roadProfile.end()) ? it->second : defaultProfile;
+        if (index < 0) return 1.0;
+        return profiles[index].factorAt(atSecond / 60.0);
+    }
+
+public:
+    // How many of the riders nearest by road are compared on arrival time
+    // when choosing one for an order
+    enum { ETA_CANDIDATES = 5 };
+
+    explicit TravelTimeModel(int (*speeds)(const string&) = freeFlowSpeed)
+        : defaultProfile(-1), speedTable(speeds) {}
+
+    // Free-flow speed in meters per minute
+    static int freeFlowSpeed(const string& vehicleType) {
+        if (vehicleType == "motorcycle" || vehicleType == "motorbike") return 400;  // 24 km/h
+        if (vehicleType == "car") return 500;                                        // 30 km/h
+        if (vehicleType == "bike" || vehicleType == "bicycle") return 150;          // 9 km/h
+        if (vehicleType == "walking") return 80;                                     // 4.8 km/h
+        return 200;                                                                  // 12 km/h
+    }
+
+    // Speeds rider assignment has always timed deliveries with, in meters
+    // per minute
+    static int dispatchSpeed(const string& vehicleType) {
+        if (vehicleType == "bike") return 300;
+        if (vehicleType == "motorcycle") return 600;
+        if (vehicleType == "car") return 800;
+        return 400;
+    }
+
+    // The speed this model drives vehicleType at on a free road
+    int speedOf(const string& vehicleType) const { return speedTable(vehicleType); }
+
+    // Seconds since local midnight
+    static int currentSecondOfDay() {
+        time_t now = time(nullptr);
+        tm* local = localtime(&now);
+        if (!local) return 0;
+        return local->tm_hour * 3600 + local->tm_min * 60 + local->tm_sec;
+    }
+
+    void clear() {
+        profiles.clear();
+        roadProfile.clear();
+        defaultProfile = -1;
+    }
+
+    bool hasProfiles() const { return !profiles.empty(); }
+    int getProfileCount() const { return profiles.size(); }
+    int getTaggedRoadCount() const { return roadProfile.size(); }
+
+    // Adds a profile, replacing one with the same name
+    void addProfile(const SpeedProfile& profile) {
+        int existing = findProfile(profile.name);
+        if (existing >= 0) profiles[existing] = profile;
+        else profiles.push_back(profile);
+    }
+
+    bool setRoadProfile(int from, int to, const string& name) {
+        int index = findProfile(name);
+        if (index < 0) return false;
+        roadProfile[roadKey(from, to)] = index;
+        return true;
+    }
+
+    bool setDefaultProfile(const string& name) {
+        int index = findProfile(name);
+        if (index < 0) return false;
+        defaultProfile = index;
+        return true;
+    }
+
+    // Replaces the current profiles. Returns false if the file can't be
+    // opened; malformed lines are reported and skipped.
+    bool loadFromFile(const string& filename) {
+        ifstream file(filename);
+        if (!file.is_open()) return false;
+
+        clear();
+        string line;
+        int lineNumber = 0;
+        while (getline(file, line)) {
+            lineNumber++;
+            istringstream in(line);
+            string keyword;
+            if (!(in >> keyword) || keyword[0] == '#') continue;
+
+            bool ok = false;
+            if (keyword == "profile") {
+                SpeedProfile profile;
+                string point;
+                if (in >> profile.name) {
+                    ok = true;
+                    while (in >> point) {
+                        size_t colon = point.find(':');
+                        if (colon == string::npos) { ok = false; break; }
+                        try {
+                            profile.addPoint(stoi(point.substr(0, colon)), stod(point.substr(colon + 1)));
+                        } catch (...) {
+                            ok = false;
+                            break;
+                        }
+                    }
+                    if (ok) addProfile(profile);
+                }
+            } else if (keyword == "road") {
+                int from, to;
+                string name;
+                ok = (in >> from >> to >> name) && setRoadProfile(from, to, name);
+            } else if (keyword == "default") {
+                string name;
+                ok = (in >> name) && setDefaultProfile(name);
+            }
+
+            if (!ok) {
+                LOG_WARN("⚠ " << filename << ":" << lineNumber << ": ignored \"" << line << "\"");
+            }
+        }
+        return true;
+    }
+
+    // Seconds to drive a road of the given length entered at atSecond
+    int roadSeconds(int from, int to, int meters, int atSecond, int speed) const {
+        if (meters <= 0) return 0;
+        double freeFlow = meters * 60.0 / max(1, speed);
+        return max(1, (int)(freeFlow * factorFor(from, to, atSecond) + 0.5));
+    }
+
+    // Arrival time after driving an already computed path; -1 if a step
+    // of the path isn't a road
+    int travelAlongPath(const Graph& roads, const vector<int>& path,
+                        int departSecond, const string& vehicleType) const {
+        int speed = speedOf(vehicleType);
+        int at = departSecond;
+        for (size_t i = 0; i + 1 < path.size(); i++) {
+            int meters = roads.getEdgeWeight(path[i], path[i + 1]);
+            if (meters < 0) return -1;
+            at += roadSeconds(path[i], path[i + 1], meters, at, speed);
+        }
+        return at;
+    }
+
+    int travelAlongPath(const Graph& roads, const LinkedList<int>& path,
+                        int departSecond, const string& vehicleType) const {
+        vector<int> nodes;
+        auto* node = path.getHead();
+        while (node != nullptr) {
+            nodes.push_back(node->data);
+            node = node->next;
+        }
+        return travelAlongPath(roads, nodes, departSecond, vehicleType);
+    }
+
+    // Earliest-arrival path leaving start at departSecond. Empty if end
+    // can't be reached; arrivalSecond gets the arrival time otherwise.
+    vector<int> fastestPath(const Graph& roads, int start, int end, int departSecond,
+                            const string& vehicleType, int* arrivalSecond = nullptr) const {
+        vector<int> path;
+        if (!roads.hasNode(start) || !roads.hasNode(end)) return path;
+
+        int speed = speedOf(vehicleType);
+        unordered_map<int, int> arrival;
+        unordered_map<int, int> previous;
+        IndexedPriorityQueue<int> frontier;
+
+        arrival[start] = departSecond;
+        frontier.enqueue(start, departSecond);
+
+        bool reached = false;
+        while (!frontier.isEmpty()) {
+            int at = frontier.peekPriority();
+            int u = frontier.dequeue();
+            if (u == end) {
+                reached = true;
+                break;
+            }
+
+            roads.forEachEdge(u, [&](int v, int meters) {
+                int candidate = at + roadSeconds(u, v, meters, at, speed);
+                auto known = arrival.find(v);
+                if (known == arrival.end() || candidate < known->second) {
+                    arrival[v] = candidate;
+                    previous[v] = u;
+                    frontier.enqueue(v, candidate);
+                }
+            });
+        }
+        if (!reached) return path;
+
+        for (int node = end; node != start; node = previous[node]) {
+            path.push_back(node);
+        }
+        path.push_back(start);
+        reverse(path.begin(), path.end());
+
+        if (arrivalSecond) *arrivalSecond = arrival[end];
+        return path;
+    }
+};
+
+#endif // TRAVEL_TIME_MODEL_H
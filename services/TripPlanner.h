@@ -0,0 +1,183 @@
+#pragma once
+#ifndef TRIP_PLANNER_H
+#define TRIP_PLANNER_H
+
+#include <vector>
+#include <climits>
+#include "RouteOptimizer.h"
+
+using namespace std;
+
+// One order to fit into a trip: collect at pickupNode, deliver to dropoffNode
+struct TripJob {
+    int orderId;
+    int pickupNode;
+    int dropoffNode;
+
+    TripJob() : orderId(-1), pickupNode(-1), dropoffNode(-1) {}
+    TripJob(int id, int pickup, int dropoff)
+        : orderId(id), pickupNode(pickup), dropoffNode(dropoff) {}
+};
+
+struct TripStop {
+    int orderId;
+    int node;
+    bool pickup;        // false = drop-off
+
+    TripStop() : orderId(-1), node(-1), pickup(true) {}
+    TripStop(int id, int n, bool isPickup) : orderId(id), node(n), pickup(isPickup) {}
+};
+
+// Stops in visiting order; distance runs from the first stop to the last
+struct Trip {
+    vector<TripStop> stops;
+    vector<int> orderIds;
+    int distance;       // RouteOptimizer::UNREACHABLE if a leg has no route
+
+    Trip() : distance(0) {}
+};
+
+// Groups orders into multi-stop trips so one rider can carry several.
+//
+// Orders are placed one at a time with cheapest insertion: every
+// (pickup, drop-off) position pair in every open trip is tried and the
+// order joins the trip where it adds the least distance, provided that is
+// cheaper than a trip of its own and no order on the trip breaks a limit:
+//   - capacity: at most maxOrders orders per trip
+//   - detour: pickup-to-drop-off ride at most maxDetourPercent longer than
+//     the direct road distance
+//   - lateness: drop-off reached at most maxLateMinutes after it would have
+//     been had a rider driven that order alone from its restaurant
+// Distances come from the RouteOptimizer's cache, so a planning pass costs
+// one graph expansion per distinct stop at most.
+class TripPlanner {
+private:
+    RouteOptimizer* distances;
+    int maxOrders;
+    int maxDetourPercent;
+    int maxLateMinutes;
+    int metersPerMinute;
+
+    int leg(int from, int to) {
+        return distances ? distances->distance(from, to) : (int)RouteOptimizer::UNREACHABLE;
+    }
+
+    // Total length of the stop sequence, or UNREACHABLE if any limit fails
+    int evaluate(const vector<TripStop>& stops) {
+        vector<int> reachedAt(stops.size(), 0);
+        long long travelled = 0;
+        for (size_t i = 1; i < stops.size(); i++) {
+            int d = leg(stops[i - 1].node, stops[i].node);
+            if (d >= RouteOptimizer::UNREACHABLE) return RouteOptimizer::UNREACHABLE;
+            travelled += d;
+            if (travelled >= RouteOptimizer::UNREACHABLE) return RouteOptimizer::UNREACHABLE;
+            reachedAt[i] = (int)travelled;
+        }
+
+        long long allowedLate = (long long)maxLateMinutes * metersPerMinute;
+        for (size_t i = 0; i < stops.size(); i++) {
+            if (!stops[i].pickup) continue;
+            for (size_t j = i + 1; j < stops.size(); j++) {
+                if (stops[j].orderId != stops[i].orderId) continue;
+
+                long long direct = leg(stops[i].node, stops[j].node);
+                long long ride = reachedAt[j] - reachedAt[i];
+                if (ride * 100 > direct * (100 + maxDetourPercent)) {
+                    return RouteOptimizer::UNREACHABLE;
+                }
+                if (reachedAt[j] - direct > allowedLate) {
+                    return RouteOptimizer::UNREACHABLE;
+                }
+                break;
+            }
+        }
+        return (int)travelled;
+    }
+
+public:
+    TripPlanner(RouteOptimizer* distanceCache = nullptr, int ordersPerTrip = 3,
+                int detourPercent = 50, int lateMinutes = 10, int speedMetersPerMinute = 250)
+        : distances(distanceCache), maxOrders(ordersPerTrip),
+          maxDetourPercent(detourPercent), maxLateMinutes(lateMinutes),
+          metersPerMinute(speedMetersPerMinute) {}
+
+    void setDistanceCache(RouteOptimizer* distanceCache) { distances = distanceCache; }
+
+    void setLimits(int ordersPerTrip, int detourPercent, int lateMinutes) {
+        maxOrders = ordersPerTrip;
+        maxDetourPercent = detourPercent;
+        maxLateMinutes = lateMinutes;
+    }
+
+    int getMaxOrders() const { return maxOrders; }
+
+    // Trips in the order they were opened; jobs are placed in input order,
+    // so pass the oldest orders first. Jobs whose stops aren't connected by
+    // road always get a trip of their own.
+    vector<Trip> plan(const vector<TripJob>& jobs) {
+        vector<Trip> trips;
+
+        for (const auto& job : jobs) {
+            TripStop pickup(job.orderId, job.pickupNode, true);
+            TripStop dropoff(job.orderId, job.dropoffNode, false);
+            int direct = leg(job.pickupNode, job.dropoffNode);
+
+            int bestTrip = -1;
+            int bestAdded = INT_MAX;
+            int bestDistance = 0;
+            vector<TripStop> bestStops;
+
+            if (direct < RouteOptimizer::UNREACHABLE) {
+                for (size_t t = 0; t < trips.size(); t++) {
+                    Trip& trip = trips[t];
+                    if ((int)trip.orderIds.size() >= maxOrders) continue;
+                    if (trip.distance >= RouteOptimizer::UNREACHABLE) continue;
+
+                    size_t n = trip.stops.size();
+                    for (size_t i = 0; i <= n; i++) {
+                        for (size_t j = i; j <= n; j++) {
+                            vector<TripStop> candidate;
+                            candidate.reserve(n + 2);
+                            candidate.insert(candidate.end(), trip.stops.begin(), trip.stops.begin() + i);
+                            candidate.push_back(pickup);
+                            candidate.insert(candidate.end(), trip.stops.begin() + i, trip.stops.begin() + j);
+                            candidate.push_back(dropoff);
+                            candidate.insert(candidate.end(), trip.stops.begin() + j, trip.stops.end());
+
+                            int total = evaluate(candidate);
+                            if (total >= RouteOptimizer::UNREACHABLE) continue;
+
+                            int added = total - trip.distance;
+                            if (added < bestAdded) {
+                                bestAdded = added;
+                                bestTrip = (int)t;
+                                bestDistance = total;
+                                bestStops.swap(candidate);
+                            }
+                        }
+                    }
+                }
+            }
+
+            // Joining a trip has to beat sending another rider
+            if (bestTrip >= 0 && bestAdded < direct) {
+                Trip& trip = trips[bestTrip];
+                trip.stops.swap(bestStops);
+                trip.orderIds.push_back(job.orderId);
+                trip.distance = bestDistance;
+                continue;
+            }
+
+            Trip solo;
+            solo.stops.push_back(pickup);
+            solo.stops.push_back(dropoff);
+            solo.orderIds.push_back(job.orderId);
+            solo.distance = direct;
+            trips.push_back(solo);
+        }
+
+        return trips;
+    }
+};
+
+#endif // TRIP_PLANNER_H
@@ -8,6 +8,7 @@
 #include <vector>
 #include "../models/User.h"
 #include "../dataStructures/BTree.h"
+#include "../Logger.h"
 
 using namespace std;
 
@@ -27,11 +28,11 @@ public:
     // Load users from BTree to UserManager cache
     void loadUsersFromPersistentStorage() {
         if (!persistentUsers || persistentUsers->isEmpty()) {
-            cout << "No users in persistent storage.\n";
+            LOG_INFO("No users in persistent storage.");
             return;
         }
         
-        cout << "Loading users from persistent storage...\n";
+        LOG_INFO("Loading users from persistent storage...");
         
         // Get all users from BTree
         vector<UserData> allUsers = persistentUsers->getAllKeys();
@@ -48,7 +49,7 @@ public:
             );
         }
         
-        cout << "Loaded " << allUsers.size() << " users from persistent storage.\n";
+        LOG_INFO("Loaded " << allUsers.size() << " users from persistent storage.");
     }
 
     // Register a new user with full details
@@ -58,13 +59,13 @@ public:
         
         // Check if user already exists in cache
         if (userManager.userExists(id)) {
-            cout << "User with ID " << id << " already exists in cache.\n";
+            LOG_WARN("User with ID " << id << " already exists in cache.");
             return false;
         }
         
         // Check if email already exists
         if (userManager.emailExists(email)) {
-            cout << "Email " << email << " already registered.\n";
+            LOG_WARN("Email " << email << " already registered.");
             return false;
         }
         
@@ -83,16 +84,16 @@ public:
             searchUser.id = id;
             auto result = persistentUsers->search(searchUser);
             if (result.first) {
-                cout << "User already exists in persistent storage.\n";
+                LOG_DEBUG("User already exists in persistent storage.");
                 return false;
             }
             
             // Add to persistent storage
             try {
                 persistentUsers->insert(user);
-                cout << "User added to persistent storage.\n";
+                LOG_DEBUG("User added to persistent storage.");
             } catch (const exception& e) {
-                cout << "Failed to add user to persistent storage: " << e.what() << "\n";
+                LOG_ERROR("Failed to add user to persistent storage: " << e.what());
                 return false;
             }
         }
@@ -101,7 +102,7 @@ public:
         bool cacheSuccess = userManager.registerUser(id, name, email, phone, password, role, address);
         
         if (cacheSuccess) {
-            cout << "User registered successfully. ID: " << id << "\n";
+            LOG_INFO("User registered successfully. ID: " << id);
             return true;
         }
         
@@ -121,7 +122,7 @@ public:
         bool cacheRemoved = userManager.removeUser(id);
         
         if (!cacheRemoved) {
-            cout << "User not found in cache.\n";
+            LOG_WARN("User not found in cache.");
             return false;
         }
         
@@ -131,9 +132,9 @@ public:
             dummyUser.id = id;
             try {
                 persistentUsers->remove(dummyUser);
-                cout << "User removed from persistent storage.\n";
+                LOG_DEBUG("User removed from persistent storage.");
             } catch (const exception& e) {
-                cout << "User not found in persistent storage (but removed from cache): " << e.what() << "\n";
+                LOG_WARN("User not found in persistent storage (but removed from cache): " << e.what());
             }
         }
         
@@ -190,7 +191,7 @@ public:
         // Get current user data
         UserData* currentUser = getUser(id);
         if (!currentUser) {
-            cout << "User not found.\n";
+            LOG_WARN("User not found.");
             return false;
         }
         
@@ -207,7 +208,7 @@ public:
             // Check if new email is already in use by another user
             UserData* existing = getUserByEmail(string(updates.email));
             if (existing && existing->id != id) {
-                cout << "Email already in use by another user.\n";
+                LOG_WARN("Email already in use by another user.");
                 return false;
             }
             strncpy(updatedUser.email, updates.email, sizeof(updatedUser.email) - 1);
@@ -252,7 +253,7 @@ public:
         );
         
         if (!cacheSuccess) {
-            cout << "Failed to update user in cache.\n";
+            LOG_ERROR("Failed to update user in cache.");
             // Restore old user
             userManager.registerUser(
                 currentUser->id,
@@ -276,9 +277,9 @@ public:
                 
                 // Add updated entry
                 persistentUsers->insert(updatedUser);
-                cout << "User updated in persistent storage.\n";
+                LOG_DEBUG("User updated in persistent storage.");
             } catch (const exception& e) {
-                cout << "Failed to update user in persistent storage: " << e.what() << "\n";
+                LOG_ERROR("Failed to update user in persistent storage: " << e.what());
                 return false;
             }
         }
@@ -393,7 +394,7 @@ public:
 
     // Sync cache with persistent storage
     void syncWithPersistentStorage() {
-        cout << "Syncing cache with persistent storage...\n";
+        LOG_INFO("Syncing cache with persistent storage...");
         
         // Clear cache
         userManager.clearAllUsers();
@@ -401,7 +402,7 @@ public:
         // Reload from persistent storage
         loadUsersFromPersistentStorage();
         
-        cout << "Sync completed.\n";
+        LOG_INFO("Sync completed.");
     }
 
     // Export users to file
@@ -426,7 +427,7 @@ public:
             persistentUsers->clear();
         }
         
-        cout << "All users cleared.\n";
+        LOG_INFO("All users cleared.");
     }
 
     // Get the UserManager (for direct access if needed)
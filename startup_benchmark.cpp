@@ -0,0 +1,265 @@
+// startup_benchmark.cpp - Times loading the server's data files, one after another vs in parallel
+//
+// Writes a synthetic database (1M orders by default) into a scratch
+// directory, then loads it the way QuickBiteServer::loadSystemData does:
+// every file read on its own thread through a StartupPipeline, with users
+// registered, the restaurant index built and menus linked as soon as
+// their inputs are ready. The same steps are also run one after another
+// on a single thread, and the best of --runs for each is reported.
+//
+// The files are written just before the runs, so both modes usually read
+// them from the page cache; pass --cold to drop the cache between runs
+// (Linux, needs root).
+//
+// Usage:
+//   startup_benchmark [--orders 1000000] [--users 100000] [--riders 5000]
+//                     [--restaurants 2000] [--menu-items 40000]
+//                     [--runs 3] [--dir startup_bench_data] [--keep] [--cold]
+#include "Database.h"
+#include "models/User.h"
+#include "services/RestaurantDirectory.h"
+#include "services/MenuGroups.h"
+#include "storage/StartupPipeline.h"
+#include "dataStructures/WorkStealingPool.h"
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+
+#ifdef _WIN32
+    #include <direct.h>
+    #define makeDirectory(path) _mkdir(path)
+    #define changeDirectory(path) _chdir(path)
+#else
+    #include <sys/stat.h>
+    #include <unistd.h>
+    #define makeDirectory(path) mkdir(path, 0755)
+    #define changeDirectory(path) chdir(path)
+#endif
+
+using namespace std;
+
+struct BenchConfig {
+    size_t orders;
+    size_t users;
+    size_t riders;
+    size_t restaurants;
+    size_t menuItems;
+    int runs;
+    string dir;
+    bool keep;
+    bool cold;
+
+    BenchConfig() : orders(1000000), users(100000), riders(5000), restaurants(2000),
+                    menuItems(40000), runs(3), dir("startup_bench_data"), keep(false), cold(false) {}
+};
+
+// What one load produced, to check both modes built the same state
+struct LoadResult {
+    double millis;
+    double workMillis;
+    size_t users;
+    size_t restaurants;
+    size_t linkedItems;
+    size_t orders;
+    size_t riders;
+};
+
+void generateData(Database& db, const BenchConfig& config) {
+    vector<UserData> users;
+    users.reserve(config.users + config.riders);
+    for (size_t i = 0; i < config.users; i++) {
+        int id = (int)i + 1;
+        users.push_back(UserData(id, "Customer " + to_string(id), "customer" + to_string(id) + "@example.com",
+                                 "0300-" + to_string(1000000 + id), "customer", "Street " + to_string(id % 500),
+                                 "password" + to_string(id)));
+    }
+
+    vector<Rider> riders;
+    riders.reserve(config.riders);
+    for (size_t i = 0; i < config.riders; i++) {
+        int id = (int)(config.users + i) + 1;
+        users.push_back(UserData(id, "Rider " + to_string(id), "rider" + to_string(id) + "@example.com",
+                                 "0311-" + to_string(1000000 + id), "rider", "Depot", "rider" + to_string(id)));
+        riders.push_back(Rider(id, "Rider " + to_string(id), "rider" + to_string(id) + "@example.com",
+                               "rider" + to_string(id), "Active"));
+    }
+
+    vector<Restaurant> restaurants;
+    restaurants.reserve(config.restaurants);
+    for (size_t i = 0; i < config.restaurants; i++) {
+        int id = (int)i + 1;
+        restaurants.push_back(Restaurant(id, "Restaurant " + to_string(id), "Block " + to_string(id % 40),
+                                         "042-" + to_string(3000000 + id), i % 2 ? "Desi" : "Fast Food",
+                                         (int)(i % 9) + 1, 4.0 + (i % 10) / 10.0, 20 + (int)(i % 30)));
+    }
+
+    vector<MenuItem> items;
+    items.reserve(config.menuItems);
+    for (size_t i = 0; i < config.menuItems; i++) {
+        int id = (int)i + 1000;
+        int restaurantId = config.restaurants ? (int)(i % config.restaurants) + 1 : 0;
+        items.push_back(MenuItem(id, "Dish " + to_string(id), "Synthetic menu item",
+                                 200.0 + (i % 700), 50, "Main", restaurantId));
+    }
+
+    vector<Order> orders;
+    orders.reserve(config.orders);
+    for (size_t i = 0; i < config.orders; i++) {
+        int restaurantId = config.restaurants ? (int)(i % config.restaurants) + 1 : 0;
+        Order order((int)i + 1000, (int)(i % (config.users ? config.users : 1)) + 1, restaurantId,
+                    "House " + to_string(i % 1000), -1, (int)(i % 9) + 1);
+        order.items[0] = Order::OrderItem(restaurantId, 1000 + (int)(i % (config.menuItems ? config.menuItems : 1)),
+                                          "Dish", 1 + (int)(i % 3), 450.0);
+        order.itemCount = 1;
+        order.totalAmount = 450.0 * order.items[0].quantity;
+        orders.push_back(order);
+    }
+
+    db.saveAllUsers(users);
+    db.saveAllRiders(riders);
+    db.saveAllRestaurants(restaurants);
+    db.saveAllMenuItems(items);
+    db.saveAllOrders(orders);
+}
+
+// The steps of QuickBiteServer::loadDataFiles, against local state
+LoadResult loadOnce(Database& db, bool parallel) {
+    vector<UserData> users;
+    vector<Restaurant> restaurants;
+    vector<MenuItem> menuItems;
+    vector<Order> orders;
+    vector<Rider> riders;
+    UserManager userManager;
+    RestaurantDirectory index;
+    HashTable<Rider> riderTable(10);
+    size_t registered = 0;
+    size_t linked = 0;
+
+    StartupPipeline pipeline(parallel);
+    int readUsers = pipeline.add("users.dat", [&] { users = db.loadAllUsers(); });
+    int readRestaurants = pipeline.add("restaurants.dat", [&] { restaurants = db.loadAllRestaurants(); });
+    int readMenus = pipeline.add("menu_items.dat", [&] { menuItems = db.loadAllMenuItems(); });
+    pipeline.add("orders.dat", [&] { orders = db.loadAllOrders(); });
+    int readRiders = pipeline.add("riders.dat", [&] { riders = db.loadAllRiders(); });
+
+    pipeline.add("register users", [&] { registered = userManager.loadUsers(users); }, {readUsers});
+    int indexRestaurants = pipeline.add("restaurant index", [&] { index.rebuild(restaurants); }, {readRestaurants});
+    pipeline.add("link menu items", [&] {
+        MenuGroups menuGroups;
+        menuGroups.build(menuItems, index);
+        linked = menuGroups.attachTo(restaurants);
+    }, {indexRestaurants, readMenus});
+    pipeline.add("rider table", [&] {
+        riderTable.reserve((int)riders.size());
+        for (const auto& rider : riders) riderTable.insertItem(rider.getId(), rider);
+    }, {readRiders});
+
+    pipeline.run();
+
+    LoadResult result;
+    result.millis = pipeline.getWallMillis();
+    result.workMillis = pipeline.getSerialMillis();
+    result.users = registered;
+    result.restaurants = restaurants.size();
+    result.linkedItems = linked;
+    result.orders = orders.size();
+    result.riders = riders.size();
+    return result;
+}
+
+void dropPageCache() {
+#ifndef _WIN32
+    sync();
+    FILE* control = fopen("/proc/sys/vm/drop_caches", "w");
+    if (!control) {
+        cerr << "⚠ Can't drop the page cache (needs root); timing warm reads\n";
+        return;
+    }
+    fputs("3", control);
+    fclose(control);
+#endif
+}
+
+void printUsage() {
+    cout << "Usage: startup_benchmark [--orders N] [--users N] [--riders N] [--restaurants N]\n"
+         << "                         [--menu-items N] [--runs N] [--dir PATH] [--keep] [--cold]\n";
+}
+
+int main(int argc, char* argv[]) {
+    BenchConfig config;
+
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (arg == "--keep") config.keep = true;
+        else if (arg == "--cold") config.cold = true;
+        else if (arg == "--help") { printUsage(); return 0; }
+        else if (!hasValue) { printUsage(); return 1; }
+        else if (arg == "--orders") config.orders = stoul(argv[++i]);
+        else if (arg == "--users") config.users = stoul(argv[++i]);
+        else if (arg == "--riders") config.riders = stoul(argv[++i]);
+        else if (arg == "--restaurants") config.restaurants = stoul(argv[++i]);
+        else if (arg == "--menu-items") config.menuItems = stoul(argv[++i]);
+        else if (arg == "--runs") config.runs = max(1, stoi(argv[++i]));
+        else if (arg == "--dir") config.dir = argv[++i];
+        else {
+            printUsage();
+            return 1;
+        }
+    }
+
+    makeDirectory(config.dir.c_str());
+    if (changeDirectory(config.dir.c_str()) != 0) {
+        cerr << "✗ Can't use directory " << config.dir << "\n";
+        return 1;
+    }
+
+    Database db;
+    cout << "Writing " << config.orders << " orders, " << config.users << " users, "
+         << config.riders << " riders, " << config.restaurants << " restaurants, "
+         << config.menuItems << " menu items to " << config.dir << "...\n";
+    generateData(db, config);
+
+    LoadResult best[2];
+    for (int mode = 0; mode < 2; mode++) {
+        for (int run = 0; run < config.runs; run++) {
+            if (config.cold) dropPageCache();
+            LoadResult result = loadOnce(db, mode == 1);
+            if (run == 0 || result.millis < best[mode].millis) best[mode] = result;
+        }
+    }
+    Logger::instance().flush();
+
+    const char* names[2] = { "one after another", "parallel pipeline" };
+    cout << fixed << setprecision(1);
+    for (int mode = 0; mode < 2; mode++) {
+        cout << setw(18) << names[mode] << ": " << setw(8) << best[mode].millis << " ms"
+             << "  (" << best[mode].orders << " orders, " << best[mode].users << " users, "
+             << best[mode].restaurants << " restaurants, " << best[mode].linkedItems
+             << " menu items linked, " << best[mode].riders << " riders)\n";
+    }
+    cout << "Speedup: " << setprecision(2) << best[0].millis / best[1].millis << "x on "
+         << WorkStealingPool().getWorkerCount() << " cores\n";
+
+    bool same = best[0].orders == best[1].orders && best[0].users == best[1].users &&
+                best[0].restaurants == best[1].restaurants && best[0].linkedItems == best[1].linkedItems &&
+                best[0].riders == best[1].riders;
+    if (!same) cout << "✗ The two modes loaded different data\n";
+
+    if (!config.keep) {
+        const char* files[] = { "users.dat", "riders.dat", "restaurants.dat", "menu_items.dat", "orders.dat" };
+        for (const char* file : files) remove(file);
+        if (changeDirectory("..") == 0) {
+#ifdef _WIN32
+            _rmdir(config.dir.c_str());
+#else
+            rmdir(config.dir.c_str());
+#endif
+        }
+    }
+    return same ? 0 : 1;
+}
@@ -0,0 +1,198 @@
+#pragma once
+#ifndef ATOMIC_FILE_WRITER_H
+#define ATOMIC_FILE_WRITER_H
+
+#include <string>
+#include <vector>
+#include <cstring>
+#include <cstdint>
+#include <cstdio>
+
+#ifdef _WIN32
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <sys/uio.h>
+    #include <cerrno>
+#endif
+
+using namespace std;
+
+// A whole file's contents, encoded in memory so they reach the disk in a
+// single write instead of one call per field or record
+class BulkBuffer {
+private:
+    vector<char> bytes;
+
+public:
+    void reserve(size_t size) { bytes.reserve(size); }
+    void clear() { bytes.clear(); }
+
+    const char* data() const { return bytes.empty() ? nullptr : &bytes[0]; }
+    size_t size() const { return bytes.size(); }
+
+    void append(const void* data, size_t size) {
+        if (size == 0) return;
+        size_t at = bytes.size();
+        bytes.resize(at + size);
+        memcpy(&bytes[at], data, size);
+    }
+
+    template<typename T>
+    void appendValue(const T& value) { append(&value, sizeof(T)); }
+
+    // uint32 length, then the characters without a terminator
+    void appendString(const string& text) {
+        uint32_t length = static_cast<uint32_t>(text.length());
+        appendValue(length);
+        append(text.data(), length);
+    }
+};
+
+// A piece of a file being written, pointing at memory owned elsewhere
+struct FileSegment {
+    const char* data;
+    size_t size;
+
+    FileSegment(const void* d, size_t n) : data(static_cast<const char*>(d)), size(n) {}
+};
+
+// Replaces a file all at once: the contents go to <path>.tmp, are synced
+// to disk, and the temp file is renamed over path. Readers (and a crash
+// at any point) see either the old file or the complete new one, never a
+// truncated mix.
+class AtomicFileWriter {
+private:
+#ifndef _WIN32
+    // Gathers the segments with writev, a batch at a time, picking up
+    // after short writes
+    static bool writeFully(int fd, const vector<FileSegment>& segments) {
+        const size_t BATCH = 512;
+        vector<struct iovec> pending;
+        pending.reserve(BATCH);
+
+        size_t next = 0;
+        while (next < segments.size() || !pending.empty()) {
+            while (next < segments.size() && pending.size() < BATCH) {
+                if (segments[next].size > 0) {
+                    struct iovec piece;
+                    piece.iov_base = const_cast<char*>(segments[next].data);
+                    piece.iov_len = segments[next].size;
+                    pending.push_back(piece);
+                }
+                next++;
+            }
+            if (pending.empty()) break;
+
+            ssize_t written = ::writev(fd, &pending[0], (int)pending.size());
+            if (written < 0) {
+                if (errno == EINTR) continue;
+                return false;
+            }
+
+            size_t done = 0;
+            while (done < pending.size() && (size_t)written >= pending[done].iov_len) {
+                written -= pending[done].iov_len;
+                done++;
+            }
+            if (done < pending.size()) {
+                pending[done].iov_base = static_cast<char*>(pending[done].iov_base) + written;
+                pending[done].iov_len -= written;
+            }
+            pending.erase(pending.begin(), pending.begin() + done);
+        }
+        return true;
+    }
+
+    // Makes the rename itself durable
+    static void syncDirectoryOf(const string& path) {
+        size_t slash = path.find_last_of('/');
+        string directory = (slash == string::npos) ? "." : (slash == 0 ? "/" : path.substr(0, slash));
+        int fd = ::open(directory.c_str(), O_RDONLY);
+        if (fd < 0) return;
+        ::fsync(fd);
+        ::close(fd);
+    }
+#endif
+
+public:
+    // The first half of write(): the contents go to temp and are synced,
+    // but nothing is put in place. Removes temp if it can't be written.
+    static bool stage(const string& temp, const vector<FileSegment>& segments) {
+#ifdef _WIN32
+        HANDLE file = CreateFileA(temp.c_str(), GENERIC_WRITE, 0, NULL, CREATE_ALWAYS,
+                                  FILE_ATTRIBUTE_NORMAL, NULL);
+        if (file == INVALID_HANDLE_VALUE) return false;
+
+        bool ok = true;
+        for (size_t i = 0; ok && i < segments.size(); i++) {
+            const char* data = segments[i].data;
+            size_t size = segments[i].size;
+            while (ok && size > 0) {
+                DWORD chunk = size > (1u << 30) ? (1u << 30) : (DWORD)size;
+                DWORD written = 0;
+                ok = WriteFile(file, data, chunk, &written, NULL) && written > 0;
+                data += written;
+                size -= written;
+            }
+        }
+        ok = ok && FlushFileBuffers(file);
+        CloseHandle(file);
+
+        if (!ok) DeleteFileA(temp.c_str());
+        return ok;
+#else
+        int fd = ::open(temp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) return false;
+
+        bool ok = writeFully(fd, segments) && ::fsync(fd) == 0;
+        ok = (::close(fd) == 0) && ok;
+
+        if (!ok) ::unlink(temp.c_str());
+        return ok;
+#endif
+    }
+
+    // The second half: renames a staged temp over path. temp is removed
+    // if that fails.
+    static bool publish(const string& temp, const string& path) {
+#ifdef _WIN32
+        if (!MoveFileExA(temp.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH)) {
+            DeleteFileA(temp.c_str());
+            return false;
+        }
+#else
+        if (::rename(temp.c_str(), path.c_str()) != 0) {
+            ::unlink(temp.c_str());
+            return false;
+        }
+        syncDirectoryOf(path);
+#endif
+        return true;
+    }
+
+    // Drops a staged temp that won't be published
+    static void discard(const string& temp) {
+#ifdef _WIN32
+        DeleteFileA(temp.c_str());
+#else
+        ::unlink(temp.c_str());
+#endif
+    }
+
+    static bool write(const string& path, const vector<FileSegment>& segments) {
+        string temp = path + ".tmp";
+        return stage(temp, segments) && publish(temp, path);
+    }
+
+    static bool write(const string& path, const char* data, size_t size) {
+        return write(path, vector<FileSegment>(1, FileSegment(data, size)));
+    }
+
+    static bool write(const string& path, const BulkBuffer& buffer) {
+        return write(path, buffer.data(), buffer.size());
+    }
+};
+
+#endif // ATOMIC_FILE_WRITER_H
@@ -0,0 +1,392 @@
+#pragma once
+#ifndef CATALOG_SNAPSHOT_H
+#define CATALOG_SNAPSHOT_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <algorithm>
+#include <cstring>
+#include <cstddef>
+#include <cstdint>
+#include "AtomicFileWriter.h"
+#include "Crc32c.h"
+#include "MappedFile.h"
+#include "../models/Restaurant.h"
+#include "../models/MenuItem.h"
+
+#ifdef _WIN32
+    #include <windows.h>
+#else
+    #include <sys/stat.h>
+#endif
+
+using namespace std;
+
+// Restaurants and menus as one read-only file, laid out to be used in
+// place: fixed-size records, offset tables and a string pool.
+//
+//   header | restaurants | id index | menu items | strings
+//
+// Restaurants keep the order they were built from. Each one names the
+// contiguous run of menu items that belongs to it, and the id index
+// (sorted by id) finds a restaurant by binary search. Strings are
+// interned, so a cuisine or category shared by many records is stored
+// once; a string reference is its offset in the pool, which holds a
+// uint32 length, the characters and a terminating NUL.
+//
+// Opening a snapshot maps the file and checks its checksums; nothing is
+// decoded or copied, and every process that opens the same file shares
+// its pages through the page cache. Each version is built into a file of
+// its own rather than over the one before, so a mapped snapshot's file is
+// never replaced under it and readers holding it are unaffected.
+struct CatalogSnapshotHeader {
+    char magic[4];              // "QBCS"
+    uint16_t version;
+    uint16_t headerSize;
+    uint64_t generation;        // counts up with every rebuild
+    uint64_t sourceStamp;       // stampOf() the files it was built from
+    uint32_t restaurantCount;
+    uint32_t itemCount;
+    uint32_t restaurantsOffset;
+    uint32_t idIndexOffset;
+    uint32_t itemsOffset;
+    uint32_t stringsOffset;
+    uint32_t fileSize;
+    uint32_t bodyCrc;           // CRC32C of everything after the header
+    uint32_t reserved;
+    uint32_t headerCrc;         // CRC32C of the header up to here
+};
+
+struct CatalogRestaurant {
+    int32_t id;
+    int32_t locationNode;
+    double rating;
+    int32_t deliveryTime;
+    uint32_t name;              // string references
+    uint32_t cuisine;
+    uint32_t address;
+    uint32_t phone;
+    uint32_t firstItem;         // menu run [firstItem, firstItem + itemCount)
+    uint32_t itemCount;
+    uint32_t reserved;
+};
+
+struct CatalogMenuItem {
+    int32_t id;
+    int32_t restaurantId;
+    double price;
+    int32_t stock;
+    uint32_t name;              // string references
+    uint32_t description;
+    uint32_t category;
+};
+
+struct CatalogIdEntry {
+    int32_t id;
+    uint32_t slot;
+};
+
+class CatalogSnapshot {
+public:
+    enum { VERSION = 1 };
+
+private:
+    MappedFile file;
+    const char* base;
+    size_t size;
+    const CatalogSnapshotHeader* header;
+    const CatalogRestaurant* restaurantTable;
+    const CatalogIdEntry* idIndex;
+    const CatalogMenuItem* itemTable;
+    const char* strings;
+    uint32_t stringBytes;
+
+    CatalogSnapshot() : base(nullptr), size(0), header(nullptr), restaurantTable(nullptr), idIndex(nullptr),
+                        itemTable(nullptr), strings(nullptr), stringBytes(0) {}
+
+    CatalogSnapshot(const CatalogSnapshot&);
+    CatalogSnapshot& operator=(const CatalogSnapshot&);
+
+    static const char* magic() { return "QBCS"; }
+
+    static uint32_t headerCrc(const CatalogSnapshotHeader& h) {
+        return Crc32c::compute(&h, offsetof(CatalogSnapshotHeader, headerCrc));
+    }
+
+    // Writes strings into the pool once each
+    class StringPool {
+    private:
+        BulkBuffer bytes;
+        unordered_map<string, uint32_t> offsets;
+
+    public:
+        uint32_t intern(const string& text) {
+            auto it = offsets.find(text);
+            if (it != offsets.end()) return it->second;
+
+            uint32_t offset = (uint32_t)bytes.size();
+            bytes.appendString(text);
+            char terminator[4] = { 0, 0, 0, 0 };
+            // NUL, then padding so the next length is 4-byte aligned
+            bytes.append(terminator, 4 - (text.size() % 4));
+            offsets[text] = offset;
+            return offset;
+        }
+
+        const BulkBuffer& data() const { return bytes; }
+    };
+
+    bool map(const string& path, string& error) {
+        if (!file.open(path, error)) return false;
+        if (file.size() == 0) {
+            error = "empty file";
+            return false;
+        }
+        base = file.data();
+        size = file.size();
+        return true;
+    }
+
+    bool validate(string& error) {
+        if (size < sizeof(CatalogSnapshotHeader) || memcmp(base, magic(), 4) != 0) {
+            error = "not a catalog snapshot";
+            return false;
+        }
+        header = reinterpret_cast<const CatalogSnapshotHeader*>(base);
+        if (header->headerCrc != headerCrc(*header)) {
+            error = "header checksum mismatch";
+            return false;
+        }
+        if (header->version != VERSION || header->headerSize != sizeof(CatalogSnapshotHeader)) {
+            error = "unsupported version " + to_string(header->version);
+            return false;
+        }
+        if (header->fileSize != size) {
+            error = "file is " + to_string(size) + " bytes, header says " + to_string(header->fileSize);
+            return false;
+        }
+
+        uint64_t restaurantsEnd = header->restaurantsOffset + (uint64_t)header->restaurantCount * sizeof(CatalogRestaurant);
+        uint64_t indexEnd = header->idIndexOffset + (uint64_t)header->restaurantCount * sizeof(CatalogIdEntry);
+        uint64_t itemsEnd = header->itemsOffset + (uint64_t)header->itemCount * sizeof(CatalogMenuItem);
+        if (header->restaurantsOffset != sizeof(CatalogSnapshotHeader) || restaurantsEnd != header->idIndexOffset ||
+            indexEnd != header->itemsOffset || itemsEnd != header->stringsOffset || header->stringsOffset > size) {
+            error = "inconsistent section offsets";
+            return false;
+        }
+        if (header->bodyCrc != Crc32c::compute(base + header->headerSize, size - header->headerSize)) {
+            error = "checksum mismatch";
+            return false;
+        }
+
+        restaurantTable = reinterpret_cast<const CatalogRestaurant*>(base + header->restaurantsOffset);
+        idIndex = reinterpret_cast<const CatalogIdEntry*>(base + header->idIndexOffset);
+        itemTable = reinterpret_cast<const CatalogMenuItem*>(base + header->itemsOffset);
+        strings = base + header->stringsOffset;
+        stringBytes = (uint32_t)(size - header->stringsOffset);
+
+        // Every reference is checked once here so lookups never need to
+        for (uint32_t i = 0; i < header->restaurantCount; i++) {
+            const CatalogRestaurant& r = restaurantTable[i];
+            if ((uint64_t)r.firstItem + r.itemCount > header->itemCount || idIndex[i].slot >= header->restaurantCount ||
+                !validString(r.name) || !validString(r.cuisine) || !validString(r.address) || !validString(r.phone)) {
+                error = "restaurant " + to_string(i) + " is out of range";
+                return false;
+            }
+        }
+        for (uint32_t i = 0; i < header->itemCount; i++) {
+            const CatalogMenuItem& item = itemTable[i];
+            if (!validString(item.name) || !validString(item.description) || !validString(item.category)) {
+                error = "menu item " + to_string(i) + " is out of range";
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool validString(uint32_t ref) const {
+        if (ref % 4 != 0 || (uint64_t)ref + 4 > stringBytes) return false;
+        uint32_t length;
+        memcpy(&length, strings + ref, 4);
+        return (uint64_t)ref + 4 + length < stringBytes && strings[ref + 4 + length] == '\0';
+    }
+
+public:
+    // Null (with error set) if path is missing, damaged or from another
+    // version
+    static shared_ptr<const CatalogSnapshot> open(const string& path, string* error = nullptr) {
+        shared_ptr<CatalogSnapshot> snapshot(new CatalogSnapshot());
+        string reason;
+        if (!snapshot->map(path, reason) || !snapshot->validate(reason)) {
+            if (error) *error = reason;
+            return shared_ptr<const CatalogSnapshot>();
+        }
+        return snapshot;
+    }
+
+    // Writes a snapshot of restaurants and the menu items that belong to
+    // them; items of unknown restaurants are left out. Menus keep the
+    // order of menuItems.
+    static bool build(const string& path, const vector<Restaurant>& restaurants,
+                      const vector<MenuItem>& menuItems, uint64_t generation, uint64_t sourceStamp) {
+        unordered_map<int, uint32_t> slots;
+        for (size_t i = 0; i < restaurants.size(); i++) {
+            slots.emplace(restaurants[i].getRestaurantId(), (uint32_t)i);
+        }
+
+        // Counting sort of the items by restaurant slot
+        vector<uint32_t> runStart(restaurants.size() + 1, 0);
+        vector<int64_t> itemSlots(menuItems.size(), -1);
+        for (size_t i = 0; i < menuItems.size(); i++) {
+            auto it = slots.find(menuItems[i].restaurantId);
+            if (it == slots.end()) continue;
+            itemSlots[i] = it->second;
+            runStart[it->second + 1]++;
+        }
+        for (size_t s = 0; s < restaurants.size(); s++) runStart[s + 1] += runStart[s];
+
+        StringPool pool;
+        vector<CatalogMenuItem> items(runStart[restaurants.size()]);
+        vector<uint32_t> next(runStart.begin(), runStart.end() - 1);
+        for (size_t i = 0; i < menuItems.size(); i++) {
+            if (itemSlots[i] < 0) continue;
+            const MenuItem& source = menuItems[i];
+            CatalogMenuItem& item = items[next[itemSlots[i]]++];
+            item.id = source.id;
+            item.restaurantId = source.restaurantId;
+            item.price = source.price;
+            item.stock = source.stock;
+            item.name = pool.intern(source.getName());
+            item.description = pool.intern(source.getDescription());
+            item.category = pool.intern(source.getCategory());
+        }
+
+        vector<CatalogRestaurant> table(restaurants.size());
+        vector<CatalogIdEntry> index(restaurants.size());
+        for (size_t i = 0; i < restaurants.size(); i++) {
+            const Restaurant& source = restaurants[i];
+            CatalogRestaurant& r = table[i];
+            memset(&r, 0, sizeof(r));
+            r.id = source.getRestaurantId();
+            r.locationNode = source.getLocationNode();
+            r.rating = source.getRating();
+            r.deliveryTime = source.getDeliveryTime();
+            r.name = pool.intern(source.getName());
+            r.cuisine = pool.intern(source.getCuisine());
+            r.address = pool.intern(source.getAddress());
+            r.phone = pool.intern(source.getPhone());
+            r.firstItem = runStart[i];
+            r.itemCount = runStart[i + 1] - runStart[i];
+            index[i].id = r.id;
+            index[i].slot = (uint32_t)i;
+        }
+        // Stable, so with duplicate ids the first restaurant wins, as in a scan
+        stable_sort(index.begin(), index.end(),
+                    [](const CatalogIdEntry& a, const CatalogIdEntry& b) { return a.id < b.id; });
+
+        CatalogSnapshotHeader h;
+        memset(&h, 0, sizeof(h));
+        memcpy(h.magic, magic(), 4);
+        h.version = VERSION;
+        h.headerSize = sizeof(CatalogSnapshotHeader);
+        h.generation = generation;
+        h.sourceStamp = sourceStamp;
+        h.restaurantCount = (uint32_t)table.size();
+        h.itemCount = (uint32_t)items.size();
+        h.restaurantsOffset = sizeof(CatalogSnapshotHeader);
+        h.idIndexOffset = h.restaurantsOffset + (uint32_t)(table.size() * sizeof(CatalogRestaurant));
+        h.itemsOffset = h.idIndexOffset + (uint32_t)(index.size() * sizeof(CatalogIdEntry));
+        h.stringsOffset = h.itemsOffset + (uint32_t)(items.size() * sizeof(CatalogMenuItem));
+        h.fileSize = h.stringsOffset + (uint32_t)pool.data().size();
+
+        vector<FileSegment> body;
+        body.push_back(FileSegment(table.data(), table.size() * sizeof(CatalogRestaurant)));
+        body.push_back(FileSegment(index.data(), index.size() * sizeof(CatalogIdEntry)));
+        body.push_back(FileSegment(items.data(), items.size() * sizeof(CatalogMenuItem)));
+        body.push_back(FileSegment(pool.data().data(), pool.data().size()));
+
+        uint32_t crc = 0;
+        for (const auto& segment : body) crc = Crc32c::compute(segment.data, segment.size, crc);
+        h.bodyCrc = crc;
+        h.headerCrc = headerCrc(h);
+
+        body.insert(body.begin(), FileSegment(&h, sizeof(h)));
+        return AtomicFileWriter::write(path, body);
+    }
+
+    // Size, identity (inode, or volume and file index on Windows) and
+    // sub-second modification time of each file, folded into one value; a
+    // snapshot whose stamp still matches was built from these files. Files
+    // are replaced by a rename, so the identity changes with every rewrite
+    // even when the size and the modification time do not.
+    static uint64_t stampOf(const vector<string>& paths) {
+        uint64_t stamp = 0;
+        for (const auto& path : paths) {
+            int64_t fields[4] = { -1, -1, -1, -1 };
+#ifdef _WIN32
+            HANDLE handle = CreateFileA(path.c_str(), 0, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                                        NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+            BY_HANDLE_FILE_INFORMATION info;
+            if (handle != INVALID_HANDLE_VALUE && GetFileInformationByHandle(handle, &info)) {
+                fields[0] = ((int64_t)info.nFileSizeHigh << 32) | info.nFileSizeLow;
+                fields[1] = ((int64_t)info.ftLastWriteTime.dwHighDateTime << 32) | info.ftLastWriteTime.dwLowDateTime;
+                fields[2] = ((int64_t)info.nFileIndexHigh << 32) | info.nFileIndexLow;
+                fields[3] = (int64_t)info.dwVolumeSerialNumber;
+            }
+            if (handle != INVALID_HANDLE_VALUE) CloseHandle(handle);
+#else
+            struct stat info;
+            if (stat(path.c_str(), &info) == 0) {
+                fields[0] = (int64_t)info.st_size;
+                fields[1] = (int64_t)info.st_mtime;
+                fields[2] = (int64_t)info.st_ino;
+#if defined(__APPLE__)
+                fields[3] = (int64_t)info.st_mtimespec.tv_nsec;
+#else
+                fields[3] = (int64_t)info.st_mtim.tv_nsec;
+#endif
+            }
+#endif
+            uint32_t low = Crc32c::compute(fields, sizeof(fields), (uint32_t)stamp);
+            uint32_t high = Crc32c::compute(fields, sizeof(fields), (uint32_t)(stamp >> 32) ^ 0x5bd1e995);
+            stamp = ((uint64_t)high << 32) | low;
+        }
+        return stamp;
+    }
+
+    uint64_t getGeneration() const { return header->generation; }
+    uint64_t getSourceStamp() const { return header->sourceStamp; }
+    size_t getFileSize() const { return size; }
+
+    uint32_t restaurantCount() const { return header->restaurantCount; }
+    uint32_t menuItemCount() const { return header->itemCount; }
+
+    const CatalogRestaurant& restaurant(uint32_t slot) const { return restaurantTable[slot]; }
+
+    // Null if there's no restaurant with that id
+    const CatalogRestaurant* findRestaurant(int id) const {
+        const CatalogIdEntry* end = idIndex + header->restaurantCount;
+        const CatalogIdEntry* it = lower_bound(idIndex, end, id,
+            [](const CatalogIdEntry& entry, int key) { return entry.id < key; });
+        return (it != end && it->id == id) ? &restaurantTable[it->slot] : nullptr;
+    }
+
+    // The menu of r, as a contiguous run
+    const CatalogMenuItem* menuBegin(const CatalogRestaurant& r) const { return itemTable + r.firstItem; }
+    const CatalogMenuItem* menuEnd(const CatalogRestaurant& r) const { return itemTable + r.firstItem + r.itemCount; }
+
+    uint32_t textLength(uint32_t ref) const {
+        uint32_t length;
+        memcpy(&length, strings + ref, 4);
+        return length;
+    }
+
+    // NUL-terminated, valid while the snapshot is open
+    const char* text(uint32_t ref) const { return strings + ref + 4; }
+
+    void appendText(string& out, uint32_t ref) const { out.append(text(ref), textLength(ref)); }
+};
+
+#endif // CATALOG_SNAPSHOT_H
@@ -0,0 +1,126 @@
+#pragma once
+#ifndef CRC32C_H
+#define CRC32C_H
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+    #include <nmmintrin.h>
+    #define QUICKBITE_CRC32C_HW_GNU
+#elif defined(_M_X64)
+    #include <nmmintrin.h>
+    #include <intrin.h>
+    #define QUICKBITE_CRC32C_HW_MSVC
+#endif
+
+using namespace std;
+
+// CRC-32C (Castagnoli), the checksum of the .dat containers.
+//
+// Uses the SSE4.2 crc32 instruction when the CPU has it, checked once at
+// run time so the same binary still works without it; otherwise a
+// slicing-by-8 table. Both give identical results.
+//
+// compute(b, compute(a)) is the CRC of a followed by b.
+class Crc32c {
+private:
+    enum { POLYNOMIAL = 0x82F63B78 };   // reflected
+
+    struct Tables {
+        uint32_t t[8][256];
+
+        Tables() {
+            for (uint32_t i = 0; i < 256; i++) {
+                uint32_t crc = i;
+                for (int bit = 0; bit < 8; bit++) {
+                    crc = (crc >> 1) ^ ((crc & 1) ? (uint32_t)POLYNOMIAL : 0);
+                }
+                t[0][i] = crc;
+            }
+            for (uint32_t i = 0; i < 256; i++) {
+                for (int k = 1; k < 8; k++) {
+                    t[k][i] = (t[k - 1][i] >> 8) ^ t[0][t[k - 1][i] & 0xFF];
+                }
+            }
+        }
+    };
+
+    static const Tables& tables() {
+        static const Tables instance;
+        return instance;
+    }
+
+    static uint32_t software(uint32_t crc, const unsigned char* p, size_t n) {
+        const Tables& tb = tables();
+        while (n >= 8) {
+            uint32_t low, high;
+            memcpy(&low, p, 4);
+            memcpy(&high, p + 4, 4);
+            low ^= crc;
+            crc = tb.t[7][low & 0xFF] ^ tb.t[6][(low >> 8) & 0xFF] ^
+                  tb.t[5][(low >> 16) & 0xFF] ^ tb.t[4][low >> 24] ^
+                  tb.t[3][high & 0xFF] ^ tb.t[2][(high >> 8) & 0xFF] ^
+                  tb.t[1][(high >> 16) & 0xFF] ^ tb.t[0][high >> 24];
+            p += 8;
+            n -= 8;
+        }
+        while (n-- > 0) {
+            crc = (crc >> 8) ^ tb.t[0][(crc ^ *p++) & 0xFF];
+        }
+        return crc;
+    }
+
+#if defined(QUICKBITE_CRC32C_HW_GNU) || defined(QUICKBITE_CRC32C_HW_MSVC)
+#ifdef QUICKBITE_CRC32C_HW_GNU
+    __attribute__((target("sse4.2")))
+#endif
+    static uint32_t hardware(uint32_t crc, const unsigned char* p, size_t n) {
+        uint64_t crc64 = crc;
+        while (n >= 8) {
+            uint64_t word;
+            memcpy(&word, p, 8);
+            crc64 = _mm_crc32_u64(crc64, word);
+            p += 8;
+            n -= 8;
+        }
+        crc = (uint32_t)crc64;
+        while (n-- > 0) {
+            crc = _mm_crc32_u8(crc, *p++);
+        }
+        return crc;
+    }
+
+    static bool detectHardware() {
+#ifdef QUICKBITE_CRC32C_HW_GNU
+        return __builtin_cpu_supports("sse4.2");
+#else
+        int info[4];
+        __cpuid(info, 1);
+        return (info[2] & (1 << 20)) != 0;
+#endif
+    }
+#endif
+
+public:
+    static bool hardwareAccelerated() {
+#if defined(QUICKBITE_CRC32C_HW_GNU) || defined(QUICKBITE_CRC32C_HW_MSVC)
+        static const bool available = detectHardware();
+        return available;
+#else
+        return false;
+#endif
+    }
+
+    static uint32_t compute(const void* data, size_t size, uint32_t previous = 0) {
+        const unsigned char* p = static_cast<const unsigned char*>(data);
+        uint32_t crc = ~previous;
+#if defined(QUICKBITE_CRC32C_HW_GNU) || defined(QUICKBITE_CRC32C_HW_MSVC)
+        if (hardwareAccelerated()) return ~hardware(crc, p, size);
+#endif
+        return ~software(crc, p, size);
+    }
+};
+
+#endif // CRC32C_H
@@ -0,0 +1,115 @@
+#pragma once
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <string>
+#include <cstddef>
+
+#ifdef _WIN32
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+#endif
+
+using namespace std;
+
+// A whole file mapped read-only, so a large file can be scanned by
+// several threads at once without reading it into memory first. Pages
+// are read in by the kernel as they're touched.
+class MappedFile {
+private:
+    const char* base;
+    size_t length;
+
+#ifdef _WIN32
+    HANDLE file;
+    HANDLE mapping;
+#endif
+
+    MappedFile(const MappedFile&);
+    MappedFile& operator=(const MappedFile&);
+
+public:
+    MappedFile() : base(nullptr), length(0) {
+#ifdef _WIN32
+        file = INVALID_HANDLE_VALUE;
+        mapping = NULL;
+#endif
+    }
+
+    ~MappedFile() { close(); }
+
+    // False with error set if the file can't be mapped; an empty file
+    // opens with size() 0
+    bool open(const string& path, string& error) {
+        close();
+#ifdef _WIN32
+        file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, NULL,
+                           OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+        if (file == INVALID_HANDLE_VALUE) {
+            error = "can't open " + path;
+            return false;
+        }
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file, &fileSize)) {
+            error = "can't read the size of " + path;
+            return false;
+        }
+        length = (size_t)fileSize.QuadPart;
+        if (length == 0) return true;
+        mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (mapping) base = (const char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+#else
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            error = "can't open " + path;
+            return false;
+        }
+        struct stat info;
+        if (fstat(fd, &info) != 0) {
+            ::close(fd);
+            error = "can't read the size of " + path;
+            return false;
+        }
+        length = (size_t)info.st_size;
+        if (length == 0) {
+            ::close(fd);
+            return true;
+        }
+        void* mapped = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (mapped != MAP_FAILED) {
+            base = (const char*)mapped;
+            madvise(mapped, length, MADV_WILLNEED);
+        }
+#endif
+        if (!base) {
+            error = "can't map " + path;
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    void close() {
+#ifdef _WIN32
+        if (base) UnmapViewOfFile(base);
+        if (mapping) CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+        mapping = NULL;
+        file = INVALID_HANDLE_VALUE;
+#else
+        if (base) munmap(const_cast<char*>(base), length);
+#endif
+        base = nullptr;
+        length = 0;
+    }
+
+    const char* data() const { return base; }
+    size_t size() const { return length; }
+};
+
+#endif // MAPPED_FILE_H
@@ -0,0 +1,435 @@
+#pragma once
+#ifndef ONLINE_BACKUP_H
+#define ONLINE_BACKUP_H
+
+#include <string>
+#include <vector>
+#include <cstring>
+#include <cstdint>
+#include <cstdio>
+#include "AtomicFileWriter.h"
+#include "PagedRecordFile.h"
+#include "../Logger.h"
+
+#ifdef _WIN32
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <sys/stat.h>
+    #include <cerrno>
+    #ifdef __linux__
+        #include <sys/ioctl.h>
+        #ifndef FICLONE
+            #define FICLONE _IOW(0x94, 9, int)
+        #endif
+    #endif
+#endif
+
+using namespace std;
+
+// How one file of a backup was copied
+struct BackupFileResult {
+    string source;
+    string target;
+    bool found;                 // the source existed when the backup was frozen
+    bool ok;
+    const char* method;         // unchanged, incremental, reflink, copy_file_range, read/write
+    uint64_t bytes;             // size of the file backed up
+    uint64_t bytesCopied;       // data actually moved; 0 for a reflink
+    uint32_t pagesCopied;       // incremental copies only
+
+    BackupFileResult() : found(false), ok(false), method(""), bytes(0), bytesCopied(0), pagesCopied(0) {}
+};
+
+// Copies data files into backup files while the server keeps serving.
+//
+//   OnlineBackup backup;
+//   backup.add("users.dat", "users_backup.dat");
+//   { Database::FileGuard files(db); backup.freeze(); }
+//   backup.copy();
+//
+// freeze() only opens the sources. The record files are never written in
+// place, always replaced whole by a rename (AtomicFileWriter), so an open
+// handle goes on reading the version it opened after a newer one takes its
+// name. Opened while the writers' lock is held, the handles are one
+// point-in-time view of every file, and writers wait only for the opens,
+// not for the copy. Windows is the exception: a rename over a file that is
+// open fails there, so the lock has to be held until copy() returns.
+//
+// copy() writes each target through <target>.tmp and a rename, so an
+// interrupted backup leaves the previous one intact. A paged file whose
+// previous backup has the same page size is compared page header by page
+// header: if none differ the backup is left as it is, otherwise the
+// previous backup is cloned and only the header and the changed pages are
+// copied over it. A page whose header (index, record count and CRC32C of
+// its records) matches is taken to be unchanged without reading its
+// records; two different pages with the same count and checksum would go
+// unnoticed, which CRC32C makes unlikely but not impossible. Other files are cloned
+// whole where the filesystem shares extents (reflink), or copied inside
+// the kernel with copy_file_range, falling back to read/write.
+class OnlineBackup {
+private:
+#ifdef _WIN32
+    typedef HANDLE FileHandle;
+    static FileHandle noFile() { return INVALID_HANDLE_VALUE; }
+#else
+    typedef int FileHandle;
+    static FileHandle noFile() { return -1; }
+#endif
+
+    enum { COPY_CHUNK = 1 << 20 };
+
+    struct Entry {
+        FileHandle handle;
+        BackupFileResult result;
+    };
+
+    vector<Entry> entries;
+
+    OnlineBackup(const OnlineBackup&);
+    OnlineBackup& operator=(const OnlineBackup&);
+
+    // The other writers of these files may replace them while they're open
+    static FileHandle openForReading(const string& path) {
+#ifdef _WIN32
+        return CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                           NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+#else
+        return ::open(path.c_str(), O_RDONLY);
+#endif
+    }
+
+    static FileHandle createTemp(const string& path) {
+#ifdef _WIN32
+        return CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, 0, NULL, CREATE_ALWAYS,
+                           FILE_ATTRIBUTE_NORMAL, NULL);
+#else
+        return ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+#endif
+    }
+
+    static void closeFile(FileHandle handle) {
+        if (handle == noFile()) return;
+#ifdef _WIN32
+        CloseHandle(handle);
+#else
+        ::close(handle);
+#endif
+    }
+
+    static bool sizeOf(FileHandle handle, uint64_t& size) {
+#ifdef _WIN32
+        LARGE_INTEGER length;
+        if (!GetFileSizeEx(handle, &length)) return false;
+        size = (uint64_t)length.QuadPart;
+#else
+        struct stat info;
+        if (::fstat(handle, &info) != 0) return false;
+        size = (uint64_t)info.st_size;
+#endif
+        return true;
+    }
+
+    static bool readAt(FileHandle handle, uint64_t offset, void* buffer, size_t size) {
+        char* at = static_cast<char*>(buffer);
+        while (size > 0) {
+#ifdef _WIN32
+            OVERLAPPED position;
+            memset(&position, 0, sizeof(position));
+            position.Offset = (DWORD)offset;
+            position.OffsetHigh = (DWORD)(offset >> 32);
+            DWORD done = 0;
+            DWORD chunk = size > COPY_CHUNK ? (DWORD)COPY_CHUNK : (DWORD)size;
+            if (!ReadFile(handle, at, chunk, &done, &position) || done == 0) return false;
+#else
+            ssize_t done = ::pread(handle, at, size, (off_t)offset);
+            if (done < 0 && errno == EINTR) continue;
+            if (done <= 0) return false;
+#endif
+            at += done;
+            offset += done;
+            size -= done;
+        }
+        return true;
+    }
+
+    static bool writeAt(FileHandle handle, uint64_t offset, const void* buffer, size_t size) {
+        const char* at = static_cast<const char*>(buffer);
+        while (size > 0) {
+#ifdef _WIN32
+            OVERLAPPED position;
+            memset(&position, 0, sizeof(position));
+            position.Offset = (DWORD)offset;
+            position.OffsetHigh = (DWORD)(offset >> 32);
+            DWORD done = 0;
+            DWORD chunk = size > COPY_CHUNK ? (DWORD)COPY_CHUNK : (DWORD)size;
+            if (!WriteFile(handle, at, chunk, &done, &position) || done == 0) return false;
+#else
+            ssize_t done = ::pwrite(handle, at, size, (off_t)offset);
+            if (done < 0 && errno == EINTR) continue;
+            if (done <= 0) return false;
+#endif
+            at += done;
+            offset += done;
+            size -= done;
+        }
+        return true;
+    }
+
+    // Shares all of source's extents with target instead of copying them
+    static bool cloneInto(FileHandle target, FileHandle source) {
+#if defined(__linux__)
+        return ::ioctl(target, FICLONE, source) == 0;
+#else
+        (void)target;
+        (void)source;
+        return false;
+#endif
+    }
+
+    // Copies size bytes at offset from source to the same offset in
+    // target; inKernel reports whether copy_file_range did it all
+    static bool copyRange(FileHandle source, FileHandle target, uint64_t offset, uint64_t size, bool& inKernel) {
+#if defined(__linux__)
+        while (size > 0) {
+            loff_t from = (loff_t)offset;
+            loff_t to = (loff_t)offset;
+            ssize_t done = ::copy_file_range(source, &from, target, &to, size, 0);
+            if (done < 0 && errno == EINTR) continue;
+            if (done <= 0) break;           // not supported here; the rest goes through a buffer
+            offset += done;
+            size -= done;
+        }
+        if (size == 0) return true;
+#endif
+        inKernel = false;
+        vector<char> buffer((size_t)(size < COPY_CHUNK ? size : (uint64_t)COPY_CHUNK));
+        while (size > 0) {
+            size_t chunk = (size_t)(size < buffer.size() ? size : buffer.size());
+            if (!readAt(source, offset, buffer.data(), chunk) || !writeAt(target, offset, buffer.data(), chunk)) {
+                return false;
+            }
+            offset += chunk;
+            size -= chunk;
+        }
+        return true;
+    }
+
+    static bool setSize(FileHandle handle, uint64_t size) {
+#ifdef _WIN32
+        LARGE_INTEGER length;
+        length.QuadPart = (LONGLONG)size;
+        return SetFilePointerEx(handle, length, NULL, FILE_BEGIN) && SetEndOfFile(handle);
+#else
+        return ::ftruncate(handle, (off_t)size) == 0;
+#endif
+    }
+
+    // Syncs and closes temp, then publishes it over target the way
+    // AtomicFileWriter does, directory sync included, so a finished backup
+    // survives a crash right after the rename
+    static bool commit(FileHandle temp, const string& tempPath, const string& target, bool ok) {
+#ifdef _WIN32
+        ok = ok && FlushFileBuffers(temp);
+        CloseHandle(temp);
+#else
+        ok = ok && ::fsync(temp) == 0;
+        ok = (::close(temp) == 0) && ok;
+#endif
+        if (!ok) {
+            AtomicFileWriter::discard(tempPath);
+            return false;
+        }
+        return AtomicFileWriter::publish(tempPath, target);
+    }
+
+    // The file header and every page header of a paged file of size bytes;
+    // false if it isn't one or the headers don't describe its size
+    static bool readPageHeaders(FileHandle handle, uint64_t size, PagedFileHeader& header, vector<PageHeader>& pages) {
+        if (size < sizeof(PagedFileHeader) || !readAt(handle, 0, &header, sizeof(header))) return false;
+        if (memcmp(header.magic, "QBPF", 4) != 0 || header.headerSize != sizeof(PagedFileHeader) ||
+            (header.version != PagedRecordFile::VERSION && header.version != PagedRecordFile::PADDED_VERSION) ||
+            header.pageSize < sizeof(PageHeader) || !PagedRecordFile::countsAgree(header) ||
+            size != PagedRecordFile::fileSize(header)) {
+            return false;
+        }
+        pages.resize(header.pageCount);
+        for (uint32_t i = 0; i < header.pageCount; i++) {
+            if (!readAt(handle, PagedRecordFile::pageOffset(header, i), &pages[i], sizeof(PageHeader))) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Same index, record count and checksum; the records aren't compared
+    static bool samePage(const PageHeader& a, const PageHeader& b) {
+        return memcmp(&a, &b, sizeof(PageHeader)) == 0;
+    }
+
+    // Brings an existing backup of a paged file up to date by copying only
+    // what changed. False (target untouched) if it can't be done that way.
+    static bool copyChangedPages(FileHandle source, uint64_t size, const string& target, BackupFileResult& result) {
+        PagedFileHeader header;
+        vector<PageHeader> pages;
+        if (!readPageHeaders(source, size, header, pages)) return false;
+
+        FileHandle previous = openForReading(target);
+        if (previous == noFile()) return false;
+
+        uint64_t previousSize = 0;
+        PagedFileHeader previousHeader;
+        vector<PageHeader> previousPages;
+        bool comparable = sizeOf(previous, previousSize) &&
+                          readPageHeaders(previous, previousSize, previousHeader, previousPages) &&
+                          previousHeader.pageSize == header.pageSize;
+
+        // Runs of pages [first, end) that differ from the previous backup
+        vector<pair<uint32_t, uint32_t>> changed;
+        for (uint32_t i = 0; comparable && i < header.pageCount; i++) {
+            if (i < previousPages.size() && samePage(pages[i], previousPages[i])) continue;
+            if (!changed.empty() && changed.back().second == i) changed.back().second = i + 1;
+            else changed.push_back(make_pair(i, i + 1));
+        }
+        bool sameHeader = comparable && memcmp(&header, &previousHeader, sizeof(header)) == 0;
+
+        if (comparable && sameHeader && changed.empty()) {
+            closeFile(previous);
+            result.method = "unchanged";
+            return true;
+        }
+
+        string tempPath = target + ".tmp";
+        FileHandle temp = comparable ? createTemp(tempPath) : noFile();
+        if (temp == noFile() || !cloneInto(temp, previous)) {
+            // Rewriting a plain copy of the old backup would cost as much
+            // as copying the new file whole
+            if (temp != noFile()) {
+                closeFile(temp);
+#ifdef _WIN32
+                DeleteFileA(tempPath.c_str());
+#else
+                ::unlink(tempPath.c_str());
+#endif
+            }
+            closeFile(previous);
+            return false;
+        }
+        closeFile(previous);
+
+        bool inKernel = true;
+        bool ok = setSize(temp, size) && copyRange(source, temp, 0, header.headerSize, inKernel);
+        result.bytesCopied = header.headerSize;
+        for (size_t r = 0; ok && r < changed.size(); r++) {
+            // The last page may be short
+            uint64_t offset = PagedRecordFile::pageOffset(header, changed[r].first);
+            uint64_t end = changed[r].second < header.pageCount ? PagedRecordFile::pageOffset(header, changed[r].second)
+                                                                : size;
+            uint64_t bytes = end - offset;
+            ok = copyRange(source, temp, offset, bytes, inKernel);
+            result.bytesCopied += bytes;
+            result.pagesCopied += changed[r].second - changed[r].first;
+        }
+        result.ok = commit(temp, tempPath, target, ok);
+        result.method = "incremental";
+        return result.ok;
+    }
+
+    static bool copyWhole(FileHandle source, uint64_t size, const string& target, BackupFileResult& result) {
+        string tempPath = target + ".tmp";
+        FileHandle temp = createTemp(tempPath);
+        if (temp == noFile()) return false;
+
+        if (cloneInto(temp, source)) {
+            result.method = "reflink";
+            return commit(temp, tempPath, target, true);
+        }
+
+        bool inKernel = true;
+        bool ok = copyRange(source, temp, 0, size, inKernel);
+        result.bytesCopied = size;
+        result.method = inKernel ? "copy_file_range" : "read/write";
+        return commit(temp, tempPath, target, ok);
+    }
+
+public:
+    OnlineBackup() {}
+
+    ~OnlineBackup() {
+        for (size_t i = 0; i < entries.size(); i++) closeFile(entries[i].handle);
+    }
+
+    void add(const string& source, const string& target) {
+        Entry entry;
+        entry.handle = noFile();
+        entry.result.source = source;
+        entry.result.target = target;
+        entries.push_back(entry);
+    }
+
+    // Opens every source, fixing the versions the backup will hold. Call
+    // while nothing can replace the files; a missing source is skipped.
+    void freeze() {
+        for (size_t i = 0; i < entries.size(); i++) {
+            closeFile(entries[i].handle);
+            entries[i].handle = openForReading(entries[i].result.source);
+            entries[i].result.found = entries[i].handle != noFile();
+        }
+    }
+
+    // Copies the frozen sources; needs no lock. False if any target
+    // couldn't be written.
+    bool copy() {
+        bool allOk = true;
+        for (size_t i = 0; i < entries.size(); i++) {
+            Entry& entry = entries[i];
+            BackupFileResult& result = entry.result;
+            if (!result.found) {
+                result.ok = true;
+                result.method = "missing";
+                continue;
+            }
+
+            if (!sizeOf(entry.handle, result.bytes)) {
+                result.ok = false;
+            } else if (copyChangedPages(entry.handle, result.bytes, result.target, result)) {
+                result.ok = true;
+            } else {
+                result.bytesCopied = 0;
+                result.pagesCopied = 0;
+                result.ok = copyWhole(entry.handle, result.bytes, result.target, result);
+            }
+
+            if (!result.ok) {
+                LOG_ERROR("Backup of " << result.source << " to " << result.target << " failed");
+                allOk = false;
+            }
+            closeFile(entry.handle);
+            entry.handle = noFile();
+        }
+        return allOk;
+    }
+
+    vector<BackupFileResult> getResults() const {
+        vector<BackupFileResult> results;
+        for (size_t i = 0; i < entries.size(); i++) results.push_back(entries[i].result);
+        return results;
+    }
+
+    void logSummary() const {
+        uint64_t total = 0;
+        uint64_t copied = 0;
+        for (size_t i = 0; i < entries.size(); i++) {
+            const BackupFileResult& result = entries[i].result;
+            total += result.bytes;
+            copied += result.bytesCopied;
+            LOG_DEBUG("  " << result.source << " -> " << result.target << ": " << result.method
+                     << ", " << result.bytesCopied << " of " << result.bytes << " bytes"
+                     << (result.pagesCopied ? " (" + to_string(result.pagesCopied) + " pages)" : string()));
+        }
+        LOG_INFO("Backup of " << entries.size() << " files: " << copied << " of " << total << " bytes copied");
+    }
+};
+
+#endif // ONLINE_BACKUP_H
@@ -0,0 +1,378 @@
+#pragma once
+#ifndef PAGED_RECORD_FILE_H
+#define PAGED_RECORD_FILE_H
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <memory>
+#include <cstring>
+#include <cstddef>
+#include <cstdint>
+#include "AtomicFileWriter.h"
+#include "Crc32c.h"
+
+using namespace std;
+
+// Schema names of the record files. A file only loads as the type whose
+// name and record size it was written with.
+namespace RecordSchema {
+    const char* const USERS = "UserData";
+    const char* const RESTAURANTS = "Restaurant";
+    const char* const ORDERS = "Order";
+    const char* const RIDERS = "Rider";
+}
+
+// First bytes of every paged .dat file
+struct PagedFileHeader {
+    char magic[4];              // "QBPF"
+    uint16_t version;
+    uint16_t headerSize;
+    uint32_t schemaHash;        // record type name and size
+    uint32_t recordSize;
+    uint32_t recordsPerPage;
+    uint32_t pageSize;          // bytes, page header included
+    uint64_t recordCount;
+    uint32_t pageCount;
+    uint32_t reserved[2];
+    uint32_t headerCrc;         // CRC32C of everything above
+};
+
+// Start of each page; crc covers the rest of this header and the page's
+// records (not the zero padding version 1 put after the last record)
+struct PageHeader {
+    uint32_t crc;
+    uint32_t pageIndex;
+    uint32_t recordCount;
+    uint32_t reserved;
+};
+
+// What a check of a paged file found
+struct PagedFileReport {
+    bool container;             // starts with the paged-file magic
+    bool headerValid;
+    string error;               // why the header was rejected
+    uint32_t recordSize;
+    uint32_t recordsPerPage;
+    uint32_t pageCount;
+    uint64_t recordCount;
+    vector<uint32_t> badPages;
+    uint64_t recordsRecovered;
+
+    PagedFileReport() : container(false), headerValid(false), recordSize(0), recordsPerPage(0),
+                        pageCount(0), recordCount(0), recordsRecovered(0) {}
+
+    uint64_t recordsLost() const { return recordCount - recordsRecovered; }
+};
+
+// Fixed-size records stored as a header followed by fixed-size pages,
+// each carrying its own CRC32C and record count.
+//
+// A whole file is read with one read and checked page by page; a damaged
+// page loses only its own records, and its index says exactly where the
+// damage is. Files are written in one gathered write through
+// AtomicFileWriter, records straight from the caller's vector.
+//
+// Every page but the last holds recordsPerPage records; the last one ends
+// after its own records, so a small file isn't a whole page long. Version
+// 1 files, which padded the last page out to pageSize, still load.
+class PagedRecordFile {
+public:
+    enum { VERSION = 2, PADDED_VERSION = 1, TARGET_PAGE_BYTES = 64 * 1024 };
+
+    // Records page index of a file laid out as header describes has room for
+    static uint32_t pageCapacity(const PagedFileHeader& header, uint32_t index) {
+        if (header.version == PADDED_VERSION || index + 1 < header.pageCount) return header.recordsPerPage;
+        return (uint32_t)(header.recordCount - (uint64_t)index * header.recordsPerPage);
+    }
+
+    static uint64_t pageOffset(const PagedFileHeader& header, uint32_t index) {
+        return header.headerSize + (uint64_t)index * header.pageSize;
+    }
+
+    // Size of the file header describes. Its record count must fill all
+    // but the last of its pages (checkHeader() makes sure of that).
+    static uint64_t fileSize(const PagedFileHeader& header) {
+        if (header.pageCount == 0) return header.headerSize;
+        uint32_t last = header.pageCount - 1;
+        return pageOffset(header, last) + sizeof(PageHeader) + (uint64_t)pageCapacity(header, last) * header.recordSize;
+    }
+
+    // Whether header's record count fits its pages the way its version
+    // lays them out
+    static bool countsAgree(const PagedFileHeader& header) {
+        uint64_t capacity = (uint64_t)header.pageCount * header.recordsPerPage;
+        if (header.recordCount > capacity) return false;
+        return header.version == PADDED_VERSION || header.pageCount == 0 ||
+               header.recordCount > capacity - header.recordsPerPage;
+    }
+
+private:
+    static const char* magic() { return "QBPF"; }
+
+    static uint32_t schemaHash(const char* schema, size_t recordSize) {
+        string key = string(schema) + ":" + to_string(recordSize);
+        return Crc32c::compute(key.data(), key.size());
+    }
+
+    static uint32_t headerCrc(const PagedFileHeader& header) {
+        return Crc32c::compute(&header, offsetof(PagedFileHeader, headerCrc));
+    }
+
+    static uint32_t pageCrc(const PageHeader& page, const char* records, size_t bytes) {
+        uint32_t crc = Crc32c::compute(&page.pageIndex, sizeof(PageHeader) - offsetof(PageHeader, pageIndex));
+        return Crc32c::compute(records, bytes, crc);
+    }
+
+    // Whole file in one read, into a buffer that isn't zero-filled first
+    static bool readFile(const string& path, unique_ptr<char[]>& bytes, size_t& size) {
+        ifstream file(path, ios::binary | ios::ate);
+        if (!file) return false;
+        size = (size_t)file.tellg();
+        file.seekg(0, ios::beg);
+        bytes.reset(new char[size > 0 ? size : 1]);
+        return size == 0 || (bool)file.read(bytes.get(), size);
+    }
+
+    // The header write() gives recordCount records of T
+    template<typename T>
+    static PagedFileHeader makeHeader(const char* schema, uint64_t recordCount) {
+        PagedFileHeader header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, magic(), 4);
+        header.version = VERSION;
+        header.headerSize = sizeof(PagedFileHeader);
+        header.schemaHash = schemaHash(schema, sizeof(T));
+        header.recordSize = sizeof(T);
+        header.recordsPerPage = sizeof(T) >= TARGET_PAGE_BYTES ? 1
+                              : (uint32_t)((TARGET_PAGE_BYTES - sizeof(PageHeader)) / sizeof(T));
+        header.pageSize = sizeof(PageHeader) + header.recordsPerPage * sizeof(T);
+        header.recordCount = recordCount;
+        header.pageCount = (uint32_t)((recordCount + header.recordsPerPage - 1) / header.recordsPerPage);
+        header.headerCrc = headerCrc(header);
+        return header;
+    }
+
+    // Checks the header of bytes into header and report. expectedSchema 0
+    // skips the schema check.
+    static bool checkHeader(const char* bytes, size_t size, uint32_t expectedSchema, size_t expectedRecordSize,
+                            PagedFileHeader& header, PagedFileReport& report) {
+        report = PagedFileReport();
+        if (size < 4 || memcmp(bytes, magic(), 4) != 0) {
+            report.error = "not a paged file";
+            return false;
+        }
+        report.container = true;
+        if (size < sizeof(PagedFileHeader)) {
+            report.error = "truncated header";
+            return false;
+        }
+
+        memcpy(&header, bytes, sizeof(header));
+        if (header.headerCrc != headerCrc(header)) {
+            report.error = "header checksum mismatch";
+            return false;
+        }
+        if ((header.version != VERSION && header.version != PADDED_VERSION) ||
+            header.headerSize != sizeof(PagedFileHeader)) {
+            report.error = "unsupported version " + to_string(header.version);
+            return false;
+        }
+
+        report.recordSize = header.recordSize;
+        report.recordsPerPage = header.recordsPerPage;
+        report.pageCount = header.pageCount;
+        report.recordCount = header.recordCount;
+
+        if (expectedRecordSize != 0 && header.recordSize != expectedRecordSize) {
+            report.error = "record size " + to_string(header.recordSize) +
+                           ", expected " + to_string(expectedRecordSize);
+            return false;
+        }
+        if (expectedSchema != 0 && header.schemaHash != expectedSchema) {
+            report.error = "written for a different record type";
+            return false;
+        }
+        if (header.recordSize == 0 || header.recordsPerPage == 0 ||
+            header.pageSize != sizeof(PageHeader) + (uint64_t)header.recordsPerPage * header.recordSize) {
+            report.error = "inconsistent page geometry";
+            return false;
+        }
+        if (!countsAgree(header)) {
+            report.error = to_string(header.recordCount) + " records don't fit " +
+                           to_string(header.pageCount) + " pages";
+            return false;
+        }
+        if (size != fileSize(header)) {
+            report.error = "file is " + to_string(size) + " bytes, header describes " + to_string(fileSize(header));
+            return false;
+        }
+        report.headerValid = true;
+        return true;
+    }
+
+    // Checks the header and every page of bytes. onPage(records, count) is
+    // called for each good page.
+    template<typename OnPage>
+    static void verify(const char* bytes, size_t size, uint32_t expectedSchema, size_t expectedRecordSize,
+                       PagedFileReport& report, OnPage onPage) {
+        PagedFileHeader header;
+        if (!checkHeader(bytes, size, expectedSchema, expectedRecordSize, header, report)) return;
+
+        for (uint32_t i = 0; i < header.pageCount; i++) {
+            PageSpan span = page(bytes, header, i);
+            if (!span.intact) {
+                report.badPages.push_back(i);
+                continue;
+            }
+            report.recordsRecovered += span.count;
+            onPage(span.records, span.count);
+        }
+    }
+
+public:
+    // One page of a file in memory. count is the page's own record count
+    // when it's intact, its capacity (see pageCapacity()) when not, as a
+    // damaged page's count can't be trusted.
+    struct PageSpan {
+        const char* records;
+        uint32_t count;
+        bool intact;
+    };
+
+    // Page index of bytes laid out as header describes; the header must
+    // have been checked against the size of bytes
+    static PageSpan page(const char* bytes, const PagedFileHeader& header, uint32_t index) {
+        const char* at = bytes + pageOffset(header, index);
+        PageHeader pageHeader;
+        memcpy(&pageHeader, at, sizeof(pageHeader));
+
+        uint32_t capacity = pageCapacity(header, index);
+        PageSpan span;
+        span.records = at + sizeof(PageHeader);
+        span.intact = pageHeader.pageIndex == index && pageHeader.recordCount <= capacity &&
+                      pageHeader.crc == pageCrc(pageHeader, span.records,
+                                                (size_t)pageHeader.recordCount * header.recordSize);
+        span.count = span.intact ? pageHeader.recordCount : capacity;
+        return span;
+    }
+
+    // Header of a file of T in memory, for tools that go over its pages
+    // themselves (see page()). If its own header is damaged, the layout
+    // write() uses for T is assumed, with as many whole pages as fit in
+    // size and a short last page for the rest; report says which it was.
+    template<typename T>
+    static PagedFileHeader headerOf(const char* bytes, size_t size, const char* schema, PagedFileReport& report) {
+        PagedFileHeader header;
+        if (checkHeader(bytes, size, schemaHash(schema, sizeof(T)), sizeof(T), header, report)) return header;
+
+        header = makeHeader<T>(schema, 0);
+        uint64_t body = size > header.headerSize ? size - header.headerSize : 0;
+        uint64_t pages = body / header.pageSize;
+        uint64_t records = pages * header.recordsPerPage;
+        uint64_t rest = body % header.pageSize;
+        if (rest >= sizeof(PageHeader) + sizeof(T)) {
+            pages++;
+            records += (rest - sizeof(PageHeader)) / sizeof(T);
+        }
+        header.pageCount = (uint32_t)pages;
+        header.recordCount = records;
+        return header;
+    }
+
+    static bool isContainer(const string& path) {
+        ifstream file(path, ios::binary);
+        char start[4];
+        return file && file.read(start, 4) && memcmp(start, magic(), 4) == 0;
+    }
+
+    template<typename T>
+    static bool write(const string& path, const char* schema, const vector<T>& records) {
+        return encode(schema, records, [&](const vector<FileSegment>& segments) {
+            return AtomicFileWriter::write(path, segments);
+        });
+    }
+
+    // Writes the file to temp and syncs it without putting it in place;
+    // AtomicFileWriter::publish(temp, path) does that
+    template<typename T>
+    static bool stage(const string& temp, const char* schema, const vector<T>& records) {
+        return encode(schema, records, [&](const vector<FileSegment>& segments) {
+            return AtomicFileWriter::stage(temp, segments);
+        });
+    }
+
+private:
+    // Lays records out as pages and hands the file's segments to output
+    template<typename T, typename Output>
+    static bool encode(const char* schema, const vector<T>& records, Output output) {
+        PagedFileHeader header = makeHeader<T>(schema, records.size());
+
+        const char* data = records.empty() ? nullptr : reinterpret_cast<const char*>(&records[0]);
+        vector<PageHeader> pages(header.pageCount);
+        vector<FileSegment> segments;
+        segments.reserve(2 * pages.size() + 1);
+        segments.push_back(FileSegment(&header, sizeof(header)));
+
+        for (uint32_t i = 0; i < header.pageCount; i++) {
+            size_t first = (size_t)i * header.recordsPerPage;
+            size_t count = records.size() - first;
+            if (count > header.recordsPerPage) count = header.recordsPerPage;
+            const char* pageRecords = data + first * sizeof(T);
+
+            PageHeader& page = pages[i];
+            page.pageIndex = i;
+            page.recordCount = (uint32_t)count;
+            page.reserved = 0;
+            page.crc = pageCrc(page, pageRecords, count * sizeof(T));
+
+            segments.push_back(FileSegment(&page, sizeof(page)));
+            segments.push_back(FileSegment(pageRecords, count * sizeof(T)));
+        }
+        return output(segments);
+    }
+
+public:
+
+    // Loads the records of every intact page into records. False if the
+    // file can't be read as T at all; damaged pages are listed in report.
+    template<typename T>
+    static bool read(const string& path, const char* schema, vector<T>& records,
+                     PagedFileReport* report = nullptr) {
+        PagedFileReport local;
+        PagedFileReport& result = report ? *report : local;
+        records.clear();
+
+        unique_ptr<char[]> bytes;
+        size_t size;
+        if (!readFile(path, bytes, size)) {
+            result = PagedFileReport();
+            result.error = "can't open " + path;
+            return false;
+        }
+
+        verify(bytes.get(), size, schemaHash(schema, sizeof(T)), sizeof(T), result,
+               [&](const char* pageRecords, uint32_t count) {
+                   if (records.empty()) records.reserve(result.recordCount);
+                   size_t at = records.size();
+                   records.resize(at + count);
+                   memcpy(static_cast<void*>(&records[at]), pageRecords, (size_t)count * sizeof(T));
+               });
+        return result.headerValid;
+    }
+
+    // Checks a file without knowing its record type
+    static PagedFileReport scan(const string& path) {
+        PagedFileReport report;
+        unique_ptr<char[]> bytes;
+        size_t size;
+        if (!readFile(path, bytes, size)) {
+            report.error = "can't open " + path;
+            return report;
+        }
+        verify(bytes.get(), size, 0, 0, report, [](const char*, uint32_t) {});
+        return report;
+    }
+};
+
+#endif // PAGED_RECORD_FILE_H
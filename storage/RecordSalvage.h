@@ -0,0 +1,204 @@
+#pragma once
+#ifndef RECORD_SALVAGE_H
+#define RECORD_SALVAGE_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <chrono>
+#include <cstring>
+#include <cstdint>
+#include "MappedFile.h"
+#include "PagedRecordFile.h"
+#include "../dataStructures/WorkStealingPool.h"
+
+using namespace std;
+
+// What salvaging one record file found
+struct SalvageReport {
+    string filename;
+    string layout;                      // how the file was read
+    string error;                       // why nothing could be read
+    uint64_t fileBytes;
+    uint64_t slotsChecked;              // record slots validated field by field
+    uint64_t recordsKept;
+    uint64_t keptFromDamagedPages;
+    uint64_t emptySlots;                // all-zero slots (page padding, preallocated space)
+    uint64_t trailingBytes;             // raw files: bytes after the last whole record
+    vector<uint32_t> badPages;
+    map<string, uint64_t> rejected;     // reason -> records
+    vector<uint64_t> rejectedOffsets;   // file offsets of the first rejected records
+    double millis;
+
+    SalvageReport() : fileBytes(0), slotsChecked(0), recordsKept(0), keptFromDamagedPages(0),
+                      emptySlots(0), trailingBytes(0), millis(0) {}
+
+    uint64_t rejectedCount() const {
+        uint64_t total = 0;
+        for (const auto& reason : rejected) total += reason.second;
+        return total;
+    }
+};
+
+// Recovers the records of a damaged record file.
+//
+// The file is mapped and cut into spans: the pages of a paged file, or
+// runs of CHUNK_RECORDS records of a raw one. Spans are validated on all
+// cores (WorkStealingPool). Records on a page whose checksum matches are
+// kept as they are; every other record slot is kept only if
+// check(record) - the type's structural checks, e.g. Order::fieldError -
+// finds nothing wrong, so one bad page or a misaligned tail costs only
+// the records that are actually garbage. Kept records are then copied
+// out in parallel, each span to its place given by a prefix sum, so the
+// result keeps file order.
+class RecordSalvage {
+public:
+    enum { CHUNK_RECORDS = 4096, MAX_LISTED_OFFSETS = 20 };
+
+private:
+    struct Span {
+        const char* records;
+        uint64_t offset;                // in the file
+        uint32_t count;
+        bool trusted;                   // on an intact page
+        uint64_t firstSlot;
+        uint64_t kept;
+        uint64_t empty;
+        vector<pair<const char*, uint64_t>> rejected;
+        vector<uint64_t> rejectedOffsets;
+    };
+
+    static bool allZero(const char* bytes, size_t size) {
+        return size == 0 || (bytes[0] == 0 && memcmp(bytes, bytes + 1, size - 1) == 0);
+    }
+
+    template<typename T, typename Check>
+    static void validate(Span& span, vector<char>& keep, Check check) {
+        for (uint32_t i = 0; i < span.count; i++) {
+            const char* at = span.records + (size_t)i * sizeof(T);
+            const char* reason = nullptr;
+            if (!span.trusted) {
+                if (allZero(at, sizeof(T))) {
+                    span.empty++;
+                    continue;
+                }
+                // Mapped records aren't aligned when the page layout
+                // doesn't happen to suit T
+                alignas(T) char scratch[sizeof(T)];
+                const char* record = at;
+                if ((uintptr_t)at % alignof(T) != 0) {
+                    memcpy(scratch, at, sizeof(T));
+                    record = scratch;
+                }
+                reason = check(*reinterpret_cast<const T*>(record));
+            }
+
+            if (!reason) {
+                keep[span.firstSlot + i] = 1;
+                span.kept++;
+                continue;
+            }
+            size_t r = 0;
+            while (r < span.rejected.size() && span.rejected[r].first != reason) r++;
+            if (r == span.rejected.size()) span.rejected.push_back(make_pair(reason, 0));
+            span.rejected[r].second++;
+            if (span.rejectedOffsets.size() < MAX_LISTED_OFFSETS) {
+                span.rejectedOffsets.push_back(span.offset + (uint64_t)i * sizeof(T));
+            }
+        }
+    }
+
+public:
+    template<typename T, typename Check>
+    static vector<T> salvage(const string& filename, const char* schema, Check check, SalvageReport& report) {
+        auto started = chrono::steady_clock::now();
+        report = SalvageReport();
+        report.filename = filename;
+        vector<T> salvaged;
+
+        MappedFile file;
+        if (!file.open(filename, report.error)) {
+            report.layout = "missing";
+            return salvaged;
+        }
+        const char* bytes = file.data();
+        report.fileBytes = file.size();
+
+        vector<Span> spans;
+        auto addSpan = [&](const char* records, uint32_t count, bool trusted) {
+            Span span;
+            span.records = records;
+            span.offset = (uint64_t)(records - bytes);
+            span.count = count;
+            span.trusted = trusted;
+            span.firstSlot = 0;
+            span.kept = 0;
+            span.empty = 0;
+            spans.push_back(span);
+        };
+
+        bool paged = report.fileBytes >= 4 && memcmp(bytes, "QBPF", 4) == 0;
+        if (paged) {
+            PagedFileReport pagedReport;
+            PagedFileHeader header = PagedRecordFile::headerOf<T>(bytes, file.size(), schema, pagedReport);
+            report.layout = pagedReport.headerValid ? "paged"
+                          : "paged, header damaged (" + pagedReport.error + "), standard layout assumed";
+            for (uint32_t i = 0; i < header.pageCount; i++) {
+                PagedRecordFile::PageSpan page = PagedRecordFile::page(bytes, header, i);
+                if (!page.intact) report.badPages.push_back(i);
+                addSpan(page.records, page.count, page.intact);
+            }
+        } else {
+            report.layout = "raw records";
+            uint64_t count = report.fileBytes / sizeof(T);
+            report.trailingBytes = report.fileBytes % sizeof(T);
+            for (uint64_t first = 0; first < count; first += CHUNK_RECORDS) {
+                uint64_t n = count - first < CHUNK_RECORDS ? count - first : (uint64_t)CHUNK_RECORDS;
+                addSpan(bytes + first * sizeof(T), (uint32_t)n, false);
+            }
+        }
+
+        uint64_t slots = 0;
+        for (auto& span : spans) {
+            span.firstSlot = slots;
+            slots += span.count;
+            if (!span.trusted) report.slotsChecked += span.count;
+        }
+
+        WorkStealingPool pool;
+        vector<char> keep(slots, 0);
+        pool.parallelFor(spans.size(), [&](size_t s, int) { validate<T>(spans[s], keep, check); });
+
+        // Where each span's kept records go
+        vector<uint64_t> outputAt(spans.size());
+        uint64_t kept = 0;
+        for (size_t s = 0; s < spans.size(); s++) {
+            const Span& span = spans[s];
+            outputAt[s] = kept;
+            kept += span.kept;
+            if (paged && !span.trusted) report.keptFromDamagedPages += span.kept;
+            report.emptySlots += span.empty;
+            for (const auto& reason : span.rejected) report.rejected[reason.first] += reason.second;
+            for (uint64_t offset : span.rejectedOffsets) {
+                if (report.rejectedOffsets.size() < MAX_LISTED_OFFSETS) report.rejectedOffsets.push_back(offset);
+            }
+        }
+        report.recordsKept = kept;
+
+        salvaged.resize(kept);
+        pool.parallelFor(spans.size(), [&](size_t s, int) {
+            const Span& span = spans[s];
+            char* out = reinterpret_cast<char*>(salvaged.data()) + outputAt[s] * sizeof(T);
+            for (uint32_t i = 0; i < span.count; i++) {
+                if (!keep[span.firstSlot + i]) continue;
+                memcpy(out, span.records + (size_t)i * sizeof(T), sizeof(T));
+                out += sizeof(T);
+            }
+        });
+
+        report.millis = chrono::duration<double, milli>(chrono::steady_clock::now() - started).count();
+        return salvaged;
+    }
+};
+
+#endif // RECORD_SALVAGE_H
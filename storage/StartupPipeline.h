@@ -0,0 +1,240 @@
+#pragma once
+#ifndef STARTUP_PIPELINE_H
+#define STARTUP_PIPELINE_H
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <functional>
+#include <atomic>
+#include <memory>
+#include <exception>
+#include <chrono>
+#include "../Logger.h"
+
+#ifdef _WIN32
+    #include <windows.h>
+#else
+    #include <thread>
+    #include <mutex>
+#endif
+
+using namespace std;
+
+// Runs the steps of loading the server's data, each on its own thread. A
+// step starts the moment the last step it depends on finishes, so reading
+// one file never waits for another to be decoded, and work that needs two
+// inputs (associating menu items with restaurants) starts as soon as both
+// are in memory.
+//
+// Steps may only touch state that their dependencies have finished with;
+// two steps without a dependency between them run at the same time.
+//
+//   StartupPipeline pipeline;
+//   int users = pipeline.add("read users", [&] { ... });
+//   int menus = pipeline.add("read menus", [&] { ... });
+//   pipeline.add("link menus", [&] { ... }, {users, menus});
+//   pipeline.run();
+class StartupPipeline {
+private:
+    struct Step {
+        string name;
+        function<void()> work;
+        vector<int> dependents;
+        int dependencyCount;
+        atomic<int> waitingOn;
+        double millis;
+        bool failed;
+
+        Step() : dependencyCount(0), waitingOn(0), millis(0), failed(false) {}
+    };
+
+    vector<unique_ptr<Step>> steps;
+    bool parallel;
+    double wallMillis;
+
+#ifdef _WIN32
+    CRITICAL_SECTION threadsLock;
+    vector<HANDLE> threads;
+
+    struct Launch {
+        StartupPipeline* pipeline;
+        int step;
+    };
+
+    static DWORD WINAPI stepThreadStatic(LPVOID lpParam) {
+        Launch* launch = (Launch*)lpParam;
+        StartupPipeline* pipeline = launch->pipeline;
+        int step = launch->step;
+        delete launch;
+        pipeline->runFrom(step);
+        return 0;
+    }
+#else
+    mutex threadsLock;
+    deque<thread> threads;              // grows while being joined
+#endif
+
+    void launch(int step) {
+#ifdef _WIN32
+        Launch* args = new Launch{this, step};
+        HANDLE h = CreateThread(NULL, 0, stepThreadStatic, args, 0, NULL);
+        if (!h) {
+            delete args;
+            runFrom(step);
+            return;
+        }
+        EnterCriticalSection(&threadsLock);
+        threads.push_back(h);
+        LeaveCriticalSection(&threadsLock);
+#else
+        lock_guard<mutex> lock(threadsLock);
+        threads.emplace_back(&StartupPipeline::runFrom, this, step);
+#endif
+    }
+
+    static void runStep(Step& step) {
+        auto started = chrono::steady_clock::now();
+        try {
+            step.work();
+        } catch (const exception& e) {
+            step.failed = true;
+            LOG_ERROR("Startup step '" << step.name << "' failed: " << e.what());
+        }
+        step.millis = chrono::duration<double, milli>(chrono::steady_clock::now() - started).count();
+    }
+
+    // Runs step, then carries on with the first dependent it released on
+    // this same thread; any others it released get threads of their own
+    void runFrom(int step) {
+        while (step >= 0) {
+            Step& current = *steps[step];
+            runStep(current);
+
+            int next = -1;
+            for (int dependent : current.dependents) {
+                if (steps[dependent]->waitingOn.fetch_sub(1, memory_order_acq_rel) != 1) continue;
+                if (next < 0) next = dependent;
+                else launch(dependent);
+            }
+            step = next;
+        }
+    }
+
+    // Threads are only started by running steps, before they finish, so
+    // once the list stops growing every step has been run
+    void joinAll() {
+        for (size_t i = 0;; i++) {
+#ifdef _WIN32
+            EnterCriticalSection(&threadsLock);
+            bool more = i < threads.size();
+            HANDLE h = more ? threads[i] : NULL;
+            LeaveCriticalSection(&threadsLock);
+            if (!more) break;
+            WaitForSingleObject(h, INFINITE);
+            CloseHandle(h);
+#else
+            thread* t = nullptr;
+            {
+                lock_guard<mutex> lock(threadsLock);
+                if (i >= threads.size()) break;
+                t = &threads[i];
+            }
+            t->join();
+#endif
+        }
+        threads.clear();
+    }
+
+public:
+    StartupPipeline(bool runParallel = true) : parallel(runParallel), wallMillis(0) {
+#ifdef _WIN32
+        InitializeCriticalSection(&threadsLock);
+#endif
+    }
+
+    ~StartupPipeline() {
+#ifdef _WIN32
+        DeleteCriticalSection(&threadsLock);
+#endif
+    }
+
+    // Returns the step's id for use as a dependency of later steps;
+    // dependencies must have been added before
+    int add(const string& name, const function<void()>& work, const vector<int>& after = vector<int>()) {
+        int id = (int)steps.size();
+        steps.push_back(unique_ptr<Step>(new Step()));
+        Step& step = *steps.back();
+        step.name = name;
+        step.work = work;
+        for (int dependency : after) {
+            if (dependency < 0 || dependency >= id) continue;
+            steps[dependency]->dependents.push_back(id);
+            step.dependencyCount++;
+        }
+        return id;
+    }
+
+    // Runs every step and returns once all have finished. Constructed
+    // with runParallel false, the steps run one after another on the
+    // caller's thread instead (to measure what the threads save).
+    void run() {
+        auto started = chrono::steady_clock::now();
+        for (auto& step : steps) {
+            step->waitingOn.store(step->dependencyCount);
+            step->millis = 0;
+            step->failed = false;
+        }
+        
+        // Dependencies are always added first, so the order of add() is
+        // an order the steps can run in one after another
+        if (!parallel) {
+            for (size_t i = 0; i < steps.size(); i++) runStep(*steps[i]);
+            wallMillis = chrono::duration<double, milli>(chrono::steady_clock::now() - started).count();
+            return;
+        }
+
+        // Steps with no dependencies each get a thread, except the last,
+        // which runs on the caller's
+        int onCaller = -1;
+        for (size_t i = 0; i < steps.size(); i++) {
+            if (steps[i]->dependencyCount != 0) continue;
+            if (onCaller >= 0) launch(onCaller);
+            onCaller = (int)i;
+        }
+        if (onCaller >= 0) runFrom(onCaller);
+        joinAll();
+
+        wallMillis = chrono::duration<double, milli>(chrono::steady_clock::now() - started).count();
+    }
+
+    bool failed() const {
+        for (const auto& step : steps) {
+            if (step->failed) return true;
+        }
+        return false;
+    }
+
+    double getWallMillis() const { return wallMillis; }
+
+    // Sum of the steps' own times, what loading them one after another
+    // would have taken
+    double getSerialMillis() const {
+        double total = 0;
+        for (const auto& step : steps) total += step->millis;
+        return total;
+    }
+
+    void logTimings() const {
+        if (Logger::instance().enabled(LOG_LEVEL_DEBUG)) {
+            for (const auto& step : steps) {
+                LOG_DEBUG("  " << step->name << ": " << step->millis << " ms"
+                         << (step->failed ? " (failed)" : ""));
+            }
+        }
+        LOG_INFO("Startup loading took " << wallMillis << " ms ("
+                 << getSerialMillis() << " ms of work)");
+    }
+};
+
+#endif // STARTUP_PIPELINE_H
@@ -18,7 +18,7 @@
 #include "../dataStructures/BTree.h"
 #include "../dataStructures/HashTable.h"
 #include "../dataStructures/Graph.h"
-#include "../dataStructures/PriorityQueue.h"
+#include "../dataStructures/IndexedPriorityQueue.h"
 #include "../dataStructures/Queue.h"
 #include "../dataStructures/LinkedList.h"
                 
@@ -26,6 +26,7 @@
 #include "../services/OrderService.h"
 #include "../services/RiderService.h"
 #include "../services/RoutingService.h"
+#include "../services/DispatchEngine.h"
 #include "../services/RestaurantService.h"
 
 #include "../Database.h"
@@ -48,7 +49,9 @@ private:
     Queue<Order> readyOrders;
     
     // For rider assignment
-    PriorityQueue<Rider*> availableRiders;
+    IndexedPriorityQueue<Rider*> availableRiders;
+    DispatchEngine dispatchEngine;
+    bool batchDispatch;     // "dispatched" orders wait for runDispatchCycle()
 
     // ----- Service Managers -----
     UserService* userService;
@@ -57,6 +60,8 @@ private:
     RestaurantService* restaurantService;
     RoutingService* routingService;
     
+    const string SPEED_PROFILES_FILE = "speed_profiles.txt";
+    
     Database* database;
     
     int nextOrderId;
@@ -95,6 +100,8 @@ public:
             [](const Restaurant& a, const Restaurant& b) { return a.getRestaurantId() < b.getRestaurantId(); },
             [](const Restaurant& a, const Restaurant& b) { return a.getRestaurantId() == b.getRestaurantId(); }),
           cityGraph(new Graph(100)),
+          dispatchEngine(cityGraph),
+          batchDispatch(false),
           database(new Database()),
           nextOrderId(1000),
           nextUserId(100),
@@ -104,10 +111,11 @@ public:
     {
         // Initialize services
         userService = new UserService(&users);
-        riderService = new RiderService(&riders, &availableRiders);
+        riderService = new RiderService(&riders, &availableRiders, cityGraph);
         orderService = new OrderService(&orders, &pendingOrders, &preparingOrders, &readyOrders);
         restaurantService = new RestaurantService(&restaurants);
         routingService = new RoutingService(cityGraph);
+        routingService->loadSpeedProfiles(SPEED_PROFILES_FILE);
         
         // Load existing data from database
         loadFromDatabase();
@@ -149,6 +157,7 @@ public:
         vector<MenuItem> dbMenuItems = database->loadAllMenuItems();
         for (const auto& item : dbMenuItems) {
             menuItemsCache.insertItem(item.id, item);
+            restaurantService->loadMenuItem(item);
             if (item.id >= nextMenuItemId) {
                 nextMenuItemId = item.id + 1;
             }
@@ -555,7 +564,11 @@ database->saveRider(rider3);
                 cout << "Order #" << orderId << " is ready for pickup.\n";
             }
         } else if (status == "dispatched") {
-            assignRiderToOrder(order);
+            if (batchDispatch) {
+                dispatchEngine.submit(DispatchRequest(order->id, pickupLocationFor(order)));
+            } else {
+                assignRiderToOrder(order);
+            }
         } else if (status == "delivered") {
             if (order->riderId != -1) {
                 Rider* rider = riderService->getRider(order->riderId);
@@ -649,7 +662,7 @@ database->saveRider(rider3);
         bool success = riderService->updateRiderLocation(riderId, location);
         if (success) {
             Rider* rider = getRider(riderId);
-            if (rider && rider->status == "available") {
+            if (rider && strcmp(rider->status, "available") == 0) {
                 availableRiders.updatePriority(rider, calculateRiderPriority(rider));
             }
         }
@@ -664,8 +677,8 @@ database->saveRider(rider3);
         return riderService->getAvailableRiders();
     }
     
-    Rider* findBestRiderForOrder(int pickupLocation, int deliveryLocation) {
-        return riderService->findBestRider(pickupLocation, deliveryLocation);
+    Rider* findBestRiderForOrder(int pickupLocation) {
+        return riderService->findBestRider(pickupLocation);
     }
 
     // ----- Route Planning -----
@@ -688,6 +701,11 @@ database->saveRider(rider3);
         return routingService->estimateDeliveryTime(distance, vehicleType);
     }
     
+    // Minutes to drive an already planned route at current traffic
+    int estimateRouteTime(const vector<int>& route, const string& vehicleType) {
+        return routingService->estimateTravelTime(route, vehicleType);
+    }
+    
     void addCityLocation(int nodeId) {
         routingService->addLocation(nodeId);
     }
@@ -697,14 +715,105 @@ database->saveRider(rider3);
     }
     
     // ----- System Operations -----
+    // ----- Batch Dispatch -----
+    // Collect "dispatched" orders and assign them together with a min-cost
+    // matching instead of one greedy pick per order
+    void enableBatchDispatch(int windowMillis = 2000) {
+        dispatchEngine.setWindowMillis(windowMillis);
+        batchDispatch = true;
+    }
+    
+    void disableBatchDispatch() {
+        batchDispatch = false;
+        for (const auto& request : dispatchEngine.takePending()) {
+            Order* order = getOrder(request.orderId);
+            if (order && order->riderId == -1) assignRiderToOrder(order);
+        }
+    }
+    
+    bool isDispatchDue() const {
+        return dispatchEngine.windowElapsed();
+    }
+    
+    // Assigns every queued order it can against the currently available
+    // riders; the rest wait for the next cycle. Returns orders assigned.
+    int runDispatchCycle() {
+        vector<DispatchRequest> batch;
+        for (const auto& request : dispatchEngine.takePending()) {
+            Order* order = getOrder(request.orderId);
+            if (order && order->riderId == -1) batch.push_back(request);
+        }
+        if (batch.empty()) return 0;
+        
+        vector<DispatchCandidate> candidates;
+        LinkedList<Rider> available = riderService->getAvailableRiders();
+        for (auto* node = available.getHead(); node != nullptr; node = node->next) {
+            candidates.push_back(DispatchCandidate(node->data.id, node->data.location));
+        }
+        
+        vector<DispatchRequest> unassigned;
+        vector<DispatchAssignment> plan = dispatchEngine.solve(batch, candidates, &unassigned);
+        
+        for (const auto& a : plan) {
+            Order* order = getOrder(a.orderId);
+            Rider* rider = riderService->getRider(a.riderId);
+            if (!order || !rider) continue;
+            
+            order->assignRider(rider->id);
+            riderService->updateRiderStatus(rider->id, "busy");
+            availableRiders.remove(rider);
+            
+            cout << "Rider " << rider->name << " (ID: " << rider->id 
+                 << ") assigned to Order #" << order->id;
+            if (a.pickupDistance >= 0) cout << " (" << a.pickupDistance << "m to pickup)";
+            cout << ".\n";
+        }
+        
+        dispatchEngine.requeue(unassigned);
+        if (!unassigned.empty()) {
+            cout << unassigned.size() << " order(s) waiting for a free rider.\n";
+        }
+        return plan.size();
+    }
+    
 private:
+    // Of the few riders closest by road, the one that reaches pickupLocation
+    // first at current traffic and vehicle speed
+    Rider* findFastestRider(int pickupLocation) {
+        Rider* best = nullptr;
+        int bestArrival = INT_MAX;
+        
+        for (const auto& candidate : riderService->findNearestRiders(pickupLocation, TravelTimeModel::ETA_CANDIDATES)) {
+            Rider* rider = candidate.first;
+            int arrival = INT_MAX;
+            vector<int> path = routingService->getFastestPath(rider->location, pickupLocation,
+                                                              rider->vehicle, -1, &arrival);
+            if (!path.empty() && arrival < bestArrival) {
+                bestArrival = arrival;
+                best = rider;
+            }
+        }
+        return best;
+    }
+    
+    int pickupLocationFor(Order* order) {
+        Restaurant* restaurant = getRestaurant(order->restaurantId);
+        if (restaurant) {
+            return restaurant->getLocationNode();
+        }
+        return order->deliveryLocation;
+    }
+    
     void assignRiderToOrder(Order* order) {
         if (!order) return;
         
-        Rider* bestRider = riderService->findBestRider(
-            order->deliveryLocation, 
-            order->deliveryLocation
-        );
+        // Riders are matched on when they can reach the restaurant, not the customer
+        int pickupLocation = pickupLocationFor(order);
+        
+        Rider* bestRider = findFastestRider(pickupLocation);
+        if (!bestRider) {
+            bestRider = riderService->findBestRider(pickupLocation);
+        }
         
         if (bestRider) {
             order->assignRider(bestRider->id);
@@ -712,18 +821,20 @@ private:
             
             availableRiders.remove(bestRider);
             
-            vector<int> route = getDeliveryRoute(
-                bestRider->location,
-                order->deliveryLocation
-            );
+            // Rider -> restaurant -> customer
+            vector<int> route = getDeliveryRoute(bestRider->location, pickupLocation);
+            vector<int> toCustomer = getDeliveryRoute(pickupLocation, order->deliveryLocation);
+            if (!route.empty() && toCustomer.size() > 1) {
+                route.insert(route.end(), toCustomer.begin() + 1, toCustomer.end());
+            }
 
             if (!route.empty()) {
-                int distance = getDeliveryDistance(
-                    bestRider->location,
-                    order->deliveryLocation
-                );
-                
-                int estimatedTime = estimateDeliveryTime(distance, bestRider->vehicle);
+                int estimatedTime = estimateRouteTime(route, bestRider->vehicle);
+                if (estimatedTime < 0) {
+                    int distance = max(0, getDeliveryDistance(bestRider->location, pickupLocation)) +
+                                   max(0, getDeliveryDistance(pickupLocation, order->deliveryLocation));
+                    estimatedTime = estimateDeliveryTime(distance, bestRider->vehicle);
+                }
                 cout << "Rider " << bestRider->name << " (ID: " << bestRider->id 
                      << ") assigned to Order #" << order->id 
                      << ". Estimated delivery time: " << estimatedTime << " minutes.\n";
@@ -797,7 +908,7 @@ public:
         Restaurant* r = getRestaurant(restaurantId);
         if (r) {
             cout << "=== Menu for " << r->getName() << " ===\n";
-            r->printMenu();
+            restaurantService->printRestaurantMenu(restaurantId);
         } else {
             cout << "Restaurant not found.\n";
         }
@@ -859,7 +970,7 @@ public:
     
     void printAvailableRidersQueue() {
         cout << "=== Available Riders Queue (" << availableRiders.size() << ") ===\n";
-        PriorityQueue<Rider*> tempQueue = availableRiders;
+        IndexedPriorityQueue<Rider*> tempQueue = availableRiders;
         int count = 1;
         while (!tempQueue.isEmpty()) {
             Rider* rider = tempQueue.dequeue();
@@ -937,7 +1048,7 @@ public:
         while (!preparingOrders.isEmpty()) preparingOrders.dequeue();
         while (!readyOrders.isEmpty()) readyOrders.dequeue();
         
-        while (!availableRiders.isEmpty()) availableRiders.dequeue();
+        availableRiders.clear();
         
         cout << "System data cleared (except persistent storage).\n";
     }